@@ -0,0 +1,425 @@
+#if !defined (BGL_OMP_HPP_)
+#define BGL_OMP_HPP_
+
+#include <stdint.h>
+#include <math.h>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include "boost/graph/graph_traits.hpp"
+#include "boost/graph/properties.hpp"
+#include "boost/type_traits/is_convertible.hpp"
+
+/*
+ * OpenMP graph kernels written against the Boost Graph Library concepts.
+ *
+ * Any graph that models VertexListGraph and IncidenceGraph and has a
+ * vertex_index property map works, as long as vertices(g) lists the vertices
+ * in index order (adjacency_list with vecS vertices and
+ * compressed_sparse_row_graph both do).  Work is split over contiguous
+ * ranges of vertex indices; when the vertex iterator is random access the
+ * k-th vertex is reached directly, otherwise the descriptors are gathered
+ * once up front.
+ *
+ * The graph must be symmetric: every edge is visible from both endpoints
+ * through out_edges, as with an undirectedS graph or a directed graph built
+ * from a symmetric edge list.  Pull kernels read a vertex's out-edges as its
+ * in-edges.
+ *
+ * Per-vertex results go to plain arrays indexed by vertex index.  Without
+ * -fopenmp the kernels run serially with the same results.
+ */
+
+namespace bgl_omp {
+
+/* The k-th vertex of g in index order. */
+template <class Graph,
+	  bool RandomAccess = boost::is_convertible<
+	    typename std::iterator_traits<
+	      typename boost::graph_traits<Graph>::vertex_iterator>::iterator_category,
+	    std::random_access_iterator_tag>::value>
+class vertex_range {
+  public:
+    typedef typename boost::graph_traits<Graph>::vertex_descriptor vertex_descriptor;
+    typedef typename boost::graph_traits<Graph>::vertex_iterator vertex_iterator;
+
+    explicit vertex_range(const Graph & g) {
+      vertex_iterator it, end;
+      boost::tie(it, end) = vertices(g);
+      verts.assign(it, end);
+    }
+
+    int64_t size() const { return verts.size(); }
+    vertex_descriptor operator[](int64_t k) const { return verts[k]; }
+
+  private:
+    std::vector<vertex_descriptor> verts;
+};
+
+template <class Graph>
+class vertex_range<Graph, true> {
+  public:
+    typedef typename boost::graph_traits<Graph>::vertex_descriptor vertex_descriptor;
+    typedef typename boost::graph_traits<Graph>::vertex_iterator vertex_iterator;
+
+    explicit vertex_range(const Graph & g) {
+      vertex_iterator end;
+      boost::tie(first, end) = vertices(g);
+      n = end - first;
+    }
+
+    int64_t size() const { return n; }
+    vertex_descriptor operator[](int64_t k) const { return first[k]; }
+
+  private:
+    vertex_iterator first;
+    int64_t n;
+};
+
+/* Lower *p to x if x is smaller; true if this call lowered it. */
+inline bool
+write_min(int64_t * p, int64_t x) {
+  int64_t old = *p;
+  while(x < old) {
+    if(__sync_bool_compare_and_swap(p, old, x))
+      return true;
+    old = *p;
+  }
+  return false;
+}
+
+/* Point every vertex straight at its component root. */
+inline void
+compress(int64_t * comp, int64_t nv) {
+  #pragma omp parallel for schedule(dynamic, 16384)
+  for(int64_t k = 0; k < nv; k++) {
+    while(comp[k] != comp[comp[k]])
+      comp[k] = comp[comp[k]];
+  }
+}
+
+inline int64_t
+count_roots(const int64_t * comp, int64_t nv) {
+  int64_t roots = 0;
+  #pragma omp parallel for reduction(+:roots)
+  for(int64_t k = 0; k < nv; k++)
+    roots += comp[k] == k;
+  return roots;
+}
+
+/**
+* @brief Shiloach-Vishkin connected components.
+*
+* Alternates hooking, where each edge between two trees hangs the root with
+* the larger label under the smaller label, with shortcutting, until no edge
+* joins two trees.
+*
+* @param g The graph
+* @param comp Output: comp[i] is the smallest vertex index in i's component
+*
+* @return Number of components
+*/
+template <class Graph>
+int64_t
+shiloach_vishkin(const Graph & g, int64_t * comp) {
+  typedef typename boost::graph_traits<Graph>::out_edge_iterator out_edge_iterator;
+  typename boost::property_map<Graph, boost::vertex_index_t>::const_type index = get(boost::vertex_index, g);
+  const vertex_range<Graph> verts(g);
+  const int64_t nv = verts.size();
+
+  #pragma omp parallel for
+  for(int64_t k = 0; k < nv; k++)
+    comp[k] = k;
+
+  while(1) {
+    int64_t changed = 0;
+
+    #pragma omp parallel for reduction(+:changed) schedule(dynamic, 1024)
+    for(int64_t k = 0; k < nv; k++) {
+      out_edge_iterator edgesIt, edgesEnd;
+      for(boost::tie(edgesIt, edgesEnd) = out_edges(verts[k], g); edgesIt != edgesEnd; ++edgesIt) {
+	const int64_t ck = comp[k];
+	const int64_t cu = comp[get(index, target(*edgesIt, g))];
+	if(cu < ck && comp[ck] == ck)
+	  changed += write_min(&comp[ck], cu);
+      }
+    }
+
+    if(!changed)
+      break;
+
+    compress(comp, nv);
+  }
+
+  return count_roots(comp, nv);
+}
+
+/* Join the trees of u and v, hanging the larger root under the smaller. */
+inline void
+afforest_link(int64_t u, int64_t v, int64_t * comp) {
+  int64_t p1 = comp[u];
+  int64_t p2 = comp[v];
+  while(p1 != p2) {
+    const int64_t high = p1 > p2 ? p1 : p2;
+    const int64_t low = p1 + p2 - high;
+    const int64_t p_high = comp[high];
+    if(p_high == low ||
+       (p_high == high && __sync_bool_compare_and_swap(&comp[high], high, low)))
+      break;
+    p1 = comp[comp[high]];
+    p2 = comp[low];
+  }
+}
+
+/**
+* @brief Afforest connected components.
+*
+* Links each vertex to its first neighbor_rounds neighbors, guesses the
+* largest component from a fixed sample of labels, then links the remaining
+* edges of only the vertices outside it.  On graphs with a giant component
+* this skips most edges.
+*
+* @param g The graph
+* @param comp Output: comp[i] is the smallest vertex index in i's component
+* @param neighbor_rounds Neighbors linked per vertex before sampling
+*
+* @return Number of components
+*/
+template <class Graph>
+int64_t
+afforest(const Graph & g, int64_t * comp, int64_t neighbor_rounds = 2) {
+  typedef typename boost::graph_traits<Graph>::out_edge_iterator out_edge_iterator;
+  typename boost::property_map<Graph, boost::vertex_index_t>::const_type index = get(boost::vertex_index, g);
+  const vertex_range<Graph> verts(g);
+  const int64_t nv = verts.size();
+  const int64_t nsamples = 1024;
+
+  if(!nv)
+    return 0;
+
+  #pragma omp parallel for
+  for(int64_t k = 0; k < nv; k++)
+    comp[k] = k;
+
+  for(int64_t r = 0; r < neighbor_rounds; r++) {
+    #pragma omp parallel for schedule(dynamic, 16384)
+    for(int64_t k = 0; k < nv; k++) {
+      out_edge_iterator edgesIt, edgesEnd;
+      boost::tie(edgesIt, edgesEnd) = out_edges(verts[k], g);
+      for(int64_t i = 0; i < r && edgesIt != edgesEnd; i++)
+	++edgesIt;
+      if(edgesIt != edgesEnd)
+	afforest_link(k, get(index, target(*edgesIt, g)), comp);
+    }
+    compress(comp, nv);
+  }
+
+  /* most frequent label in a fixed pseudo-random sample */
+  std::vector<int64_t> sample(nsamples);
+  uint64_t state = 0x5EEDAFF0ULL;
+  for(int64_t s = 0; s < nsamples; s++) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    sample[s] = comp[(state >> 17) % nv];
+  }
+  std::sort(sample.begin(), sample.end());
+  int64_t giant = sample[0], best = 0;
+  for(int64_t s = 0, run = 0; s < nsamples; s++) {
+    run = (s && sample[s] == sample[s-1]) ? run + 1 : 1;
+    if(run > best) {
+      best = run;
+      giant = sample[s];
+    }
+  }
+
+  #pragma omp parallel for schedule(dynamic, 16384)
+  for(int64_t k = 0; k < nv; k++) {
+    if(comp[k] == giant)
+      continue;
+    out_edge_iterator edgesIt, edgesEnd;
+    boost::tie(edgesIt, edgesEnd) = out_edges(verts[k], g);
+    for(int64_t i = 0; i < neighbor_rounds && edgesIt != edgesEnd; i++)
+      ++edgesIt;
+    for(; edgesIt != edgesEnd; ++edgesIt)
+      afforest_link(k, get(index, target(*edgesIt, g)), comp);
+  }
+  compress(comp, nv);
+
+  return count_roots(comp, nv);
+}
+
+/**
+* @brief Pull PageRank.
+*
+* Each iteration every vertex sums pr/out_degree over its neighbors, so no
+* two threads write the same rank.  Stops when the L1 change falls to
+* epsilon or after maxiter iterations.
+*
+* @param g The graph
+* @param pr Output: the ranks
+*
+* @return Number of iterations run
+*/
+template <class Graph>
+int64_t
+pagerank(const Graph & g, double * pr, double dampingfactor = 0.85,
+	 double epsilon = 1e-8, int64_t maxiter = 100) {
+  typedef typename boost::graph_traits<Graph>::out_edge_iterator out_edge_iterator;
+  typename boost::property_map<Graph, boost::vertex_index_t>::const_type index = get(boost::vertex_index, g);
+  const vertex_range<Graph> verts(g);
+  const int64_t nv = verts.size();
+  std::vector<double> contrib(nv);
+
+  #pragma omp parallel for
+  for(int64_t k = 0; k < nv; k++)
+    pr[k] = 1 / ((double)nv);
+
+  int64_t iter = 0;
+  double delta = 1;
+
+  while(delta > epsilon && iter < maxiter) {
+    #pragma omp parallel for
+    for(int64_t k = 0; k < nv; k++) {
+      const int64_t deg = out_degree(verts[k], g);
+      contrib[k] = deg ? pr[k] / deg : 0;
+    }
+
+    delta = 0;
+    #pragma omp parallel for reduction(+:delta) schedule(dynamic, 1024)
+    for(int64_t k = 0; k < nv; k++) {
+      double sum = 0;
+      out_edge_iterator edgesIt, edgesEnd;
+      for(boost::tie(edgesIt, edgesEnd) = out_edges(verts[k], g); edgesIt != edgesEnd; ++edgesIt)
+	sum += contrib[get(index, target(*edgesIt, g))];
+
+      const double next = sum * dampingfactor + (1 - dampingfactor) / ((double)nv);
+      delta += fabs(next - pr[k]);
+      pr[k] = next;
+    }
+
+    iter++;
+  }
+
+  return iter;
+}
+
+/**
+* @brief Direction-optimizing breadth-first search.
+*
+* Expands the frontier top-down while it is small and switches to bottom-up
+* steps, where each unreached vertex looks for a parent in the frontier,
+* once the frontier's edges exceed 1/alpha of the unexplored edges.  It
+* switches back when the frontier shrinks below nv/beta vertices.
+*
+* @param g The graph
+* @param root Index of the search key
+* @param parent Output: BFS tree parents, parent[root] is root, -1 where
+* unreached
+*
+* @return Number of vertices reached
+*/
+template <class Graph>
+int64_t
+bfs(const Graph & g, int64_t root, int64_t * parent,
+    int64_t alpha = 15, int64_t beta = 18) {
+  typedef typename boost::graph_traits<Graph>::out_edge_iterator out_edge_iterator;
+  typename boost::property_map<Graph, boost::vertex_index_t>::const_type index = get(boost::vertex_index, g);
+  const vertex_range<Graph> verts(g);
+  const int64_t nv = verts.size();
+
+  std::vector<int64_t> frontier(nv), next(nv);
+  std::vector<char> in_frontier(nv), in_next(nv);
+  int64_t nfrontier = 1, reached = 1;
+  int64_t edges_to_check = 0;
+
+  #pragma omp parallel for reduction(+:edges_to_check)
+  for(int64_t k = 0; k < nv; k++) {
+    parent[k] = -1;
+    edges_to_check += out_degree(verts[k], g);
+  }
+
+  parent[root] = root;
+  frontier[0] = root;
+  int64_t scout = out_degree(verts[root], g);
+
+  while(nfrontier) {
+    if(scout > edges_to_check / alpha) {
+      #pragma omp parallel for
+      for(int64_t k = 0; k < nv; k++)
+	in_frontier[k] = 0;
+      #pragma omp parallel for
+      for(int64_t i = 0; i < nfrontier; i++)
+	in_frontier[frontier[i]] = 1;
+
+      int64_t awake = nfrontier, old_awake;
+      do {
+	old_awake = awake;
+	awake = 0;
+
+	#pragma omp parallel for reduction(+:awake) schedule(dynamic, 1024)
+	for(int64_t k = 0; k < nv; k++) {
+	  in_next[k] = 0;
+	  if(parent[k] >= 0)
+	    continue;
+	  out_edge_iterator edgesIt, edgesEnd;
+	  for(boost::tie(edgesIt, edgesEnd) = out_edges(verts[k], g); edgesIt != edgesEnd; ++edgesIt) {
+	    const int64_t u = get(index, target(*edgesIt, g));
+	    if(in_frontier[u]) {
+	      parent[k] = u;
+	      in_next[k] = 1;
+	      awake++;
+	      break;
+	    }
+	  }
+	}
+
+	in_frontier.swap(in_next);
+	reached += awake;
+      } while(awake && (awake >= old_awake || awake > nv / beta));
+
+      nfrontier = 0;
+      #pragma omp parallel for
+      for(int64_t k = 0; k < nv; k++)
+	if(in_frontier[k])
+	  frontier[__sync_fetch_and_add(&nfrontier, 1)] = k;
+      scout = 1;
+    } else {
+      edges_to_check -= scout;
+      scout = 0;
+      int64_t nnext = 0;
+
+      #pragma omp parallel reduction(+:scout)
+      {
+	std::vector<int64_t> local;
+
+	#pragma omp for nowait schedule(dynamic, 64)
+	for(int64_t i = 0; i < nfrontier; i++) {
+	  const int64_t u = frontier[i];
+	  out_edge_iterator edgesIt, edgesEnd;
+	  for(boost::tie(edgesIt, edgesEnd) = out_edges(verts[u], g); edgesIt != edgesEnd; ++edgesIt) {
+	    const int64_t v = get(index, target(*edgesIt, g));
+	    if(parent[v] < 0 && __sync_bool_compare_and_swap(&parent[v], -1, u)) {
+	      local.push_back(v);
+	      scout += out_degree(verts[v], g);
+	    }
+	  }
+	}
+
+	if(!local.empty()) {
+	  const int64_t at = __sync_fetch_and_add(&nnext, (int64_t)local.size());
+	  std::copy(local.begin(), local.end(), next.begin() + at);
+	}
+      }
+
+      frontier.swap(next);
+      nfrontier = nnext;
+      reached += nnext;
+    }
+  }
+
+  return reached;
+}
+
+} /* namespace bgl_omp */
+
+#endif /* BGL_OMP_HPP_ */
@@ -0,0 +1,277 @@
+#define _POSIX_C_SOURCE 200112L
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "graph500.h"
+
+static double
+now (void)
+{
+  struct timespec tp;
+  clock_gettime (CLOCK_MONOTONIC, &tp);
+  return (double) tp.tv_sec + 1.0e-9 * (double) tp.tv_nsec;
+}
+
+static uint64_t
+splitmix64 (uint64_t * state)
+{
+  uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+static int
+cmp_double (const void * a, const void * b)
+{
+  const double x = *(const double *) a, y = *(const double *) b;
+  return (x > y) - (x < y);
+}
+
+/* Midpoint of the order statistics around quantile q of sorted x[0..n). */
+static double
+quantile (const double * x, int64_t n, double q)
+{
+  const double pos = q * (double) (n - 1);
+  return 0.5 * (x[(int64_t) floor (pos)] + x[(int64_t) ceil (pos)]);
+}
+
+/**
+* @brief Draw distinct search keys with at least one edge.
+*
+* @param off CSR offsets of the input graph
+* @param nv Number of vertices
+* @param nroots Number of keys wanted
+* @param seed Seed, so every backend draws the same keys
+* @param roots Output: the keys
+*
+* @return Number of keys drawn, less than nroots only if fewer vertices have
+* edges
+*/
+int64_t
+graph500_roots (const int64_t * off, int64_t nv, int64_t nroots,
+		uint64_t seed, int64_t * roots)
+{
+  int64_t candidates = 0;
+  for (int64_t v = 0; v < nv; v++)
+    candidates += off[v+1] > off[v];
+
+  int64_t n = 0;
+  if (candidates <= nroots) {
+    for (int64_t v = 0; v < nv; v++)
+      if (off[v+1] > off[v])
+	roots[n++] = v;
+    return n;
+  }
+
+  uint64_t state = seed;
+  while (n < nroots) {
+    const int64_t v = (int64_t) (splitmix64 (&state) % (uint64_t) nv);
+    if (off[v+1] == off[v])
+      continue;
+    int64_t k;
+    for (k = 0; k < n && roots[k] != v; k++)
+      ;
+    if (k == n)
+      roots[n++] = v;
+  }
+  return n;
+}
+
+/**
+* @brief Number of undirected input edges a search traversed.
+*/
+int64_t
+graph500_traversed_edges (const int64_t * off, int64_t nv,
+			  const int64_t * parent)
+{
+  int64_t deg = 0;
+  for (int64_t v = 0; v < nv; v++)
+    if (parent[v] >= 0)
+      deg += off[v+1] - off[v];
+  return deg / 2;
+}
+
+/**
+* @brief Check a parent array against the input graph.
+*
+* Follows the Graph500 validation: the parents form a tree rooted at root,
+* every tree edge is an input edge, every input edge joins two reached or two
+* unreached vertices, and the tree levels of its endpoints differ by at most
+* one.
+*
+* @return Number of vertices or edges that break a rule, 0 if valid
+*/
+int64_t
+graph500_validate (const int64_t * off, const int64_t * ind,
+		   int64_t nv, int64_t root, const int64_t * parent)
+{
+  if (root < 0 || root >= nv || parent[root] != root)
+    return 1;
+
+  int64_t errors = 0;
+  int64_t * level = malloc (nv * sizeof (int64_t));
+  char * tree_edge_found = calloc (nv, 1);
+
+  for (int64_t v = 0; v < nv; v++) {
+    if (parent[v] < -1 || parent[v] >= nv)
+      errors++;
+    level[v] = -1;
+  }
+  if (errors) {
+    free (tree_edge_found);
+    free (level);
+    return errors;
+  }
+
+  /* levels by repeated relaxation; parents that never reach the root
+     (cycles) keep level -1 */
+  level[root] = 0;
+  for (int changed = 1; changed; ) {
+    changed = 0;
+    for (int64_t v = 0; v < nv; v++) {
+      const int64_t p = parent[v];
+      if (level[v] < 0 && p >= 0 && level[p] >= 0) {
+	level[v] = level[p] + 1;
+	changed = 1;
+      }
+    }
+  }
+
+  for (int64_t u = 0; u < nv; u++) {
+    for (int64_t k = off[u]; k < off[u+1]; k++) {
+      const int64_t w = ind[k];
+      if (parent[w] == u)
+	tree_edge_found[w] = 1;
+      if ((parent[u] >= 0) != (parent[w] >= 0))
+	errors++;
+      else if (parent[u] >= 0 && labs (level[u] - level[w]) > 1)
+	errors++;
+    }
+  }
+
+  for (int64_t v = 0; v < nv; v++) {
+    if (parent[v] >= 0 && level[v] < 0)
+      errors++;
+    else if (v != root && parent[v] >= 0 && !tree_edge_found[v])
+      errors++;
+  }
+
+  free (tree_edge_found);
+  free (level);
+  return errors;
+}
+
+/**
+* @brief Build a parent array for a backend that only reports BFS depths.
+*
+* Picks, for each reached vertex, an input neighbor one level closer to the
+* root.  depth[v] is -1 for unreached vertices.
+*/
+void
+graph500_parents_from_depth (const int64_t * off, const int64_t * ind,
+			     int64_t nv, int64_t root,
+			     const int64_t * depth, int64_t * parent)
+{
+  for (int64_t v = 0; v < nv; v++) {
+    parent[v] = -1;
+    if (v == root) {
+      parent[v] = root;
+    } else if (depth[v] > 0) {
+      for (int64_t k = off[v]; k < off[v+1]; k++)
+	if (depth[ind[k]] == depth[v] - 1) {
+	  parent[v] = ind[k];
+	  break;
+	}
+    }
+  }
+}
+
+/**
+* @brief Time one search from each of GRAPH500_NROOTS keys.
+*
+* @param off CSR offsets of the input graph
+* @param ind CSR adjacencies of the input graph
+* @param nv Number of vertices
+* @param bfs Runs one search on the backend
+* @param ctx Passed through to bfs
+* @param result Output
+*/
+void
+graph500_run (const int64_t * off, const int64_t * ind, int64_t nv,
+	      graph500_bfs_fn bfs, void * ctx,
+	      graph500_result_t * result)
+{
+  int64_t roots[GRAPH500_NROOTS];
+  double teps[GRAPH500_NROOTS];
+  int64_t * parent = malloc (nv * sizeof (int64_t));
+  double total_time = 0;
+
+  memset (result, 0, sizeof (*result));
+  const int64_t n = graph500_roots (off, nv, GRAPH500_NROOTS, GRAPH500_SEED, roots);
+
+  for (int64_t r = 0; r < n; r++) {
+    const double t0 = now ();
+    bfs (ctx, roots[r], parent);
+    const double t = now () - t0;
+
+    total_time += t;
+    teps[r] = graph500_traversed_edges (off, nv, parent) / t;
+    if (graph500_validate (off, ind, nv, roots[r], parent)) {
+      fprintf (stderr, "%s %d: BFS from %ld gave an invalid parent array\n",
+	       __func__, __LINE__, (long) roots[r]);
+      result->invalid++;
+    }
+  }
+  free (parent);
+
+  result->nroots = n;
+  if (!n)
+    return;
+  result->time_mean = total_time / n;
+
+  qsort (teps, n, sizeof (double), cmp_double);
+  result->teps_min = teps[0];
+  result->teps_firstquartile = quantile (teps, n, 0.25);
+  result->teps_median = quantile (teps, n, 0.5);
+  result->teps_thirdquartile = quantile (teps, n, 0.75);
+  result->teps_max = teps[n-1];
+
+  /* harmonic mean, and its standard deviation as in the Graph500
+     reference code */
+  double inv = 0;
+  for (int64_t r = 0; r < n; r++)
+    inv += 1.0 / teps[r];
+  const double hmean = n / inv;
+  double dev = 0;
+  for (int64_t r = 0; r < n; r++)
+    dev += (1.0 / teps[r] - 1.0 / hmean) * (1.0 / teps[r] - 1.0 / hmean);
+  result->teps_harmonic_mean = hmean;
+  result->teps_harmonic_stddev = n > 1 ? sqrt (dev) / (n - 1) * hmean * hmean : 0;
+}
+
+/**
+* @brief Print a BFS result as a "bfs" entry of the RSLT: JSON.
+*
+* "time" holds the harmonic mean TEPS.
+*/
+void
+graph500_report (const char * name, const graph500_result_t * r)
+{
+  printf ("RSLT: \"bfs\": {\n");
+  printf ("RSLT: \"name\":\"%s\",\n", name);
+  printf ("RSLT: \"time\":%le,\n", r->teps_harmonic_mean);
+  printf ("RSLT: \"roots\":%ld,\n", (long) r->nroots);
+  printf ("RSLT: \"invalid\":%ld,\n", (long) r->invalid);
+  printf ("RSLT: \"time_mean\":%le,\n", r->time_mean);
+  printf ("RSLT: \"teps_min\":%le,\n", r->teps_min);
+  printf ("RSLT: \"teps_firstquartile\":%le,\n", r->teps_firstquartile);
+  printf ("RSLT: \"teps_median\":%le,\n", r->teps_median);
+  printf ("RSLT: \"teps_thirdquartile\":%le,\n", r->teps_thirdquartile);
+  printf ("RSLT: \"teps_max\":%le,\n", r->teps_max);
+  printf ("RSLT: \"teps_harmonic_mean\":%le,\n", r->teps_harmonic_mean);
+  printf ("RSLT: \"teps_harmonic_stddev\":%le\n", r->teps_harmonic_stddev);
+  printf ("RSLT: },\n");
+}
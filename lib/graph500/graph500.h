@@ -0,0 +1,50 @@
+#if !defined (GRAPH500_H_)
+#define GRAPH500_H_
+
+#include <stdint.h>
+
+/*
+ * Graph500-style BFS benchmark.
+ *
+ * GRAPH500_NROOTS search keys are drawn with a fixed seed from the vertices
+ * with at least one edge in the input CSR, so every backend searches from
+ * the same roots.  Each search must produce a parent array: parent[root] is
+ * root, parent[v] is v's predecessor in the BFS tree, and unreached vertices
+ * hold -1.  Every parent array is validated against the input graph outside
+ * the timed region.
+ *
+ * A search traverses the input edges with an endpoint it reached, counting
+ * each undirected edge once as the Graph500 does.  Rates are reported as
+ * traversed edges per second (TEPS) with the harmonic mean and quartiles
+ * over all roots.
+ */
+
+#define GRAPH500_NROOTS 64
+#define GRAPH500_SEED 0x5EED500ULL
+
+typedef struct graph500_result {
+  int64_t nroots;
+  int64_t invalid;	/* searches whose parent array failed validation */
+  double  time_mean;	/* seconds per search */
+  double  teps_min, teps_firstquartile, teps_median, teps_thirdquartile, teps_max;
+  double  teps_harmonic_mean, teps_harmonic_stddev;
+} graph500_result_t;
+
+/* Search from root and fill parent[0..nv) as described above. */
+typedef void (*graph500_bfs_fn) (void * ctx, int64_t root, int64_t * parent);
+
+int64_t graph500_roots (const int64_t * off, int64_t nv, int64_t nroots,
+			uint64_t seed, int64_t * roots);
+int64_t graph500_traversed_edges (const int64_t * off, int64_t nv,
+				  const int64_t * parent);
+int64_t graph500_validate (const int64_t * off, const int64_t * ind,
+			   int64_t nv, int64_t root, const int64_t * parent);
+void graph500_parents_from_depth (const int64_t * off, const int64_t * ind,
+				  int64_t nv, int64_t root,
+				  const int64_t * depth, int64_t * parent);
+void graph500_run (const int64_t * off, const int64_t * ind, int64_t nv,
+		   graph500_bfs_fn bfs, void * ctx,
+		   graph500_result_t * result);
+void graph500_report (const char * name, const graph500_result_t * result);
+
+#endif /* GRAPH500_H_ */
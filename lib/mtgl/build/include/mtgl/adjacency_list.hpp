@@ -367,6 +367,9 @@ public:
     addEdges(num_edges, sources, targets);
   }
 
+  inline void init_csr(size_type num_verts, size_type* offsets,
+                       size_type* adjacencies);
+
   size_type get_order() const { return nVertices; }
   size_type get_size() const { return nEdges;  }
 
@@ -1000,6 +1003,107 @@ adjacency_list<DIRECTION>::addEdges(size_type num_edges, size_type* f,
 
 /***/
 
+/// \brief Builds the graph from compressed sparse row arrays.
+///
+/// Equivalent to init() with edge i running from the vertex whose row holds
+/// position i to adjacencies[i], and with edge i given id i.  Since the input
+/// is grouped by source, every vertex's edge list is sized once from the
+/// offsets and a vertex's own row is filled by a single thread without
+/// atomics.  Undirected graphs also place each edge in its target's list,
+/// after the target's own row, with one fetch-and-add per edge.
+template <typename DIRECTION>
+void
+adjacency_list<DIRECTION>::init_csr(size_type num_verts, size_type* offsets,
+                                    size_type* adjacencies)
+{
+  #pragma mta noalias *offsets
+  #pragma mta noalias *adjacencies
+
+  clear();
+
+  size_type num_edges = offsets[num_verts];
+
+  vertex_list.resize(num_verts);
+  edge_list.resize(num_edges);
+
+  #pragma mta assert nodep
+  #ifdef _OPENMP
+  #pragma omp parallel for
+  #endif
+  for (size_type i = 0; i < num_verts; ++i)
+  {
+    vertex_list[i] = new Vertex(i);
+  }
+
+  // Count the reverse entries each vertex receives.
+  if (!DIRECTION::is_directed())
+  {
+    #pragma mta assert parallel
+    #ifdef _OPENMP
+    #pragma omp parallel for
+    #endif
+    for (size_type i = 0; i < num_edges; ++i)
+    {
+      mt_incr(vertex_list[adjacencies[i]]->num_edges_to_add, 1);
+    }
+  }
+
+  // Size each edge list once and fill in the vertex's own row.
+  #pragma mta assert parallel
+  #ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic, 1024)
+  #endif
+  for (size_type i = 0; i < num_verts; ++i)
+  {
+    Vertex* v = vertex_list[i];
+    size_type begin = offsets[i];
+    size_type out_deg = offsets[i + 1] - begin;
+
+    v->edge_list.resize(out_deg + v->num_edges_to_add);
+    v->num_edges_to_add = 0;
+
+    for (size_type j = 0; j < out_deg; ++j)
+    {
+      Edge* e = new Edge(v, vertex_list[adjacencies[begin + j]], begin + j);
+      edge_list[begin + j] = e;
+      v->edge_list[j] = e;
+    }
+  }
+
+  // Place the reverse entries after each target's own row.
+  if (!DIRECTION::is_directed())
+  {
+    #pragma mta assert parallel
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 1024)
+    #endif
+    for (size_type i = 0; i < num_verts; ++i)
+    {
+      for (size_type j = offsets[i]; j < offsets[i + 1]; ++j)
+      {
+        Vertex* t = vertex_list[adjacencies[j]];
+        size_type t_out_deg = offsets[t->id + 1] - offsets[t->id];
+        size_type pos = t_out_deg + mt_incr(t->num_edges_to_add, 1);
+        t->edge_list[pos] = edge_list[j];
+      }
+    }
+
+    #pragma mta assert nodep
+    #ifdef _OPENMP
+    #pragma omp parallel for
+    #endif
+    for (size_type i = 0; i < num_verts; ++i)
+    {
+      vertex_list[i]->num_edges_to_add = 0;
+    }
+  }
+
+  nVertices = num_verts;
+  nEdges = num_edges;
+}
+
+/***/
+
 template <typename DIRECTION>
 void
 adjacency_list<DIRECTION>::removeEdges(size_type num_edges, size_type* e)
@@ -1477,6 +1581,18 @@ void init(typename adjacency_list<DIRECTION>::size_type n,
 
 /***/
 
+template <typename DIRECTION>
+inline
+void init_csr(typename adjacency_list<DIRECTION>::size_type n,
+              typename adjacency_list<DIRECTION>::size_type* offsets,
+              typename adjacency_list<DIRECTION>::size_type* adjacencies,
+              adjacency_list<DIRECTION>& g)
+{
+  return g.init_csr(n, offsets, adjacencies);
+}
+
+/***/
+
 template <typename DIRECTION>
 inline
 void clear(adjacency_list<DIRECTION>& g)
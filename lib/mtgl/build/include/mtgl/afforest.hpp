@@ -0,0 +1,222 @@
+/*  _________________________________________________________________________
+ *
+ *  MTGL: The MultiThreaded Graph Library
+ *  Copyright (c) 2008 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the README file in the top MTGL directory.
+ *  _________________________________________________________________________
+ */
+
+/****************************************************************************/
+/*! \file afforest.hpp
+
+    \brief Connected components by neighbor sampling, after Sutton, Ben-Nun
+           and Barak, "Optimizing Parallel Graph Connectivity Computation
+           via Subgraph Sampling" (IPDPS 2018).
+
+    \date 10/17/2026
+*/
+/****************************************************************************/
+
+#ifndef MTGL_AFFOREST_HPP
+#define MTGL_AFFOREST_HPP
+
+#include <cstdlib>
+#include <algorithm>
+
+#include <mtgl/util.hpp>
+#include <mtgl/mtgl_adapter.hpp>
+
+#define AFFOREST_NUM_SAMPLES 1024
+
+namespace mtgl {
+
+namespace detail {
+
+template <typename T>
+inline bool afforest_cas(T& target, T oldval, T newval)
+{
+#ifdef __MTA__
+  T cur = mt_readfe(target);
+  bool swapped = cur == oldval;
+  mt_write(target, swapped ? newval : cur);
+  return swapped;
+#elif defined(_OPENMP)
+  return __sync_bool_compare_and_swap(&target, oldval, newval);
+#else
+  if (target != oldval) return false;
+  target = newval;
+  return true;
+#endif
+}
+
+/// \brief Joins the trees of u and v, hanging the larger root under the
+///        smaller.  Lock-free: a root is only ever replaced by a compare
+///        and swap, so concurrent links on the same trees retry.
+template <typename size_type>
+void afforest_link(size_type u, size_type v, size_type* comp)
+{
+  size_type p1 = comp[u];
+  size_type p2 = comp[v];
+
+  while (p1 != p2)
+  {
+    size_type high = p1 > p2 ? p1 : p2;
+    size_type low = p1 + p2 - high;
+    size_type p_high = comp[high];
+
+    if (p_high == low) break;
+    if (p_high == high && afforest_cas(comp[high], high, low)) break;
+
+    p1 = comp[comp[high]];
+    p2 = comp[low];
+  }
+}
+
+template <typename size_type>
+void afforest_compress(size_type order, size_type* comp)
+{
+  #pragma mta assert parallel
+  #ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic, 16384)
+  #endif
+  for (size_type i = 0; i < order; ++i)
+  {
+    while (comp[i] != comp[comp[i]]) comp[i] = comp[comp[i]];
+  }
+}
+
+/// \brief Returns the most frequent label among a fixed-seed sample of
+///        vertices, which on a graph with a giant component is almost
+///        surely the giant component's.
+template <typename size_type>
+size_type afforest_sample_frequent(size_type order, size_type* comp)
+{
+  size_type samples[AFFOREST_NUM_SAMPLES];
+  unsigned long long state = 0x5EEDAFF0ULL;
+
+  for (int i = 0; i < AFFOREST_NUM_SAMPLES; ++i)
+  {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    samples[i] = comp[(state >> 33) % order];
+  }
+
+  std::sort(samples, samples + AFFOREST_NUM_SAMPLES);
+
+  size_type best = samples[0];
+  int best_count = 0;
+  for (int i = 0; i < AFFOREST_NUM_SAMPLES; )
+  {
+    int j = i;
+    while (j < AFFOREST_NUM_SAMPLES && samples[j] == samples[i]) ++j;
+    if (j - i > best_count)
+    {
+      best = samples[i];
+      best_count = j - i;
+    }
+    i = j;
+  }
+
+  return best;
+}
+
+}
+
+/*! \brief Afforest connected components.
+
+    Links each vertex to its first neighbor_rounds neighbors and compresses,
+    which on R-MAT and other skewed graphs already joins most vertices into
+    one giant component.  The giant component's label is found by sampling,
+    and the remaining adjacencies are then processed only for vertices
+    outside it: on an undirected graph every edge with one endpoint in the
+    giant component is seen from its other endpoint.  On a directed graph
+    every vertex's remaining out-edges are processed, so the result holds
+    the weakly connected components.
+
+    On return result[v] is the smallest vertex id in v's component, as with
+    shiloach_vishkin().
+*/
+template <typename Graph, typename ComponentMap>
+void afforest(Graph& g, ComponentMap& result, int neighbor_rounds = 2)
+{
+  #pragma mta noalias g
+  #pragma mta noalias result
+
+  typedef typename graph_traits<Graph>::size_type size_type;
+  typedef typename graph_traits<Graph>::vertex_iterator vertex_iterator;
+  typedef typename graph_traits<Graph>::adjacency_iterator adjacency_iterator;
+
+  vertex_id_map<Graph> vid_map = get(_vertex_id_map, g);
+  vertex_iterator verts = vertices(g);
+  size_type order = num_vertices(g);
+
+  if (order == 0) return;
+
+  size_type* comp = (size_type*) malloc(order * sizeof(size_type));
+
+  #pragma mta assert nodep
+  #ifdef _OPENMP
+  #pragma omp parallel for
+  #endif
+  for (size_type i = 0; i < order; ++i) comp[i] = i;
+
+  // Sample: link along the first few adjacencies of every vertex.
+  for (int r = 0; r < neighbor_rounds; ++r)
+  {
+    #pragma mta assert parallel
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 16384)
+    #endif
+    for (size_type i = 0; i < order; ++i)
+    {
+      size_type deg = out_degree(verts[i], g);
+
+      if (static_cast<size_type>(r) < deg)
+      {
+        adjacency_iterator adjs = adjacent_vertices(verts[i], g);
+        detail::afforest_link(i, get(vid_map, adjs[r]), comp);
+      }
+    }
+
+    detail::afforest_compress(order, comp);
+  }
+
+  size_type giant = detail::afforest_sample_frequent(order, comp);
+  bool directed = is_directed(g);
+
+  // Finish: the rest of the adjacencies, skipping the giant component.
+  #pragma mta assert parallel
+  #ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic, 16384)
+  #endif
+  for (size_type i = 0; i < order; ++i)
+  {
+    if (!directed && comp[i] == giant) continue;
+
+    size_type deg = out_degree(verts[i], g);
+    adjacency_iterator adjs = adjacent_vertices(verts[i], g);
+
+    for (size_type k = neighbor_rounds; k < deg; ++k)
+    {
+      detail::afforest_link(i, get(vid_map, adjs[k]), comp);
+    }
+  }
+
+  detail::afforest_compress(order, comp);
+
+  #pragma mta assert nodep
+  #ifdef _OPENMP
+  #pragma omp parallel for
+  #endif
+  for (size_type i = 0; i < order; ++i) result[verts[i]] = comp[i];
+
+  free(comp);
+}
+
+}
+
+#undef AFFOREST_NUM_SAMPLES
+
+#endif
@@ -758,14 +758,51 @@ void omp_qt_sort(T* array, long size, T2* array2, Comparator comp)
 #endif
 }
 
+#if defined _OPENMP && !defined USING_QTHREADS
+namespace detail {
+
+template <typename T>
+inline
+void sort_less(T* array, long size, radix_key_tag)
+{
+  radix_sort(array, size);
+}
+
+template <typename T>
+inline
+void sort_less(T* array, long size, other_key_tag)
+{
+  omp_qt_sort(array, size, std::less<T>());
+}
+
+template <typename T, typename T2>
+inline
+void sort_less(T* array, long size, T2* array2, radix_key_tag)
+{
+  radix_sort(array, size, array2);
+}
+
+template <typename T, typename T2>
+inline
+void sort_less(T* array, long size, T2* array2, other_key_tag)
+{
+  omp_qt_sort(array, size, array2, std::less<T>());
+}
+
+}
+#endif
+
+/// Under OpenMP, integer keys are radix sorted.
 template <typename T>
 inline
 void sort(T* array, long size)
 {
-#if defined _OPENMP || defined USING_QTHREADS
+#if defined USING_QTHREADS
   detail::omp_qt_sort(array, size, std::less<T>());
+#elif defined _OPENMP
+  detail::sort_less(array, size, typename detail::radix_traits<T>::category());
 #else
-  merge_sort(array, size, std::less<T>());
+  merge_sort(array, size);
 #endif
 }
 
@@ -784,10 +821,13 @@ template <typename T, typename T2>
 inline
 void sort(T* array, long size, T2* array2)
 {
-#if defined _OPENMP || defined USING_QTHREADS
+#if defined USING_QTHREADS
   detail::omp_qt_sort(array, size, array2, std::less<T>());
+#elif defined _OPENMP
+  detail::sort_less(array, size, array2,
+                    typename detail::radix_traits<T>::category());
 #else
-  merge_sort(array, size, array2, std::less<T>());
+  merge_sort(array, size, array2);
 #endif
 }
 
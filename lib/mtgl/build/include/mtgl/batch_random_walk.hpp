@@ -0,0 +1,395 @@
+/*  _________________________________________________________________________
+ *
+ *  MTGL: The MultiThreaded Graph Library
+ *  Copyright (c) 2008 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the README file in the top MTGL directory.
+ *  _________________________________________________________________________
+ */
+
+/****************************************************************************/
+/*! \file batch_random_walk.hpp
+
+    \brief Advances many random walks at once, one step for every walker per
+           pass, with alias-table sampling of weighted edges and the
+           second-order node2vec bias of Grover and Leskovec, "node2vec:
+           Scalable Feature Learning for Networks" (KDD 2016).
+
+    \date 10/17/2026
+*/
+/****************************************************************************/
+
+#ifndef MTGL_BATCH_RANDOM_WALK_HPP
+#define MTGL_BATCH_RANDOM_WALK_HPP
+
+#include <cstdlib>
+#include <algorithm>
+#include <utility>
+
+#include <mtgl/util.hpp>
+#include <mtgl/mtgl_adapter.hpp>
+#include <mtgl/partitioning.hpp>
+#include <mtgl/parallel_primitives.hpp>
+
+#define BATCH_RANDOM_WALK_MAX_BUCKETS 4096
+
+namespace mtgl {
+
+namespace detail {
+
+/// Each walker draws from its own splitmix64 stream, so the walks do not
+/// depend on the thread schedule.
+inline unsigned long rw_next(unsigned long& state)
+{
+  unsigned long z = (state += 0x9E3779B97F4A7C15UL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9UL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBUL;
+  return z ^ (z >> 31);
+}
+
+inline double rw_uniform(unsigned long& state)
+{
+  return (rw_next(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+}
+
+/*! \brief Random walks from many starting vertices at once.
+
+    The constructor copies the graph's adjacencies into a CSR indexed by
+    vertex id with every row sorted, so a step is two array reads and the
+    node2vec test of whether x is a neighbor of t is a binary search in t's
+    row.  Given edge weights, it also builds a Walker / Vose alias table for
+    every row, so a weighted step costs the same as an unweighted one.
+
+    run() advances every live walker by one step per pass.  Before each pass
+    the walkers are grouped by the block of vertex ids they are at, so the
+    walkers reading the same part of the CSR run together.  A walker stops
+    early at a vertex with no out-edges.
+
+    With set_node2vec(p, q), a step from u back to the previous vertex t is
+    weighted by 1/p, a step to a neighbor of t by 1, and any other step by
+    1/q.  Steps are drawn by rejection against the first-order distribution,
+    which needs no per-edge state beyond the alias tables.
+*/
+template <typename Graph>
+class batch_random_walk {
+public:
+  typedef typename graph_traits<Graph>::size_type size_type;
+  typedef typename graph_traits<Graph>::vertex_iterator vertex_iterator;
+  typedef typename graph_traits<Graph>::adjacency_iterator adjacency_iterator;
+  typedef typename graph_traits<Graph>::edge_descriptor edge_descriptor;
+  typedef typename graph_traits<Graph>::out_edge_iterator out_edge_iterator;
+
+  /// \brief Walks that choose each out-edge with equal probability.
+  batch_random_walk(Graph& g) :
+    order(num_vertices(g)), prob(0), alias(0), return_bias(1), inout_bias(1)
+  {
+    init_offsets(g);
+
+    vertex_id_map<Graph> vid_map = get(_vertex_id_map, g);
+    vertex_iterator verts = vertices(g);
+
+    #pragma mta assert parallel
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 1024)
+    #endif
+    for (size_type i = 0; i < order; ++i)
+    {
+      adjacency_iterator adjs = adjacent_vertices(verts[i], g);
+      size_type deg = offsets[i + 1] - offsets[i];
+
+      for (size_type k = 0; k < deg; ++k)
+      {
+        adj[offsets[i] + k] = get(vid_map, adjs[k]);
+      }
+    }
+
+    segmented_sort(offsets, order, adj);
+  }
+
+  /// \brief Walks that choose each out-edge e with probability proportional
+  ///        to weights[e].  The weights must be non-negative, and every
+  ///        vertex with out-edges must have one of positive weight.
+  template <typename WeightMap>
+  batch_random_walk(Graph& g, WeightMap& weights) :
+    order(num_vertices(g)), return_bias(1), inout_bias(1)
+  {
+    typedef std::pair<size_type, double> weighted_adj;
+
+    init_offsets(g);
+
+    size_type size = offsets[order];
+    prob = (double*) malloc(size * sizeof(double));
+    alias = (size_type*) malloc(size * sizeof(size_type));
+    weighted_adj* pairs = (weighted_adj*) malloc(size * sizeof(weighted_adj));
+
+    vertex_id_map<Graph> vid_map = get(_vertex_id_map, g);
+    vertex_iterator verts = vertices(g);
+
+    #pragma mta assert parallel
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 1024)
+    #endif
+    for (size_type i = 0; i < order; ++i)
+    {
+      out_edge_iterator edgs = out_edges(verts[i], g);
+      size_type begin = offsets[i];
+      size_type end = offsets[i + 1];
+
+      for (size_type k = begin; k < end; ++k)
+      {
+        edge_descriptor e = edgs[k - begin];
+        pairs[k] = weighted_adj(get(vid_map, target(e, g)), weights[e]);
+      }
+
+      std::sort(pairs + begin, pairs + end);
+
+      for (size_type k = begin; k < end; ++k)
+      {
+        adj[k] = pairs[k].first;
+        prob[k] = pairs[k].second;
+      }
+
+      build_alias(begin, end, reinterpret_cast<size_type*>(pairs + begin));
+    }
+
+    free(pairs);
+  }
+
+  ~batch_random_walk()
+  {
+    free(offsets);
+    free(adj);
+    free(prob);
+    free(alias);
+  }
+
+  /// \brief Biases later walks as node2vec does, with return parameter p
+  ///        and in-out parameter q.  p = q = 1 is the unbiased walk.
+  void set_node2vec(double p, double q)
+  {
+    return_bias = 1.0 / p;
+    inout_bias = 1.0 / q;
+  }
+
+  /*! \brief Runs one walk from each of starts[0..num_walkers).
+
+      Walk w is written to walks[w * walk_length ...], starting with
+      starts[w], and its number of vertices to lengths[w]; that is
+      walk_length unless the walk reached a vertex with no out-edges.
+      Returns the total number of steps taken.
+  */
+  size_type run(const size_type* starts, size_type num_walkers,
+                size_type walk_length, size_type* walks, size_type* lengths,
+                unsigned long seed = 0)
+  {
+    #pragma mta noalias *this
+
+    if (num_walkers == 0 || walk_length == 0) return 0;
+
+    int shift = 0;
+    while ((order >> shift) >= BATCH_RANDOM_WALK_MAX_BUCKETS) ++shift;
+    size_type num_buckets = (order >> shift) + 1;
+
+    size_type* live = (size_type*) malloc(num_walkers * sizeof(size_type));
+    size_type* grouped = (size_type*) malloc(num_walkers * sizeof(size_type));
+    size_type* bucket = (size_type*) malloc(num_buckets * sizeof(size_type));
+    unsigned long* state =
+      (unsigned long*) malloc(num_walkers * sizeof(unsigned long));
+
+    #pragma mta assert nodep
+    #ifdef _OPENMP
+    #pragma omp parallel for
+    #endif
+    for (size_type w = 0; w < num_walkers; ++w)
+    {
+      walks[w * walk_length] = starts[w];
+      lengths[w] = 1;
+      live[w] = w;
+
+      state[w] = seed + w * 0xD1B54A32D192ED03UL;
+      detail::rw_next(state[w]);
+    }
+
+    size_type num_live = num_walkers;
+    bool biased = return_bias != 1 || inout_bias != 1;
+    double max_bias = std::max(1.0, std::max(return_bias, inout_bias));
+
+    for (size_type step = 1; step < walk_length && num_live > 0; ++step)
+    {
+      // Group the walkers that can still move by the block of their
+      // current vertex, dropping the ones that stopped.
+      for (size_type b = 0; b < num_buckets; ++b) bucket[b] = 0;
+
+      #pragma mta assert parallel
+      #ifdef _OPENMP
+      #pragma omp parallel for
+      #endif
+      for (size_type i = 0; i < num_live; ++i)
+      {
+        size_type w = live[i];
+        size_type u = walks[w * walk_length + step - 1];
+
+        if (lengths[w] == step && offsets[u + 1] > offsets[u])
+        {
+          mt_incr(bucket[u >> shift], 1);
+        }
+      }
+
+      size_type total = 0;
+      for (size_type b = 0; b < num_buckets; ++b)
+      {
+        size_type count = bucket[b];
+        bucket[b] = total;
+        total += count;
+      }
+
+      #pragma mta assert parallel
+      #ifdef _OPENMP
+      #pragma omp parallel for
+      #endif
+      for (size_type i = 0; i < num_live; ++i)
+      {
+        size_type w = live[i];
+        size_type u = walks[w * walk_length + step - 1];
+
+        if (lengths[w] == step && offsets[u + 1] > offsets[u])
+        {
+          grouped[mt_incr(bucket[u >> shift], 1)] = w;
+        }
+      }
+
+      std::swap(live, grouped);
+      num_live = total;
+
+      // Move every grouped walker one step.
+      #pragma mta assert parallel
+      #ifdef _OPENMP
+      #pragma omp parallel for schedule(dynamic, 1024)
+      #endif
+      for (size_type i = 0; i < num_live; ++i)
+      {
+        size_type w = live[i];
+        size_type* walk = walks + w * walk_length;
+        size_type u = walk[step - 1];
+        size_type x = sample(u, state[w]);
+
+        if (biased && step > 1)
+        {
+          size_type t = walk[step - 2];
+
+          while (max_bias * detail::rw_uniform(state[w]) >= bias(t, x))
+          {
+            x = sample(u, state[w]);
+          }
+        }
+
+        walk[step] = x;
+        lengths[w] = step + 1;
+      }
+    }
+
+    size_type steps = 0;
+
+    #pragma mta assert nodep
+    #ifdef _OPENMP
+    #pragma omp parallel for reduction(+:steps)
+    #endif
+    for (size_type w = 0; w < num_walkers; ++w) steps += lengths[w] - 1;
+
+    free(live);
+    free(grouped);
+    free(bucket);
+    free(state);
+
+    return steps;
+  }
+
+private:
+  void init_offsets(Graph& g)
+  {
+    offsets = (size_type*) malloc((order + 1) * sizeof(size_type));
+    accumulate_out_degree(offsets, g);
+
+    adj = (size_type*) malloc(offsets[order] * sizeof(size_type));
+  }
+
+  /// Turns the weights in prob[begin..end) into an alias table.  The small
+  /// and large worklists share scratch[0..end-begin), small growing from
+  /// the front and large from the back; each pairing retires an entry, so
+  /// they never meet.
+  void build_alias(size_type begin, size_type end, size_type* scratch)
+  {
+    size_type deg = end - begin;
+    if (deg == 0) return;
+
+    double sum = 0;
+    for (size_type k = begin; k < end; ++k) sum += prob[k];
+
+    size_type num_small = 0;
+    size_type large = deg;
+
+    for (size_type k = 0; k < deg; ++k)
+    {
+      prob[begin + k] *= deg / sum;
+      alias[begin + k] = k;
+
+      if (prob[begin + k] < 1) scratch[num_small++] = k;
+      else scratch[--large] = k;
+    }
+
+    while (num_small > 0 && large < deg)
+    {
+      size_type s = scratch[--num_small];
+      size_type l = scratch[large++];
+
+      alias[begin + s] = l;
+      prob[begin + l] -= 1 - prob[begin + s];
+
+      if (prob[begin + l] < 1) scratch[num_small++] = l;
+      else scratch[--large] = l;
+    }
+
+    // What is left is 1 up to rounding.
+    while (num_small > 0) prob[begin + scratch[--num_small]] = 1;
+    while (large < deg) prob[begin + scratch[large++]] = 1;
+  }
+
+  size_type sample(size_type u, unsigned long& st) const
+  {
+    size_type k = offsets[u] + detail::rw_next(st) % (offsets[u + 1] -
+                                                      offsets[u]);
+
+    if (prob && detail::rw_uniform(st) >= prob[k]) k = offsets[u] + alias[k];
+
+    return adj[k];
+  }
+
+  double bias(size_type t, size_type x) const
+  {
+    if (x == t) return return_bias;
+    if (std::binary_search(adj + offsets[t], adj + offsets[t + 1], x))
+    {
+      return 1;
+    }
+
+    return inout_bias;
+  }
+
+  size_type order;
+  size_type* offsets;
+  size_type* adj;
+  double* prob;
+  size_type* alias;
+  double return_bias;
+  double inout_bias;
+};
+
+}
+
+#undef BATCH_RANDOM_WALK_MAX_BUCKETS
+
+#endif
@@ -0,0 +1,411 @@
+/*  _________________________________________________________________________
+ *
+ *  MTGL: The MultiThreaded Graph Library
+ *  Copyright (c) 2008 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the README file in the top MTGL directory.
+ *  _________________________________________________________________________
+ */
+
+/****************************************************************************/
+/*! \file csr_transpose.hpp
+
+    \brief Parallel transpose and symmetrization of compressed sparse row
+           arrays by a counting scatter over per-thread degree histograms.
+
+    \date 10/17/2026
+
+    The vertices are split into one contiguous block per thread, balanced by
+    edges.  Each block counts the entries it will write into every output
+    row, the counts are scanned row by row and block by block, and each block
+    then writes its own entries straight into the output arrays.  Nothing is
+    atomic, nothing is staged in an edge list, and the output is the same
+    for any number of threads: within a transposed row the sources appear in
+    increasing order.
+
+    Self loops and repeated edges can be dropped while scattering.  A block
+    keeps a mark per vertex holding the last row that wrote to it, so a
+    repeat is seen without sorting.
+
+    The histograms take one word per vertex per block, and the number of
+    blocks is limited so that they never take more words than there are
+    edges.  The workspace the calls allocate beyond the arrays the caller
+    passes in can be reported through peak_bytes.
+*/
+/****************************************************************************/
+
+#ifndef MTGL_CSR_TRANSPOSE_HPP
+#define MTGL_CSR_TRANSPOSE_HPP
+
+#include <cstdlib>
+#include <algorithm>
+
+#include <mtgl/util.hpp>
+#include <mtgl/parallel_primitives.hpp>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define CSR_TRANSPOSE_MIN_BLOCK 8192
+
+namespace mtgl {
+
+/// Filters for transpose_csr() and symmetrize_csr().  They may be or'ed.
+enum { KEEP_ALL_EDGES = 0, REMOVE_SELF_LOOPS = 1, REMOVE_DUPLICATE_EDGES = 2 };
+
+namespace detail {
+
+/// Number of vertex blocks for a pass over the rows: one per thread, but
+/// with no more histogram words than edges.
+template <typename size_type>
+long csr_blocks(size_type order, size_type size)
+{
+  long min_block = order > CSR_TRANSPOSE_MIN_BLOCK ?
+                   static_cast<long>(order) : CSR_TRANSPOSE_MIN_BLOCK;
+
+  return primitive_blocks(static_cast<long>(size), min_block);
+}
+
+/// Splits the rows into blocks holding about the same number of entries.
+/// The first vertex of block b is bounds[b].
+template <typename size_type>
+void csr_block_bounds(size_type order, const size_type* offsets, long blocks,
+                      size_type* bounds)
+{
+  size_type size = offsets[order];
+
+  bounds[0] = 0;
+  bounds[blocks] = order;
+
+  for (long b = 1; b < blocks; ++b)
+  {
+    size_type first = primitive_block_begin(size, b, blocks);
+    bounds[b] = std::lower_bound(offsets, offsets + order, first) - offsets;
+  }
+}
+
+}
+
+/*! \brief Computes the transpose of a graph given in compressed sparse row
+           form.
+
+    \param order The number of vertices.
+    \param offsets The row offsets, of size order + 1.
+    \param adjacencies The targets of the edges, of size offsets[order].
+    \param t_offsets Receives the row offsets of the transpose.  Must be of
+                     size order + 1.
+    \param t_adjacencies Receives the targets of the transpose.  Must have
+                         room for offsets[order] entries.
+    \param t_positions If given, receives for each entry of the transpose
+                       the position in adjacencies of the edge it came from.
+                       Must have room for offsets[order] entries.
+    \param filter The edges to drop; see REMOVE_SELF_LOOPS and
+                  REMOVE_DUPLICATE_EDGES.  The first copy of a repeated edge
+                  is the one kept.
+    \param peak_bytes If given, receives the most workspace memory in bytes
+                      held at any time.
+
+    \returns The number of entries in the transpose.
+
+    Row v of the transpose lists the sources of the edges into v in
+    increasing order.
+*/
+template <typename size_type>
+size_type
+transpose_csr(size_type order, const size_type* offsets,
+              const size_type* adjacencies, size_type* t_offsets,
+              size_type* t_adjacencies, size_type* t_positions = 0,
+              int filter = KEEP_ALL_EDGES, unsigned long* peak_bytes = 0)
+{
+  bool no_loops = (filter & REMOVE_SELF_LOOPS) != 0;
+  bool no_repeats = (filter & REMOVE_DUPLICATE_EDGES) != 0;
+
+  long blocks = detail::csr_blocks(order, offsets[order]);
+  size_type* bounds = (size_type*) malloc((blocks + 1) * sizeof(size_type));
+  detail::csr_block_bounds(order, offsets, blocks, bounds);
+
+  // Block b's histogram is counts[b * order ... (b + 1) * order), and its
+  // marks hold one more than the last row that wrote to each vertex.
+  size_type* counts =
+    (size_type*) calloc(blocks * order, sizeof(size_type));
+  size_type* marks = no_repeats ?
+    (size_type*) malloc(blocks * order * sizeof(size_type)) : 0;
+
+  #pragma mta assert parallel
+  #ifdef _OPENMP
+  #pragma omp parallel for if (blocks > 1)
+  #endif
+  for (long b = 0; b < blocks; ++b)
+  {
+    size_type* count = counts + b * order;
+    size_type* mark = no_repeats ? marks + b * order : 0;
+
+    if (no_repeats)
+    {
+      for (size_type v = 0; v < order; ++v) mark[v] = 0;
+    }
+
+    for (size_type u = bounds[b]; u < bounds[b + 1]; ++u)
+    {
+      for (size_type k = offsets[u]; k < offsets[u + 1]; ++k)
+      {
+        size_type v = adjacencies[k];
+
+        if (no_loops && v == u) continue;
+
+        if (no_repeats)
+        {
+          if (mark[v] == u + 1) continue;
+          mark[v] = u + 1;
+        }
+
+        ++count[v];
+      }
+    }
+  }
+
+  // Turn each column of the histograms into the offset of the block's
+  // entries within the row, and the column total into the row length.
+  #pragma mta assert nodep
+  #ifdef _OPENMP
+  #pragma omp parallel for
+  #endif
+  for (size_type v = 0; v < order; ++v)
+  {
+    size_type sum = 0;
+
+    for (long b = 0; b < blocks; ++b)
+    {
+      size_type c = counts[b * order + v];
+      counts[b * order + v] = sum;
+      sum += c;
+    }
+
+    t_offsets[v] = sum;
+  }
+
+  t_offsets[order] = exclusive_prefix_sum(t_offsets, t_offsets, order);
+
+  #pragma mta assert parallel
+  #ifdef _OPENMP
+  #pragma omp parallel for if (blocks > 1)
+  #endif
+  for (long b = 0; b < blocks; ++b)
+  {
+    size_type* next = counts + b * order;
+    size_type* mark = no_repeats ? marks + b * order : 0;
+
+    if (no_repeats)
+    {
+      for (size_type v = 0; v < order; ++v) mark[v] = 0;
+    }
+
+    for (size_type u = bounds[b]; u < bounds[b + 1]; ++u)
+    {
+      for (size_type k = offsets[u]; k < offsets[u + 1]; ++k)
+      {
+        size_type v = adjacencies[k];
+
+        if (no_loops && v == u) continue;
+
+        if (no_repeats)
+        {
+          if (mark[v] == u + 1) continue;
+          mark[v] = u + 1;
+        }
+
+        size_type pos = t_offsets[v] + next[v]++;
+        t_adjacencies[pos] = u;
+        if (t_positions) t_positions[pos] = k;
+      }
+    }
+  }
+
+  if (peak_bytes)
+  {
+    *peak_bytes = (blocks + 1 + (no_repeats ? 2 : 1) * blocks * order) *
+                  sizeof(size_type);
+  }
+
+  free(bounds);
+  free(counts);
+  if (marks) free(marks);
+
+  return t_offsets[order];
+}
+
+/*! \brief Computes the symmetric closure of a graph given in compressed
+           sparse row form: every edge (u, v) appears as both (u, v) and
+           (v, u).
+
+    \param order The number of vertices.
+    \param offsets The row offsets, of size order + 1.
+    \param adjacencies The targets of the edges, of size offsets[order].
+    \param s_offsets Receives the row offsets of the closure.  Must be of
+                     size order + 1.
+    \param s_adjacencies Receives the targets of the closure.  Must have
+                         room for 2 * offsets[order] entries.
+    \param s_positions If given, receives for each entry of the closure the
+                       position k in adjacencies of the edge it came from,
+                       or offsets[order] + k if it is the reverse of that
+                       edge.  Must have room for 2 * offsets[order] entries.
+    \param filter The edges to drop; see REMOVE_SELF_LOOPS and
+                  REMOVE_DUPLICATE_EDGES.  With REMOVE_DUPLICATE_EDGES an
+                  edge and its reverse count as the same edge, and a forward
+                  copy is kept in favor of a reverse one.
+    \param peak_bytes If given, receives the most workspace memory in bytes
+                      held at any time.
+
+    \returns The number of entries in the closure.
+
+    Row u of the closure holds u's own row in input order followed by the
+    transposed row of u, with the sources in increasing order.  Without
+    filters the reverse of a self loop is kept too, so each loop appears
+    twice.
+*/
+template <typename size_type>
+size_type
+symmetrize_csr(size_type order, const size_type* offsets,
+               const size_type* adjacencies, size_type* s_offsets,
+               size_type* s_adjacencies, size_type* s_positions = 0,
+               int filter = KEEP_ALL_EDGES, unsigned long* peak_bytes = 0)
+{
+  bool no_loops = (filter & REMOVE_SELF_LOOPS) != 0;
+  bool no_repeats = (filter & REMOVE_DUPLICATE_EDGES) != 0;
+
+  size_type size = offsets[order];
+
+  size_type* t_offsets = (size_type*) malloc((order + 1) * sizeof(size_type));
+  size_type* t_adjacencies = (size_type*) malloc(size * sizeof(size_type));
+  size_type* t_positions = s_positions ?
+    (size_type*) malloc(size * sizeof(size_type)) : 0;
+
+  unsigned long t_peak = 0;
+  transpose_csr(order, offsets, adjacencies, t_offsets, t_adjacencies,
+                t_positions, filter, &t_peak);
+
+  long blocks = detail::csr_blocks(order, size);
+  size_type* bounds = (size_type*) malloc((blocks + 1) * sizeof(size_type));
+  detail::csr_block_bounds(order, offsets, blocks, bounds);
+
+  size_type* marks = no_repeats ?
+    (size_type*) malloc(blocks * order * sizeof(size_type)) : 0;
+
+  // Row u is u's own row followed by the transposed row, each without the
+  // entries the filter drops.  With the marks of the own row in place, a
+  // transposed entry repeats an edge exactly when its source is marked.
+  #pragma mta assert parallel
+  #ifdef _OPENMP
+  #pragma omp parallel for if (blocks > 1)
+  #endif
+  for (long b = 0; b < blocks; ++b)
+  {
+    size_type* mark = no_repeats ? marks + b * order : 0;
+
+    if (no_repeats)
+    {
+      for (size_type v = 0; v < order; ++v) mark[v] = 0;
+    }
+
+    for (size_type u = bounds[b]; u < bounds[b + 1]; ++u)
+    {
+      size_type count = 0;
+
+      for (size_type k = offsets[u]; k < offsets[u + 1]; ++k)
+      {
+        size_type v = adjacencies[k];
+
+        if (no_loops && v == u) continue;
+
+        if (no_repeats)
+        {
+          if (mark[v] == u + 1) continue;
+          mark[v] = u + 1;
+        }
+
+        ++count;
+      }
+
+      for (size_type j = t_offsets[u]; j < t_offsets[u + 1]; ++j)
+      {
+        if (!no_repeats || mark[t_adjacencies[j]] != u + 1) ++count;
+      }
+
+      s_offsets[u] = count;
+    }
+  }
+
+  s_offsets[order] = exclusive_prefix_sum(s_offsets, s_offsets, order);
+
+  #pragma mta assert parallel
+  #ifdef _OPENMP
+  #pragma omp parallel for if (blocks > 1)
+  #endif
+  for (long b = 0; b < blocks; ++b)
+  {
+    size_type* mark = no_repeats ? marks + b * order : 0;
+
+    if (no_repeats)
+    {
+      for (size_type v = 0; v < order; ++v) mark[v] = 0;
+    }
+
+    for (size_type u = bounds[b]; u < bounds[b + 1]; ++u)
+    {
+      size_type pos = s_offsets[u];
+
+      for (size_type k = offsets[u]; k < offsets[u + 1]; ++k)
+      {
+        size_type v = adjacencies[k];
+
+        if (no_loops && v == u) continue;
+
+        if (no_repeats)
+        {
+          if (mark[v] == u + 1) continue;
+          mark[v] = u + 1;
+        }
+
+        s_adjacencies[pos] = v;
+        if (s_positions) s_positions[pos] = k;
+        ++pos;
+      }
+
+      for (size_type j = t_offsets[u]; j < t_offsets[u + 1]; ++j)
+      {
+        if (no_repeats && mark[t_adjacencies[j]] == u + 1) continue;
+
+        s_adjacencies[pos] = t_adjacencies[j];
+        if (s_positions) s_positions[pos] = size + t_positions[j];
+        ++pos;
+      }
+    }
+  }
+
+  if (peak_bytes)
+  {
+    unsigned long t_bytes =
+      (order + 1 + (s_positions ? 2 : 1) * size) * sizeof(size_type);
+    unsigned long s_bytes =
+      (blocks + 1 + (no_repeats ? blocks * order : 0)) * sizeof(size_type);
+
+    *peak_bytes = t_bytes + (t_peak > s_bytes ? t_peak : s_bytes);
+  }
+
+  free(bounds);
+  if (marks) free(marks);
+  free(t_offsets);
+  free(t_adjacencies);
+  if (t_positions) free(t_positions);
+
+  return s_offsets[order];
+}
+
+}
+
+#undef CSR_TRANSPOSE_MIN_BLOCK
+
+#endif
@@ -35,7 +35,10 @@
     global_to_local() on an edge returns a pair of edge descriptors.
 
     This adapter produces deterministic duplicate graphs in structure, but the
-    ids of the local edges may change between parallel runnings.
+    ids of the local edges may change between parallel runnings.  For a
+    directed graph the local edge ids are deterministic as well: the duplicate
+    is built from the out-edges in vertex order by csr_transpose.hpp's
+    symmetrize_csr().
 
     The base_adapter_type is expected to correctly implement a deep copy
     for both the copy constructor and the assignment operator.
@@ -47,6 +50,8 @@
 
 #include <mtgl/mtgl_adapter.hpp>
 #include <mtgl/compressed_sparse_row_graph.hpp>
+#include <mtgl/partitioning.hpp>
+#include <mtgl/csr_transpose.hpp>
 
 namespace mtgl {
 
@@ -87,18 +92,13 @@ public:
     m_local_vertex(static_cast<size_type>(1.7 * num_vertices(g)))
   {
     base_size_type order = num_vertices(*original_graph);
-    base_size_type size = num_edges(*original_graph);
-    base_size_type dsize = 2 * size;
+    base_size_type dsize = 2 * num_edges(*original_graph);
 
     base_vertex_iterator verts = vertices(*original_graph);
-    base_edge_iterator edgs = edges(*original_graph);
 
     m_global_vertex.resize(order);
     m_global_edge.resize(dsize);
 
-    size_type* sources = new size_type[size * 2];
-    size_type* dests = new size_type[size * 2];
-
     #pragma mta assert parallel 
     for (size_type i = 0; i < order; ++i)
     {
@@ -107,51 +107,7 @@ public:
       m_global_vertex[i] = v;
     }
 
-    // Get edge source and target ids.
-    #pragma mta assert parallel
-    for (base_size_type i = 0; i < size; ++i)
-    {
-      base_edge_descriptor e = edgs[i];
-
-      // Store the first copy of the original edge.
-      m_local_vertex.lookup(source(e, *original_graph), sources[i]);
-      m_local_vertex.lookup(target(e, *original_graph), dests[i]);
-
-      // Store the duplicate copy of the original edge.
-      if (is_undirected(g))
-      {
-        sources[i + size] = sources[i];
-        dests[i + size] = dests[i];
-      }
-      else
-      {
-        sources[i + size] = dests[i];
-        dests[i + size] = sources[i];
-      }
-    }
-
-    // Initialize the duplicate graph.  This is assuming that the init()
-    // method of the underlying graph implements parallelization correctly
-    // and efficiently.
-    init(order, dsize, sources, dests, duplicate_graph);
-
-    #pragma mta assert parallel 
-    for (size_type i = 0; i < dsize; ++i)
-    {
-      if (i < size)
-      {
-        base_edge_descriptor e = edgs[i];
-        m_local_edge.insert(e, i); 
-        m_global_edge[i] = e;
-      }
-      else
-      {
-        m_global_edge[i] = edgs[i - size];
-      }
-    }
-
-    delete [] sources;
-    delete [] dests;
+    init_duplicate(base_directed_category());
   }
 
   duplicate_adapter(const duplicate_adapter& dg) { deep_copy(dg); }
@@ -254,6 +210,125 @@ public:
   }
 
 private:
+  // For a directed graph the duplicate is the symmetric closure, so it is
+  // built in parallel from the out-edges by a counting scatter.  Out-edge k
+  // of the original graph, counting in vertex order, becomes local edge k
+  // and its reverse local edge k + size.
+  void init_duplicate(directedS)
+  {
+    typedef typename base_traits::out_edge_iterator base_out_edge_iterator;
+
+    size_type order = num_vertices(*original_graph);
+    size_type size = num_edges(*original_graph);
+
+    base_vertex_iterator verts = vertices(*original_graph);
+
+    size_type* offsets = (size_type*) malloc((order + 1) * sizeof(size_type));
+    size_type* adj = (size_type*) malloc(size * sizeof(size_type));
+
+    accumulate_out_degree(offsets, *original_graph);
+
+    #pragma mta assert parallel
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 1024)
+    #endif
+    for (size_type i = 0; i < order; ++i)
+    {
+      base_out_edge_iterator edgs = out_edges(verts[i], *original_graph);
+      size_type begin = offsets[i];
+      size_type end = offsets[i + 1];
+
+      for (size_type k = begin; k < end; ++k)
+      {
+        base_edge_descriptor e = edgs[k - begin];
+        m_local_vertex.lookup(target(e, *original_graph), adj[k]);
+        m_global_edge[k] = e;
+        m_global_edge[k + size] = e;
+      }
+    }
+
+    #pragma mta assert parallel
+    for (size_type k = 0; k < size; ++k)
+    {
+      m_local_edge.insert(m_global_edge[k], k);
+    }
+
+    size_type* d_offsets =
+      (size_type*) malloc((order + 1) * sizeof(size_type));
+    size_type* d_adj = (size_type*) malloc(2 * size * sizeof(size_type));
+    size_type* d_ids = (size_type*) malloc(2 * size * sizeof(size_type));
+
+    symmetrize_csr(order, offsets, adj, d_offsets, d_adj, d_ids);
+
+    free(offsets);
+    free(adj);
+
+    init_csr(order, d_offsets, d_adj, d_ids, duplicate_graph);
+
+    free(d_offsets);
+    free(d_adj);
+    free(d_ids);
+  }
+
+  template <typename DIRECTION>
+  void init_duplicate(DIRECTION)
+  {
+    base_size_type size = num_edges(*original_graph);
+    base_size_type order = num_vertices(*original_graph);
+    base_size_type dsize = 2 * size;
+
+    base_edge_iterator edgs = edges(*original_graph);
+
+    size_type* sources = new size_type[size * 2];
+    size_type* dests = new size_type[size * 2];
+
+    // Get edge source and target ids.
+    #pragma mta assert parallel
+    for (base_size_type i = 0; i < size; ++i)
+    {
+      base_edge_descriptor e = edgs[i];
+
+      // Store the first copy of the original edge.
+      m_local_vertex.lookup(source(e, *original_graph), sources[i]);
+      m_local_vertex.lookup(target(e, *original_graph), dests[i]);
+
+      // Store the duplicate copy of the original edge.
+      if (is_undirected(*original_graph))
+      {
+        sources[i + size] = sources[i];
+        dests[i + size] = dests[i];
+      }
+      else
+      {
+        sources[i + size] = dests[i];
+        dests[i + size] = sources[i];
+      }
+    }
+
+    // Initialize the duplicate graph.  This is assuming that the init()
+    // method of the underlying graph implements parallelization correctly
+    // and efficiently.
+    init(order, dsize, sources, dests, duplicate_graph);
+
+    #pragma mta assert parallel 
+    for (size_type i = 0; i < dsize; ++i)
+    {
+      if (i < size)
+      {
+        base_edge_descriptor e = edgs[i];
+        m_local_edge.insert(e, i); 
+        m_global_edge[i] = e;
+      }
+      else
+      {
+        m_global_edge[i] = edgs[i - size];
+      }
+    }
+
+    delete [] sources;
+    delete [] dests;
+  }
+
   void deep_copy(const duplicate_adapter& rhs)
   {
     original_graph = rhs.original_graph;
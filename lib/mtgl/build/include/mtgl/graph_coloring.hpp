@@ -0,0 +1,463 @@
+/*  _________________________________________________________________________
+ *
+ *  MTGL: The MultiThreaded Graph Library
+ *  Copyright (c) 2008 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the README file in the top MTGL directory.
+ *  _________________________________________________________________________
+ */
+
+/****************************************************************************/
+/*! \file graph_coloring.hpp
+
+    \brief Parallel distance-1 vertex coloring: Jones and Plassmann, "A
+           Parallel Graph Coloring Heuristic" (SISC 1993), and the
+           speculative greedy coloring of Gebremedhin and Manne (2000) as
+           refined by Catalyurek et al. (Parallel Computing 2012).
+
+    \date 10/17/2026
+
+    The colors are numbered from 0.  The vertices of one color share no
+    edge, so group_by_color() turns a coloring into a schedule of
+    conflict-free phases for kernels that update a vertex and its
+    neighbors.  Edges are treated as undirected.
+*/
+/****************************************************************************/
+
+#ifndef MTGL_GRAPH_COLORING_HPP
+#define MTGL_GRAPH_COLORING_HPP
+
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include <mtgl/util.hpp>
+#include <mtgl/mtgl_adapter.hpp>
+#include <mtgl/independent_set.hpp>
+
+namespace mtgl {
+
+namespace detail {
+
+/// The largest-log-degree-first priority of Hasenplaugh et al., "Ordering
+/// Heuristics for Parallel Graph Coloring" (SPAA 2014): vertices of higher
+/// degree class go first, and random priorities order each class.
+inline unsigned long llf_priority(unsigned long i, unsigned long deg)
+{
+  unsigned long log_deg = 0;
+  while (deg >>= 1) ++log_deg;
+
+  return (log_deg << 57) | (vertex_priority(i) >> 7);
+}
+
+/// Whether w is colored before v, ties going to the larger id.
+inline bool llf_before(unsigned long pw, unsigned long w,
+                       unsigned long pv, unsigned long v)
+{
+  return pw > pv || (pw == pv && w > v);
+}
+
+/// \brief Returns the smallest color not in colors[0..num_colors).  used
+///        is scratch of at least num_colors + 1 entries, all false, and is
+///        left that way.
+template <typename size_type>
+size_type smallest_free_color(const size_type* colors, size_type num_colors,
+                              std::vector<char>& used)
+{
+  for (size_type k = 0; k < num_colors; ++k)
+  {
+    if (colors[k] <= num_colors) used[colors[k]] = 1;
+  }
+
+  size_type c = 0;
+  while (used[c]) ++c;
+
+  for (size_type k = 0; k < num_colors; ++k)
+  {
+    if (colors[k] <= num_colors) used[colors[k]] = 0;
+  }
+
+  return c;
+}
+
+template <typename size_type>
+size_type max_row_length(size_type order, const size_type* offsets)
+{
+  size_type max_deg = 0;
+
+  #pragma mta assert nodep
+  #ifdef _OPENMP
+  #pragma omp parallel for reduction(max:max_deg)
+  #endif
+  for (size_type i = 0; i < order; ++i)
+  {
+    size_type deg = offsets[i + 1] - offsets[i];
+    if (deg > max_deg) max_deg = deg;
+  }
+
+  return max_deg;
+}
+
+}
+
+/*! \brief Colors the graph as the sequential greedy algorithm does when it
+           visits the vertices in largest-log-degree-first order, ties
+           broken at random.
+
+    In each round every uncolored vertex whose higher-priority neighbors
+    are all colored takes the smallest color none of them has.  The rounds
+    only read colors from earlier rounds, so the coloring and the number of
+    rounds do not depend on the number of threads.
+
+    \param g The graph.
+    \param color Set to each vertex's color.
+    \param num_rounds If given, set to the number of rounds taken.
+    \return The number of colors used.
+*/
+template <typename Graph, typename ColorMap>
+typename graph_traits<Graph>::size_type
+jones_plassmann_coloring(
+    Graph& g, ColorMap& color,
+    typename graph_traits<Graph>::size_type* num_rounds = 0)
+{
+  #pragma mta noalias g
+  #pragma mta noalias color
+
+  typedef typename graph_traits<Graph>::size_type size_type;
+  typedef typename graph_traits<Graph>::vertex_iterator vertex_iterator;
+
+  vertex_iterator verts = vertices(g);
+  size_type order = num_vertices(g);
+  size_type uncolored = order;
+
+  size_type* offsets;
+  size_type* adj;
+  detail::undirected_adjacency(g, offsets, adj);
+
+  size_type max_deg = detail::max_row_length(order, offsets);
+
+  size_type* colors = (size_type*) malloc(order * sizeof(size_type));
+  size_type* new_colors = (size_type*) malloc(order * sizeof(size_type));
+  size_type* live = (size_type*) malloc(order * sizeof(size_type));
+  size_type* next = (size_type*) malloc(order * sizeof(size_type));
+  unsigned long* priority =
+    (unsigned long*) malloc(order * sizeof(unsigned long));
+
+  #pragma mta assert nodep
+  #ifdef _OPENMP
+  #pragma omp parallel for
+  #endif
+  for (size_type i = 0; i < order; ++i)
+  {
+    colors[i] = uncolored;
+    live[i] = i;
+    priority[i] = detail::llf_priority(i, offsets[i + 1] - offsets[i]);
+  }
+
+  size_type num_live = order;
+  size_type rounds = 0;
+
+  while (num_live > 0)
+  {
+    ++rounds;
+
+    #ifdef _OPENMP
+    #pragma omp parallel
+    #endif
+    {
+      std::vector<char> used(max_deg + 1, 0);
+      std::vector<size_type> nbr_colors(max_deg);
+
+      #pragma mta assert parallel
+      #ifdef _OPENMP
+      #pragma omp for schedule(dynamic, 1024)
+      #endif
+      for (size_type i = 0; i < num_live; ++i)
+      {
+        size_type v = live[i];
+        unsigned long pv = priority[v];
+        size_type num_nbrs = 0;
+        bool ready = true;
+
+        for (size_type k = offsets[v]; k < offsets[v + 1]; ++k)
+        {
+          size_type w = adj[k];
+          if (w == v || !detail::llf_before(priority[w], w, pv, v)) continue;
+
+          if (colors[w] == uncolored)
+          {
+            ready = false;
+            break;
+          }
+
+          nbr_colors[num_nbrs++] = colors[w];
+        }
+
+        new_colors[v] = ready ?
+          detail::smallest_free_color(&nbr_colors[0], num_nbrs, used) :
+          uncolored;
+      }
+    }
+
+    size_type num_next = 0;
+
+    #pragma mta assert parallel
+    #ifdef _OPENMP
+    #pragma omp parallel for
+    #endif
+    for (size_type i = 0; i < num_live; ++i)
+    {
+      size_type v = live[i];
+      colors[v] = new_colors[v];
+      if (colors[v] == uncolored) next[mt_incr(num_next, 1)] = v;
+    }
+
+    size_type* tmp = live;
+    live = next;
+    next = tmp;
+    num_live = num_next;
+  }
+
+  size_type num_colors = 0;
+
+  #pragma mta assert nodep
+  #ifdef _OPENMP
+  #pragma omp parallel for reduction(max:num_colors)
+  #endif
+  for (size_type i = 0; i < order; ++i)
+  {
+    color[verts[i]] = colors[i];
+    if (colors[i] + 1 > num_colors) num_colors = colors[i] + 1;
+  }
+
+  if (num_rounds) *num_rounds = rounds;
+
+  free(offsets);
+  free(adj);
+  free(colors);
+  free(new_colors);
+  free(live);
+  free(next);
+  free(priority);
+
+  return num_colors;
+}
+
+/*! \brief Colors the graph by speculative greedy coloring.
+
+    Every vertex still to color takes the smallest color that none of its
+    neighbors has at that moment, in parallel and without locks.  Then
+    every vertex that ended up with the same color as a higher-priority
+    neighbor is colored again in the next round.  This usually needs fewer
+    colors and rounds than jones_plassmann_coloring(), but the coloring
+    depends on the thread schedule.
+
+    \param g The graph.
+    \param color Set to each vertex's color.
+    \param num_rounds If given, set to the number of rounds taken.
+    \return The number of colors used.
+*/
+template <typename Graph, typename ColorMap>
+typename graph_traits<Graph>::size_type
+speculative_greedy_coloring(
+    Graph& g, ColorMap& color,
+    typename graph_traits<Graph>::size_type* num_rounds = 0)
+{
+  #pragma mta noalias g
+  #pragma mta noalias color
+
+  typedef typename graph_traits<Graph>::size_type size_type;
+  typedef typename graph_traits<Graph>::vertex_iterator vertex_iterator;
+
+  vertex_iterator verts = vertices(g);
+  size_type order = num_vertices(g);
+  size_type uncolored = order;
+
+  size_type* offsets;
+  size_type* adj;
+  detail::undirected_adjacency(g, offsets, adj);
+
+  size_type max_deg = detail::max_row_length(order, offsets);
+
+  size_type* colors = (size_type*) malloc(order * sizeof(size_type));
+  size_type* live = (size_type*) malloc(order * sizeof(size_type));
+  size_type* next = (size_type*) malloc(order * sizeof(size_type));
+
+  #pragma mta assert nodep
+  #ifdef _OPENMP
+  #pragma omp parallel for
+  #endif
+  for (size_type i = 0; i < order; ++i)
+  {
+    colors[i] = uncolored;
+    live[i] = i;
+  }
+
+  size_type num_live = order;
+  size_type rounds = 0;
+
+  while (num_live > 0)
+  {
+    ++rounds;
+
+    // Tentatively color, reading colors that other threads may be
+    // writing.
+    #ifdef _OPENMP
+    #pragma omp parallel
+    #endif
+    {
+      std::vector<char> used(max_deg + 1, 0);
+      std::vector<size_type> nbr_colors(max_deg);
+
+      #pragma mta assert parallel
+      #ifdef _OPENMP
+      #pragma omp for schedule(dynamic, 1024)
+      #endif
+      for (size_type i = 0; i < num_live; ++i)
+      {
+        size_type v = live[i];
+        size_type num_nbrs = 0;
+
+        for (size_type k = offsets[v]; k < offsets[v + 1]; ++k)
+        {
+          if (adj[k] != v) nbr_colors[num_nbrs++] = colors[adj[k]];
+        }
+
+        colors[v] = detail::smallest_free_color(&nbr_colors[0], num_nbrs,
+                                                used);
+      }
+    }
+
+    // Detect conflicts; the lower-priority end of each is recolored.
+    size_type num_next = 0;
+
+    #pragma mta assert parallel
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 1024)
+    #endif
+    for (size_type i = 0; i < num_live; ++i)
+    {
+      size_type v = live[i];
+      unsigned long pv = detail::vertex_priority(v);
+
+      for (size_type k = offsets[v]; k < offsets[v + 1]; ++k)
+      {
+        size_type w = adj[k];
+
+        if (w != v && colors[w] == colors[v] &&
+            detail::vertex_priority(w) > pv)
+        {
+          next[mt_incr(num_next, 1)] = v;
+          break;
+        }
+      }
+    }
+
+    size_type* tmp = live;
+    live = next;
+    next = tmp;
+    num_live = num_next;
+  }
+
+  size_type num_colors = 0;
+
+  #pragma mta assert nodep
+  #ifdef _OPENMP
+  #pragma omp parallel for reduction(max:num_colors)
+  #endif
+  for (size_type i = 0; i < order; ++i)
+  {
+    color[verts[i]] = colors[i];
+    if (colors[i] + 1 > num_colors) num_colors = colors[i] + 1;
+  }
+
+  if (num_rounds) *num_rounds = rounds;
+
+  free(offsets);
+  free(adj);
+  free(colors);
+  free(live);
+  free(next);
+
+  return num_colors;
+}
+
+/*! \brief Groups the vertex ids by color, for running a kernel one color
+           at a time.
+
+    On return members[starts[c]..starts[c + 1]) holds the ids of the
+    vertices of color c, in increasing order.  starts must have room for
+    num_colors + 1 entries and members for num_vertices(g).
+*/
+template <typename Graph, typename ColorMap>
+void group_by_color(Graph& g, ColorMap& color,
+                    typename graph_traits<Graph>::size_type num_colors,
+                    typename graph_traits<Graph>::size_type* starts,
+                    typename graph_traits<Graph>::size_type* members)
+{
+  typedef typename graph_traits<Graph>::size_type size_type;
+  typedef typename graph_traits<Graph>::vertex_iterator vertex_iterator;
+
+  vertex_iterator verts = vertices(g);
+  size_type order = num_vertices(g);
+
+  for (size_type c = 0; c <= num_colors; ++c) starts[c] = 0;
+  for (size_type i = 0; i < order; ++i) ++starts[color[verts[i]] + 1];
+  for (size_type c = 0; c < num_colors; ++c) starts[c + 1] += starts[c];
+
+  size_type* cursor = (size_type*) malloc(num_colors * sizeof(size_type));
+  for (size_type c = 0; c < num_colors; ++c) cursor[c] = starts[c];
+
+  for (size_type i = 0; i < order; ++i) members[cursor[color[verts[i]]]++] = i;
+
+  free(cursor);
+}
+
+/// \brief Prints up to ten edges whose ends have the same color and returns
+///        the number of such edges.
+template <typename Graph, typename ColorMap>
+typename graph_traits<Graph>::size_type
+validate_coloring(Graph& g, ColorMap& color)
+{
+  typedef typename graph_traits<Graph>::size_type size_type;
+  typedef typename graph_traits<Graph>::vertex_iterator vertex_iterator;
+  typedef typename graph_traits<Graph>::adjacency_iterator adjacency_iterator;
+
+  vertex_id_map<Graph> vid_map = get(_vertex_id_map, g);
+  vertex_iterator verts = vertices(g);
+  size_type order = num_vertices(g);
+
+  const size_type ERRMAX = 10;
+  size_type num_conflicts = 0;
+
+  for (size_type i = 0; i < order; ++i)
+  {
+    size_type deg = out_degree(verts[i], g);
+    adjacency_iterator adjs = adjacent_vertices(verts[i], g);
+
+    for (size_type k = 0; k < deg; ++k)
+    {
+      size_type j = get(vid_map, adjs[k]);
+
+      if (i != j && color[verts[i]] == color[adjs[k]])
+      {
+        if (num_conflicts < ERRMAX)
+        {
+          std::cout << " conflict: " << std::setw(8) << i << "  "
+                    << std::setw(8) << j << std::endl;
+        }
+
+        ++num_conflicts;
+      }
+    }
+  }
+
+  return num_conflicts;
+}
+
+}
+
+#endif
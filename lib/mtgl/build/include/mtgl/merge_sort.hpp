@@ -26,6 +26,7 @@
 #include <functional>
 
 #include <mtgl/util.hpp>
+#include <mtgl/parallel_primitives.hpp>
 
 namespace mtgl {
 
@@ -542,13 +543,37 @@ void merge_sort(T* array, long size, Comparator comp, long block_size = 1024)
   free(new_array);
 }
 
+namespace detail {
+
+template <typename T>
+inline
+void merge_sort_less(T* array, long size, long block_size, radix_key_tag)
+{
+  radix_sort(array, size);
+}
+
+template <typename T>
+inline
+void merge_sort_less(T* array, long size, long block_size, other_key_tag)
+{
+  merge_sort(array, size, std::less<T>(), block_size);
+}
+
+}
+
 /// Allows the merge sort to be called using std::less<T> as the default
-/// comparator.
+/// comparator.  Away from the XMT the merges above run serially, so integer
+/// keys are radix sorted instead, which is stable as well.
 template <typename T>
 inline
 void merge_sort(T* array, long size, long block_size = 1024)
 {
+#ifdef __MTA__
   merge_sort(array, size, std::less<T>(), block_size);
+#else
+  detail::merge_sort_less(array, size, block_size,
+                          typename detail::radix_traits<T>::category());
+#endif
 }
 
 // Same as above function, but an extra N size cost for second array
@@ -1039,11 +1064,36 @@ void merge_sort(T* array, long size, T2* array2, Comparator comp,
   free(new_array2);
 }
 
+namespace detail {
+
+template <typename T, typename T2>
+inline
+void merge_sort_less(T* array, long size, T2* array2, long block_size,
+                     radix_key_tag)
+{
+  radix_sort(array, size, array2);
+}
+
+template <typename T, typename T2>
+inline
+void merge_sort_less(T* array, long size, T2* array2, long block_size,
+                     other_key_tag)
+{
+  merge_sort(array, size, array2, std::less<T>(), block_size);
+}
+
+}
+
 template <typename T, typename T2>
 inline
 void merge_sort(T* array, long size, T2* array2, long block_size = 1024)
 {
+#ifdef __MTA__
   merge_sort(array, size, array2, std::less<T>(), block_size);
+#else
+  detail::merge_sort_less(array, size, array2, block_size,
+                          typename detail::radix_traits<T>::category());
+#endif
 }
 
 }
@@ -81,6 +81,7 @@
 #include <mtgl/mtgl_io.hpp>
 #include <mtgl/generate_rmat_graph.hpp>
 #include <mtgl/generate_erdos_renyi_graph.hpp>
+#include <mtgl/generate_mesh_graph.hpp>
 #include <mtgl/dynamic_array.hpp>
 
 #include <cstring>
@@ -95,15 +96,18 @@
 #define NUM_FILE_ARGS 3
 #define NUM_RMAT_ARGS 4
 #define NUM_ER_ARGS 5
+#define NUM_MESH_ARGS 6
 #elif defined(_OPENMP)
 #include <omp.h>
 #define NUM_FILE_ARGS 3
 #define NUM_RMAT_ARGS 4
 #define NUM_ER_ARGS 5
+#define NUM_MESH_ARGS 6
 #else
 #define NUM_FILE_ARGS 2
 #define NUM_RMAT_ARGS 3
 #define NUM_ER_ARGS 4
+#define NUM_MESH_ARGS 5
 #endif
 
 namespace mtgl {
@@ -130,6 +134,8 @@ void print_test_description()
     "        Generates an Erdos-Renyi graph with n vertices and edge "
     "probability\n"
     "        p.\n\n"
+    "    mesh x y z\n"
+    "        Generates an x by y by z mesh graph.\n\n"
     "FILE FORMATS\n"
     "    '.dimacs'             Indicates the DIMACS format.\n"
     "    '.mtx'                Indicates the MatrixMarket format.\n"
@@ -173,7 +179,8 @@ void init_test(int argc, char* argv[])
   bool arg_error = argc < NUM_FILE_ARGS ? true : false;
 
   if ((!arg_error && strcmp(argv[1], "rmat") == 0 && argc < NUM_RMAT_ARGS) ||
-       (!arg_error && strcmp(argv[1], "er") == 0 && argc < NUM_ER_ARGS))
+       (!arg_error && strcmp(argv[1], "er") == 0 && argc < NUM_ER_ARGS) ||
+       (!arg_error && strcmp(argv[1], "mesh") == 0 && argc < NUM_MESH_ARGS))
   {
     arg_error = true;
   }
@@ -203,6 +210,10 @@ void init_test(int argc, char* argv[])
   {
     nt_pos = 4;
   }
+  else if (strcmp(argv[1], "mesh") == 0)
+  {
+    nt_pos = 5;
+  }
 
 #ifdef USING_QTHREADS
   qthread_init(atoi(argv[nt_pos]));
@@ -243,6 +254,11 @@ void init_test(int argc, char* argv[], int num_ts_args,
     if (argc < NUM_ER_ARGS) arg_error = true;
     num_internal_args = NUM_ER_ARGS;
   }
+  else if (!arg_error && strcmp(argv[1], "mesh") == 0)
+  {
+    if (argc < NUM_MESH_ARGS) arg_error = true;
+    num_internal_args = NUM_MESH_ARGS;
+  }
 
   if (arg_error || argc < num_internal_args + num_ts_args)
   {
@@ -335,6 +351,10 @@ void init_test(int argc, char* argv[], int num_ts_args,
   {
     nt_pos = 4;
   }
+  else if (strcmp(argv[1], "mesh") == 0)
+  {
+    nt_pos = 5;
+  }
 
 #ifdef USING_QTHREADS
   qthread_init(atoi(argv[nt_pos]));
@@ -362,6 +382,10 @@ void create_test_graph(Graph& g, int argc, char* argv[])
   {
     generate_erdos_renyi_graph(g, atoi(argv[2]), atof(argv[3]));
   }
+  else if (strcmp(argv[1], "mesh") == 0)
+  {
+    generate_mesh_graph(g, atoi(argv[2]), atoi(argv[3]), atoi(argv[4]));
+  }
   else if (llen > 3 && strcmp(&argv[1][llen-3], "mtx") == 0)
   {
     // Matrix-market input.
@@ -424,6 +448,10 @@ void create_test_graph(Graph& g, dynamic_array<T>& weights,
   {
     generate_erdos_renyi_graph(g, atoi(argv[2]), atof(argv[3]));
   }
+  else if (strcmp(argv[1], "mesh") == 0)
+  {
+    generate_mesh_graph(g, atoi(argv[2]), atoi(argv[3]), atoi(argv[4]));
+  }
   else if (llen > 3 && strcmp(&argv[1][llen-3], "mtx") == 0)
   {
     // Matrix-market input.
@@ -469,5 +497,6 @@ void create_test_graph(Graph& g, dynamic_array<T>& weights,
 #undef MAX_FORM_DESC_LEN
 #undef NUM_RMAT_ARGS
 #undef NUM_ER_ARGS
+#undef NUM_MESH_ARGS
 
 #endif
@@ -0,0 +1,494 @@
+/*  _________________________________________________________________________
+ *
+ *  MTGL: The MultiThreaded Graph Library
+ *  Copyright (c) 2008 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the README file in the top MTGL directory.
+ *  _________________________________________________________________________
+ */
+
+/****************************************************************************/
+/*! \file multi_source_bfs.hpp
+
+    \brief Runs many breadth first searches at once, after Then et al.,
+           "The More the Merrier: Efficient Multi-Source Graph Traversal"
+           (VLDB 2015), and the eccentricity and closeness computations
+           built on it.
+
+    \date 10/17/2026
+*/
+/****************************************************************************/
+
+#ifndef MTGL_MULTI_SOURCE_BFS_HPP
+#define MTGL_MULTI_SOURCE_BFS_HPP
+
+#include <cstdlib>
+
+#include <mtgl/util.hpp>
+#include <mtgl/mtgl_adapter.hpp>
+#include <mtgl/random.hpp>
+
+#define MSBFS_SPARSE_RATIO 16
+
+namespace mtgl {
+
+namespace detail {
+
+inline void msbfs_or(unsigned long& target, unsigned long bits)
+{
+#ifdef __MTA__
+  unsigned long cur = mt_readfe(target);
+  mt_write(target, cur | bits);
+#elif defined(_OPENMP)
+  __sync_fetch_and_or(&target, bits);
+#else
+  target |= bits;
+#endif
+}
+
+inline int msbfs_popcount(unsigned long bits)
+{
+#ifdef __GNUC__
+  return __builtin_popcountl(bits);
+#else
+  int count = 0;
+  for ( ; bits; bits &= bits - 1) ++count;
+  return count;
+#endif
+}
+
+inline int msbfs_lowest_bit(unsigned long bits)
+{
+#ifdef __GNUC__
+  return __builtin_ctzl(bits);
+#else
+  int i = 0;
+  for ( ; !(bits & 1); bits >>= 1) ++i;
+  return i;
+#endif
+}
+
+}
+
+/*! \brief Breadth first searches from up to 64 * Words sources at once.
+
+    Every vertex holds a bitset with one bit per search for each of the
+    searches that have reached it (seen), that reached it in the last level
+    (visit), and that reach it in the next level (next).  A level pushes the
+    visit bits of every vertex to its neighbors with an atomic OR per
+    neighbor word, so a single pass over the edges advances every search
+    that has that edge in its frontier.  The per-vertex loops over the Words
+    words have a constant trip count, which the compiler unrolls and
+    vectorizes.
+
+    The vertices with a frontier are kept in a list.  While it holds fewer
+    than one in MSBFS_SPARSE_RATIO vertices, a level pushes from the list
+    only and queues the vertices it reaches, so it costs the edges of the
+    frontier rather than a sweep over the graph.  A larger frontier is
+    pushed and settled by sweeping all the vertices.
+
+    After each level visitor(v, bits, level) is called, once and from one
+    thread, for every vertex v that some search reached in that level, with
+    bits[0..Words) marking those searches.  Calls for different vertices run
+    concurrently.
+
+    The object owns the three bitsets, so batches of searches can reuse them.
+*/
+template <typename Graph, int Words = 1>
+class multi_source_bfs {
+public:
+  typedef typename graph_traits<Graph>::size_type size_type;
+  typedef typename graph_traits<Graph>::vertex_iterator vertex_iterator;
+  typedef typename graph_traits<Graph>::adjacency_iterator adjacency_iterator;
+
+  static const int max_sources = 64 * Words;
+
+  multi_source_bfs(Graph& gg) : g(gg), order(num_vertices(gg))
+  {
+    seen = (unsigned long*) malloc(order * Words * sizeof(unsigned long));
+    visit = (unsigned long*) malloc(order * Words * sizeof(unsigned long));
+    next = (unsigned long*) malloc(order * Words * sizeof(unsigned long));
+    front = (size_type*) malloc(order * sizeof(size_type));
+    queue = (size_type*) malloc(order * sizeof(size_type));
+    queued = (size_type*) malloc(order * sizeof(size_type));
+  }
+
+  ~multi_source_bfs()
+  {
+    free(seen);
+    free(visit);
+    free(next);
+    free(front);
+    free(queue);
+    free(queued);
+  }
+
+  /// \brief Searches from sources[0..num_sources), search i starting at the
+  ///        vertex with id sources[i].  Returns the deepest level reached.
+  template <typename Visitor>
+  size_type run(const size_type* sources, int num_sources, Visitor& vis)
+  {
+    #pragma mta noalias *this
+
+    vertex_id_map<Graph> vid_map = get(_vertex_id_map, g);
+    vertex_iterator verts = vertices(g);
+
+    #pragma mta assert nodep
+    #ifdef _OPENMP
+    #pragma omp parallel for
+    #endif
+    for (size_type i = 0; i < order * Words; ++i)
+    {
+      seen[i] = 0;
+      visit[i] = 0;
+      next[i] = 0;
+    }
+
+    #pragma mta assert nodep
+    #ifdef _OPENMP
+    #pragma omp parallel for
+    #endif
+    for (size_type i = 0; i < order; ++i) queued[i] = 0;
+
+    num_front = 0;
+
+    for (int s = 0; s < num_sources; ++s)
+    {
+      seen[sources[s] * Words + s / 64] |= 1UL << (s % 64);
+    }
+
+    for (int s = 0; s < num_sources; ++s)
+    {
+      unsigned long* bits = seen + sources[s] * Words;
+
+      // A vertex that is the source of several searches is visited once.
+      if (!any(visit + sources[s] * Words))
+      {
+        for (int w = 0; w < Words; ++w) visit[sources[s] * Words + w] = bits[w];
+        vis(sources[s], bits, 0);
+        front[num_front++] = sources[s];
+      }
+    }
+
+    size_type level = 0;
+
+    while (num_front > 0)
+    {
+      // A small frontier is pushed from its list, and the vertices it
+      // reaches are queued so that only they are settled.  A large one is
+      // pushed and settled by sweeping all the vertices.
+      bool sparse = num_front * MSBFS_SPARSE_RATIO < order;
+      num_next = 0;
+
+      if (sparse)
+      {
+        #pragma mta assert parallel
+        #ifdef _OPENMP
+        #pragma omp parallel for schedule(dynamic, 64)
+        #endif
+        for (size_type f = 0; f < num_front; ++f)
+        {
+          push(front[f], true, verts, vid_map);
+        }
+      }
+      else
+      {
+        #pragma mta assert parallel
+        #ifdef _OPENMP
+        #pragma omp parallel for schedule(dynamic, 1024)
+        #endif
+        for (size_type i = 0; i < order; ++i)
+        {
+          if (any(visit + i * Words)) push(i, false, verts, vid_map);
+        }
+      }
+
+      ++level;
+
+      if (sparse)
+      {
+        // The old frontier is not swept, so its searches are retired here.
+        #pragma mta assert nodep
+        #ifdef _OPENMP
+        #pragma omp parallel for
+        #endif
+        for (size_type f = 0; f < num_front; ++f)
+        {
+          for (int w = 0; w < Words; ++w) visit[front[f] * Words + w] = 0;
+        }
+
+        num_front = 0;
+
+        #pragma mta assert parallel
+        #ifdef _OPENMP
+        #pragma omp parallel for schedule(dynamic, 1024)
+        #endif
+        for (size_type f = 0; f < num_next; ++f)
+        {
+          size_type i = queue[f];
+          queued[i] = 0;
+          if (settle(i, level, vis)) front[mt_incr(num_front, 1)] = i;
+        }
+      }
+      else
+      {
+        size_type active = 0;
+
+        #pragma mta assert parallel
+        #ifdef _OPENMP
+        #pragma omp parallel for schedule(dynamic, 1024) reduction(+:active)
+        #endif
+        for (size_type i = 0; i < order; ++i)
+        {
+          if (settle(i, level, vis)) ++active;
+        }
+
+        // The list is only needed once the frontier turns small again.
+        num_front = active;
+
+        if (active * MSBFS_SPARSE_RATIO < order)
+        {
+          num_front = 0;
+
+          #pragma mta assert parallel
+          #ifdef _OPENMP
+          #pragma omp parallel for
+          #endif
+          for (size_type i = 0; i < order; ++i)
+          {
+            if (any(visit + i * Words)) front[mt_incr(num_front, 1)] = i;
+          }
+        }
+      }
+    }
+
+    return level - 1;
+  }
+
+private:
+  static bool any(const unsigned long* bits)
+  {
+    unsigned long found = 0;
+    for (int w = 0; w < Words; ++w) found |= bits[w];
+    return found != 0;
+  }
+
+  /// Pushes the searches in vertex i's frontier to its neighbors.  If
+  /// track is set, a neighbor that gains its first next bit is queued.
+  void push(size_type i, bool track, vertex_iterator& verts,
+            vertex_id_map<Graph>& vid_map)
+  {
+    const unsigned long* vi = visit + i * Words;
+    size_type deg = out_degree(verts[i], g);
+    adjacency_iterator adjs = adjacent_vertices(verts[i], g);
+
+    for (size_type k = 0; k < deg; ++k)
+    {
+      size_type j = get(vid_map, adjs[k]);
+      const unsigned long* sj = seen + j * Words;
+      unsigned long* nj = next + j * Words;
+      bool reached = false;
+
+      for (int w = 0; w < Words; ++w)
+      {
+        unsigned long bits = vi[w] & ~sj[w] & ~nj[w];
+
+        if (bits)
+        {
+          detail::msbfs_or(nj[w], bits);
+          reached = true;
+        }
+      }
+
+      if (track && reached && queued[j] == 0 && mt_incr(queued[j], 1) == 0)
+      {
+        queue[mt_incr(num_next, 1)] = j;
+      }
+    }
+  }
+
+  /// Keeps the searches that are new at vertex i and makes them its
+  /// frontier.  Returns whether there are any.
+  template <typename Visitor>
+  bool settle(size_type i, size_type level, Visitor& vis)
+  {
+    unsigned long* si = seen + i * Words;
+    unsigned long* vi = visit + i * Words;
+    unsigned long* ni = next + i * Words;
+    unsigned long found = 0;
+
+    for (int w = 0; w < Words; ++w)
+    {
+      unsigned long bits = ni[w] & ~si[w];
+      si[w] |= bits;
+      vi[w] = bits;
+      ni[w] = 0;
+      found |= bits;
+    }
+
+    if (!found) return false;
+
+    vis(i, vi, level);
+
+    return true;
+  }
+
+  Graph& g;
+  size_type order;
+  unsigned long* seen;
+  unsigned long* visit;
+  unsigned long* next;
+
+  // The vertices with a frontier, and those queued to settle next.
+  size_type* front;
+  size_type* queue;
+  size_type* queued;
+  size_type num_front;
+  size_type num_next;
+};
+
+namespace detail {
+
+/// Records, for every search, the deepest level it reached and a vertex it
+/// reached there.  Every caller in a level writes the same level, and any
+/// of the vertices is a valid farthest vertex, so the stores may race.
+template <typename size_type, int Words>
+class msbfs_eccentricity_visitor {
+public:
+  msbfs_eccentricity_visitor(size_type* e, size_type* f) :
+    ecc(e), farthest(f) {}
+
+  void operator()(size_type v, const unsigned long* bits, size_type level)
+  {
+    for (int w = 0; w < Words; ++w)
+    {
+      for (unsigned long b = bits[w]; b; b &= b - 1)
+      {
+        int s = w * 64 + msbfs_lowest_bit(b);
+        ecc[s] = level;
+        farthest[s] = v;
+      }
+    }
+  }
+
+private:
+  size_type* ecc;
+  size_type* farthest;
+};
+
+/// Sums, for every vertex, the distances from the searches that reach it.
+template <typename size_type, int Words>
+class msbfs_distance_sum_visitor {
+public:
+  msbfs_distance_sum_visitor(size_type* s, size_type* r) :
+    sum(s), reached(r) {}
+
+  void operator()(size_type v, const unsigned long* bits, size_type level)
+  {
+    if (level == 0) return;
+
+    size_type count = 0;
+    for (int w = 0; w < Words; ++w) count += msbfs_popcount(bits[w]);
+
+    sum[v] += count * level;
+    reached[v] += count;
+  }
+
+private:
+  size_type* sum;
+  size_type* reached;
+};
+
+}
+
+/*! \brief Computes the exact eccentricity of the vertices with ids
+           ids[0..num_ids), 256 searches per pass over the edges.
+
+    ecc[i] is the largest distance from ids[i] to a vertex it reaches.  If
+    farthest is given, farthest[i] is the id of a vertex at that distance.
+*/
+template <typename Graph>
+void eccentricity(Graph& g,
+                  const typename graph_traits<Graph>::size_type* ids,
+                  typename graph_traits<Graph>::size_type num_ids,
+                  typename graph_traits<Graph>::size_type* ecc,
+                  typename graph_traits<Graph>::size_type* farthest = 0)
+{
+  typedef typename graph_traits<Graph>::size_type size_type;
+  typedef multi_source_bfs<Graph, 4> msbfs;
+
+  msbfs engine(g);
+  size_type far[msbfs::max_sources];
+
+  for (size_type first = 0; first < num_ids; first += msbfs::max_sources)
+  {
+    int batch = static_cast<int>(num_ids - first < msbfs::max_sources ?
+                                 num_ids - first : msbfs::max_sources);
+
+    detail::msbfs_eccentricity_visitor<size_type, 4> vis(ecc + first, far);
+    engine.run(ids + first, batch, vis);
+
+    if (farthest)
+    {
+      for (int s = 0; s < batch; ++s) farthest[first + s] = far[s];
+    }
+  }
+}
+
+/*! \brief Estimates the closeness centrality of every vertex from
+           num_samples randomly chosen sources, after Eppstein and Wang,
+           "Fast Approximation of Centrality" (SODA 2001).
+
+    closeness[v] is the inverse of v's mean distance from the sampled
+    sources that reach it, other than v itself, or 0 if none do.  On a
+    directed graph that is distance to v along out-edges.  The sources are
+    searched 256 at a time.
+*/
+template <typename Graph>
+void closeness_centrality(Graph& g,
+                          typename graph_traits<Graph>::size_type num_samples,
+                          double* closeness)
+{
+  typedef typename graph_traits<Graph>::size_type size_type;
+  typedef multi_source_bfs<Graph, 4> msbfs;
+
+  size_type order = num_vertices(g);
+  if (order == 0) return;
+
+  size_type* sum = (size_type*) calloc(order, sizeof(size_type));
+  size_type* reached = (size_type*) calloc(order, sizeof(size_type));
+  size_type sources[msbfs::max_sources];
+
+  msbfs engine(g);
+  detail::msbfs_distance_sum_visitor<size_type, 4> vis(sum, reached);
+
+  for (size_type first = 0; first < num_samples; first += msbfs::max_sources)
+  {
+    int batch = static_cast<int>(num_samples - first < msbfs::max_sources ?
+                                 num_samples - first : msbfs::max_sources);
+
+    for (int s = 0; s < batch; ++s) sources[s] = mt_lrand48_64() % order;
+
+    engine.run(sources, batch, vis);
+  }
+
+  #pragma mta assert nodep
+  #ifdef _OPENMP
+  #pragma omp parallel for
+  #endif
+  for (size_type i = 0; i < order; ++i)
+  {
+    closeness[i] = sum[i] ? static_cast<double>(reached[i]) / sum[i] : 0.0;
+  }
+
+  free(sum);
+  free(reached);
+}
+
+}
+
+#undef MSBFS_SPARSE_RATIO
+
+#endif
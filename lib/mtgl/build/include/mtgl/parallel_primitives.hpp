@@ -0,0 +1,572 @@
+/*  _________________________________________________________________________
+ *
+ *  MTGL: The MultiThreaded Graph Library
+ *  Copyright (c) 2008 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the README file in the top MTGL directory.
+ *  _________________________________________________________________________
+ */
+
+/****************************************************************************/
+/*! \file parallel_primitives.hpp
+
+    \brief Blocked prefix sums, stable counting scatter, LSD radix sort, and
+           segmented sort that run in parallel under OpenMP as well as on
+           the XMT.
+
+    \date 10/17/2026
+
+    Every primitive divides its input into one contiguous block per thread
+    (at most), works on the blocks independently, and combines the
+    per-block results with a short scan.  The block loops are annotated for
+    both the XMT and OpenMP, and fall back to a single serial block when
+    the input is small or there is one thread.
+*/
+/****************************************************************************/
+
+#ifndef MTGL_PARALLEL_PRIMITIVES_HPP
+#define MTGL_PARALLEL_PRIMITIVES_HPP
+
+#include <cstdlib>
+#include <algorithm>
+
+#include <mtgl/util.hpp>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define PRIMITIVES_MIN_BLOCK 8192
+#define RADIX_SORT_BITS 8
+#define RADIX_SORT_BUCKETS (1 << RADIX_SORT_BITS)
+#define RADIX_SORT_CUTOFF 64
+#define SEGMENTED_SORT_CUTOFF 65536
+
+namespace mtgl {
+
+namespace detail {
+
+/// Number of blocks for a pass over size elements: one per thread, but no
+/// block smaller than min_block elements.
+inline long primitive_blocks(long size, long min_block)
+{
+#ifdef _OPENMP
+  long blocks = omp_get_max_threads();
+#elif defined(__MTA__)
+  long blocks = 128;
+#else
+  long blocks = 1;
+#endif
+
+  long most = size / min_block;
+  if (most < blocks) blocks = most;
+
+  return blocks > 1 ? blocks : 1;
+}
+
+inline long primitive_block_begin(long size, long block, long blocks)
+{
+  return static_cast<long>((static_cast<double>(size) / blocks) * block);
+}
+
+inline long primitive_block_end(long size, long block, long blocks)
+{
+  return block + 1 < blocks ? primitive_block_begin(size, block + 1, blocks) :
+         size;
+}
+
+template <typename T>
+T prefix_sum(const T* in, T* out, long size, bool inclusive)
+{
+  long blocks = primitive_blocks(size, PRIMITIVES_MIN_BLOCK);
+  T* sums = (T*) malloc((blocks + 1) * sizeof(T));
+
+  #pragma mta assert parallel
+  #ifdef _OPENMP
+  #pragma omp parallel for if (blocks > 1)
+  #endif
+  for (long b = 0; b < blocks; ++b)
+  {
+    long end = primitive_block_end(size, b, blocks);
+    T sum = T();
+
+    for (long i = primitive_block_begin(size, b, blocks); i < end; ++i)
+    {
+      sum += in[i];
+    }
+
+    sums[b + 1] = sum;
+  }
+
+  sums[0] = T();
+  for (long b = 0; b < blocks; ++b) sums[b + 1] += sums[b];
+
+  // Each element is read before it is written, so in may be out.
+  #pragma mta assert parallel
+  #ifdef _OPENMP
+  #pragma omp parallel for if (blocks > 1)
+  #endif
+  for (long b = 0; b < blocks; ++b)
+  {
+    long end = primitive_block_end(size, b, blocks);
+    T sum = sums[b];
+
+    for (long i = primitive_block_begin(size, b, blocks); i < end; ++i)
+    {
+      T value = in[i];
+      if (inclusive) sum += value;
+      out[i] = sum;
+      if (!inclusive) sum += value;
+    }
+  }
+
+  T total = sums[blocks];
+  free(sums);
+
+  return total;
+}
+
+/*! \brief Moves every element i of a size-element input to the position
+           given by move(i, pos), grouped by the bucket bucket_of(i) in
+           [0, num_buckets) and in input order within a bucket.
+
+    Each block counts its elements per bucket, the counts are scanned
+    bucket by bucket and block by block, and each block then places its own
+    elements.  A block's counters are its own, so nothing is atomic.  If
+    bucket_start is given, bucket_start[k] is set to the position of the
+    first element of bucket k, and bucket_start[num_buckets] to size.
+*/
+template <typename Bucket, typename Move>
+void counting_scatter(long size, long num_buckets, long blocks,
+                      const Bucket& bucket_of, const Move& move,
+                      long* bucket_start = 0)
+{
+  long* counts = (long*) calloc(blocks * num_buckets, sizeof(long));
+  long* totals = (long*) malloc(num_buckets * sizeof(long));
+
+  #pragma mta assert parallel
+  #ifdef _OPENMP
+  #pragma omp parallel for if (blocks > 1)
+  #endif
+  for (long b = 0; b < blocks; ++b)
+  {
+    long* count = counts + b * num_buckets;
+    long end = primitive_block_end(size, b, blocks);
+
+    for (long i = primitive_block_begin(size, b, blocks); i < end; ++i)
+    {
+      ++count[bucket_of(i)];
+    }
+  }
+
+  // Turn the counts into each block's offset within each bucket.
+  #pragma mta assert parallel
+  #ifdef _OPENMP
+  #pragma omp parallel for if (blocks > 1)
+  #endif
+  for (long k = 0; k < num_buckets; ++k)
+  {
+    long sum = 0;
+
+    for (long b = 0; b < blocks; ++b)
+    {
+      long count = counts[b * num_buckets + k];
+      counts[b * num_buckets + k] = sum;
+      sum += count;
+    }
+
+    totals[k] = sum;
+  }
+
+  prefix_sum(totals, totals, num_buckets, false);
+
+  if (bucket_start)
+  {
+    #pragma mta assert nodep
+    #ifdef _OPENMP
+    #pragma omp parallel for if (blocks > 1)
+    #endif
+    for (long k = 0; k < num_buckets; ++k) bucket_start[k] = totals[k];
+
+    bucket_start[num_buckets] = size;
+  }
+
+  #pragma mta assert parallel
+  #ifdef _OPENMP
+  #pragma omp parallel for if (blocks > 1)
+  #endif
+  for (long b = 0; b < blocks; ++b)
+  {
+    long* pos = counts + b * num_buckets;
+    long end = primitive_block_end(size, b, blocks);
+
+    for (long k = 0; k < num_buckets; ++k) pos[k] += totals[k];
+
+    for (long i = primitive_block_begin(size, b, blocks); i < end; ++i)
+    {
+      move(i, pos[bucket_of(i)]++);
+    }
+  }
+
+  free(counts);
+  free(totals);
+}
+
+template <typename B>
+class scatter_bucket {
+public:
+  scatter_bucket(const B* b) : bucket(b) {}
+  long operator()(long i) const { return static_cast<long>(bucket[i]); }
+
+private:
+  const B* bucket;
+};
+
+template <typename T>
+class scatter_move {
+public:
+  scatter_move(const T* s, T* d) : src(s), dst(d) {}
+  void operator()(long i, long pos) const { dst[pos] = src[i]; }
+
+private:
+  const T* src;
+  T* dst;
+};
+
+struct radix_key_tag {};
+struct other_key_tag {};
+
+/// Maps the integer types onto unsigned keys in the same order, so radix
+/// sort can take their digits.  Other types are not radix sortable.
+template <typename T>
+struct radix_traits {
+  typedef other_key_tag category;
+};
+
+#define MTGL_RADIX_TRAITS(T, U, FLIP)                                      \
+template <>                                                                \
+struct radix_traits<T> {                                                   \
+  typedef radix_key_tag category;                                          \
+  typedef U key_type;                                                      \
+  static U key(T value) { return static_cast<U>(value) ^ (FLIP); }         \
+};
+
+#define MTGL_RADIX_SIGN(U) (static_cast<U>(1) << (8 * sizeof(U) - 1))
+
+MTGL_RADIX_TRAITS(signed char, unsigned char, MTGL_RADIX_SIGN(unsigned char))
+MTGL_RADIX_TRAITS(unsigned char, unsigned char, 0)
+MTGL_RADIX_TRAITS(short, unsigned short, MTGL_RADIX_SIGN(unsigned short))
+MTGL_RADIX_TRAITS(unsigned short, unsigned short, 0)
+MTGL_RADIX_TRAITS(int, unsigned int, MTGL_RADIX_SIGN(unsigned int))
+MTGL_RADIX_TRAITS(unsigned int, unsigned int, 0)
+MTGL_RADIX_TRAITS(long, unsigned long, MTGL_RADIX_SIGN(unsigned long))
+MTGL_RADIX_TRAITS(unsigned long, unsigned long, 0)
+MTGL_RADIX_TRAITS(long long, unsigned long long,
+                  MTGL_RADIX_SIGN(unsigned long long))
+MTGL_RADIX_TRAITS(unsigned long long, unsigned long long, 0)
+
+#undef MTGL_RADIX_SIGN
+#undef MTGL_RADIX_TRAITS
+
+template <typename T>
+class radix_digit {
+public:
+  typedef typename radix_traits<T>::key_type key_type;
+
+  radix_digit(const T* k, key_type l, int s) : keys(k), low(l), shift(s) {}
+
+  long operator()(long i) const
+  {
+    return static_cast<long>(((radix_traits<T>::key(keys[i]) - low) >>
+                              shift) & (RADIX_SORT_BUCKETS - 1));
+  }
+
+private:
+  const T* keys;
+  key_type low;
+  int shift;
+};
+
+template <typename T, typename T2>
+class radix_move {
+public:
+  radix_move(const T* sk, const T2* sv, T* dk, T2* dv) :
+    src_keys(sk), src_values(sv), dst_keys(dk), dst_values(dv) {}
+
+  void operator()(long i, long pos) const
+  {
+    dst_keys[pos] = src_keys[i];
+    if (dst_values) dst_values[pos] = src_values[i];
+  }
+
+private:
+  const T* src_keys;
+  const T2* src_values;
+  T* dst_keys;
+  T2* dst_values;
+};
+
+template <typename T, typename T2>
+void radix_insertion_sort(T* keys, T2* values, long size)
+{
+  for (long i = 1; i < size; ++i)
+  {
+    T key = keys[i];
+    long j = i;
+
+    if (values)
+    {
+      T2 value = values[i];
+
+      for ( ; j > 0 && key < keys[j - 1]; --j)
+      {
+        keys[j] = keys[j - 1];
+        values[j] = values[j - 1];
+      }
+
+      values[j] = value;
+    }
+    else
+    {
+      for ( ; j > 0 && key < keys[j - 1]; --j) keys[j] = keys[j - 1];
+    }
+
+    keys[j] = key;
+  }
+}
+
+/// Sorts keys, and values along with them if values is not null, in
+/// blocks blocks.  Only the digits in which the keys differ are sorted:
+/// the keys are offset by the smallest one, and the passes stop at the
+/// highest digit of the largest difference.
+template <typename T, typename T2>
+void radix_sort_blocks(T* keys, T2* values, long size, long blocks)
+{
+  typedef typename radix_traits<T>::key_type key_type;
+
+  if (size <= RADIX_SORT_CUTOFF)
+  {
+    radix_insertion_sort(keys, values, size);
+    return;
+  }
+
+  key_type* lows = (key_type*) malloc(blocks * sizeof(key_type));
+  key_type* highs = (key_type*) malloc(blocks * sizeof(key_type));
+
+  #pragma mta assert parallel
+  #ifdef _OPENMP
+  #pragma omp parallel for if (blocks > 1)
+  #endif
+  for (long b = 0; b < blocks; ++b)
+  {
+    long begin = primitive_block_begin(size, b, blocks);
+    long end = primitive_block_end(size, b, blocks);
+    key_type low = radix_traits<T>::key(keys[begin]);
+    key_type high = low;
+
+    for (long i = begin + 1; i < end; ++i)
+    {
+      key_type key = radix_traits<T>::key(keys[i]);
+      if (key < low) low = key;
+      if (key > high) high = key;
+    }
+
+    lows[b] = low;
+    highs[b] = high;
+  }
+
+  key_type low = lows[0];
+  key_type high = highs[0];
+
+  for (long b = 1; b < blocks; ++b)
+  {
+    if (lows[b] < low) low = lows[b];
+    if (highs[b] > high) high = highs[b];
+  }
+
+  free(lows);
+  free(highs);
+
+  int passes = 0;
+  for (key_type range = high - low; range != 0; range >>= RADIX_SORT_BITS)
+  {
+    ++passes;
+  }
+
+  T* src_keys = keys;
+  T2* src_values = values;
+  T* dst_keys = (T*) malloc(size * sizeof(T));
+  T2* dst_values = values ? (T2*) malloc(size * sizeof(T2)) : 0;
+
+  for (int p = 0; p < passes; ++p)
+  {
+    radix_digit<T> digit(src_keys, low, p * RADIX_SORT_BITS);
+    radix_move<T, T2> move(src_keys, src_values, dst_keys, dst_values);
+    counting_scatter(size, RADIX_SORT_BUCKETS, blocks, digit, move);
+
+    std::swap(src_keys, dst_keys);
+    std::swap(src_values, dst_values);
+  }
+
+  if (src_keys != keys)
+  {
+    #pragma mta assert nodep
+    #ifdef _OPENMP
+    #pragma omp parallel for if (blocks > 1)
+    #endif
+    for (long i = 0; i < size; ++i)
+    {
+      keys[i] = src_keys[i];
+      if (values) values[i] = src_values[i];
+    }
+  }
+
+  free(src_keys == keys ? dst_keys : src_keys);
+  free(src_values == values ? dst_values : src_values);
+}
+
+template <typename T, typename T2, typename S>
+void segmented_sort(const S* offsets, S num_segments, T* keys, T2* values)
+{
+  S* large = (S*) malloc(num_segments * sizeof(S));
+  S num_large = 0;
+
+  #pragma mta assert parallel
+  #ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic, 64)
+  #endif
+  for (S i = 0; i < num_segments; ++i)
+  {
+    long begin = static_cast<long>(offsets[i]);
+    long len = static_cast<long>(offsets[i + 1]) - begin;
+
+    if (len > SEGMENTED_SORT_CUTOFF)
+    {
+      large[mt_incr(num_large, 1)] = i;
+    }
+    else if (len > 1)
+    {
+      radix_sort_blocks(keys + begin, values ? values + begin : values, len,
+                        1);
+    }
+  }
+
+  // The few long segments are each sorted by all the threads.
+  for (S j = 0; j < num_large; ++j)
+  {
+    long begin = static_cast<long>(offsets[large[j]]);
+    long len = static_cast<long>(offsets[large[j] + 1]) - begin;
+
+    radix_sort_blocks(keys + begin, values ? values + begin : values, len,
+                      primitive_blocks(len, PRIMITIVES_MIN_BLOCK));
+  }
+
+  free(large);
+}
+
+}
+
+/*! \brief Sets out[i] to the sum of in[0..i), and returns the sum of all
+           size elements.  in and out may be the same array.
+*/
+template <typename T>
+inline
+T exclusive_prefix_sum(const T* in, T* out, long size)
+{
+  return detail::prefix_sum(in, out, size, false);
+}
+
+/*! \brief Sets out[i] to the sum of in[0..i], and returns the sum of all
+           size elements.  in and out may be the same array.
+*/
+template <typename T>
+inline
+T inclusive_prefix_sum(const T* in, T* out, long size)
+{
+  return detail::prefix_sum(in, out, size, true);
+}
+
+/*! \brief Copies src[0..size) to dst grouped by bucket[i], which must be in
+           [0, num_buckets), keeping the input order within each bucket.
+
+    If bucket_start is given it must hold num_buckets + 1 entries, and
+    bucket k is left in dst[bucket_start[k]..bucket_start[k + 1]).  Each
+    thread keeps num_buckets counters, so the number of threads used is
+    limited to size / num_buckets.
+*/
+template <typename T, typename B>
+void stable_scatter(const T* src, const B* bucket, long size,
+                    long num_buckets, T* dst, long* bucket_start = 0)
+{
+  long min_block = num_buckets > PRIMITIVES_MIN_BLOCK ? num_buckets :
+                   PRIMITIVES_MIN_BLOCK;
+
+  detail::scatter_bucket<B> bucket_of(bucket);
+  detail::scatter_move<T> move(src, dst);
+  detail::counting_scatter(size, num_buckets, detail::primitive_blocks(size,
+                           min_block), bucket_of, move, bucket_start);
+}
+
+/*! \brief Sorts an array of integer keys with a stable LSD radix sort.
+
+    Running time: O(n * d / p), where d is the number of 8-bit digits in
+    the difference between the largest and smallest key.
+    Space utilized: n + 256 p words.
+*/
+template <typename T>
+inline
+void radix_sort(T* keys, long size)
+{
+  detail::radix_sort_blocks(keys, static_cast<char*>(0), size,
+                            detail::primitive_blocks(size,
+                                                     PRIMITIVES_MIN_BLOCK));
+}
+
+/*! \brief Sorts an array of integer keys, moving values[i] along with
+           keys[i].  Keys that are equal keep their order.
+*/
+template <typename T, typename T2>
+inline
+void radix_sort(T* keys, long size, T2* values)
+{
+  detail::radix_sort_blocks(keys, values, size,
+                            detail::primitive_blocks(size,
+                                                     PRIMITIVES_MIN_BLOCK));
+}
+
+/*! \brief Sorts each of the segments keys[offsets[i]..offsets[i + 1]) of an
+           array of integer keys, for i in [0, num_segments).
+
+    This is the per-vertex sort of a CSR adjacency.  Segments are sorted
+    serially, many at once, and segments longer than SEGMENTED_SORT_CUTOFF
+    are afterwards sorted one at a time by all threads, so a few
+    high-degree vertices do not leave the other threads idle.
+*/
+template <typename T, typename S>
+inline
+void segmented_sort(const S* offsets, S num_segments, T* keys)
+{
+  detail::segmented_sort(offsets, num_segments, keys, static_cast<char*>(0));
+}
+
+/*! \brief Sorts each segment of keys as above, moving values[j] along with
+           keys[j].
+*/
+template <typename T, typename T2, typename S>
+inline
+void segmented_sort(const S* offsets, S num_segments, T* keys, T2* values)
+{
+  detail::segmented_sort(offsets, num_segments, keys, values);
+}
+
+}
+
+#undef PRIMITIVES_MIN_BLOCK
+#undef RADIX_SORT_BITS
+#undef RADIX_SORT_BUCKETS
+#undef RADIX_SORT_CUTOFF
+#undef SEGMENTED_SORT_CUTOFF
+
+#endif
@@ -134,6 +134,7 @@
 #include <cstddef>
 
 #include <mtgl/graph_traits.hpp>
+#include <mtgl/parallel_primitives.hpp>
 
 namespace mtgl {
 
@@ -454,7 +455,7 @@ void accumulate_out_degree(T* accum_deg, Graph& g)
   }
 #endif
 
-  for (size_type i = 1; i <= order; ++i) accum_deg[i] += accum_deg[i - 1];
+  inclusive_prefix_sum(accum_deg + 1, accum_deg + 1, order);
 }
 
 /*! \brief Creates an accumulation array of the out degree of the vertices
@@ -493,7 +494,7 @@ accumulate_out_degree(T* accum_deg,
   }
 #endif
 
-  for (T2 i = 1; i <= vlist_size; ++i) accum_deg[i] += accum_deg[i - 1];
+  inclusive_prefix_sum(accum_deg + 1, accum_deg + 1, vlist_size);
 }
 
 /*! \brief Creates an accumulation array of the in degree of all the vertices
@@ -543,7 +544,7 @@ void accumulate_in_degree(T* accum_deg, Graph& g)
   }
 #endif
 
-  for (size_type i = 1; i <= order; ++i) accum_deg[i] += accum_deg[i - 1];
+  inclusive_prefix_sum(accum_deg + 1, accum_deg + 1, order);
 }
 
 /*! \brief Creates an accumulation array of the in degree of the vertices
@@ -582,7 +583,7 @@ accumulate_in_degree(T* accum_deg,
   }
 #endif
 
-  for (T2 i = 1; i <= vlist_size; ++i) accum_deg[i] += accum_deg[i - 1];
+  inclusive_prefix_sum(accum_deg + 1, accum_deg + 1, vlist_size);
 }
 
 }
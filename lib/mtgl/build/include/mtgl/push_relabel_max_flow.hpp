@@ -0,0 +1,473 @@
+/*  _________________________________________________________________________
+ *
+ *  MTGL: The MultiThreaded Graph Library
+ *  Copyright (c) 2008 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the README file in the top MTGL directory.
+ *  _________________________________________________________________________
+ */
+
+/****************************************************************************/
+/*! \file push_relabel_max_flow.hpp
+
+    \brief Maximum flow and minimum cut by synchronous parallel push-relabel,
+           after Baumstark, Blelloch and Shun, "Efficient Implementation of
+           a Synchronous Parallel Push-Relabel Algorithm" (ESA 2015).
+
+    \date 10/17/2026
+*/
+/****************************************************************************/
+
+#ifndef MTGL_PUSH_RELABEL_MAX_FLOW_HPP
+#define MTGL_PUSH_RELABEL_MAX_FLOW_HPP
+
+#include <cstdlib>
+
+#include <mtgl/util.hpp>
+#include <mtgl/mtgl_adapter.hpp>
+
+#define PUSH_RELABEL_ALPHA 6
+#define PUSH_RELABEL_BETA 12
+
+namespace mtgl {
+
+namespace detail {
+
+template <typename T>
+inline bool push_relabel_cas(T& target, T oldval, T newval)
+{
+#ifdef __MTA__
+  T cur = mt_readfe(target);
+  bool swapped = cur == oldval;
+  mt_write(target, swapped ? newval : cur);
+  return swapped;
+#elif defined(_OPENMP)
+  return __sync_bool_compare_and_swap(&target, oldval, newval);
+#else
+  if (target != oldval) return false;
+  target = newval;
+  return true;
+#endif
+}
+
+/*! \brief The residual graph and the preflow state of a push-relabel run.
+
+    The residual graph is a CSR over vertex ids holding both arcs of every
+    edge: u->v with the edge's capacity and v->u with none (or the same
+    capacity if the graph is undirected).  rev[k] is the index of arc k's
+    reverse.
+*/
+template <typename size_type, typename FlowType>
+class push_relabel {
+public:
+  push_relabel(size_type n, size_type s, size_type t) :
+    order(n), src(s), sink(t)
+  {
+    offsets = (size_type*) calloc(order + 1, sizeof(size_type));
+    label = (size_type*) malloc(order * sizeof(size_type));
+    new_label = (size_type*) malloc(order * sizeof(size_type));
+    excess = (FlowType*) calloc(order, sizeof(FlowType));
+    added = (FlowType*) calloc(order, sizeof(FlowType));
+    discovered = (size_type*) calloc(order, sizeof(size_type));
+    active = (size_type*) malloc(order * sizeof(size_type));
+    next = (size_type*) malloc(order * sizeof(size_type));
+    dests = 0;
+    rev = 0;
+    cap = 0;
+  }
+
+  ~push_relabel()
+  {
+    free(offsets);
+    free(dests);
+    free(rev);
+    free(cap);
+    free(label);
+    free(new_label);
+    free(excess);
+    free(added);
+    free(discovered);
+    free(active);
+    free(next);
+  }
+
+  /// Builds the residual graph from the size edges (srcs[i], dests[i]).
+  void init_arcs(size_type size, const size_type* srcs,
+                 const size_type* trgs, const FlowType* capacity,
+                 bool undirected)
+  {
+    size_type* cursor = (size_type*) calloc(order, sizeof(size_type));
+
+    #pragma mta assert nodep
+    #ifdef _OPENMP
+    #pragma omp parallel for
+    #endif
+    for (size_type i = 0; i < size; ++i)
+    {
+      if (srcs[i] == trgs[i]) continue;
+      mt_incr(cursor[srcs[i]], 1);
+      mt_incr(cursor[trgs[i]], 1);
+    }
+
+    for (size_type i = 0; i < order; ++i)
+    {
+      offsets[i + 1] = offsets[i] + cursor[i];
+      cursor[i] = offsets[i];
+    }
+
+    size_type num_arcs = offsets[order];
+    dests = (size_type*) malloc(num_arcs * sizeof(size_type));
+    rev = (size_type*) malloc(num_arcs * sizeof(size_type));
+    cap = (FlowType*) malloc(num_arcs * sizeof(FlowType));
+
+    #pragma mta assert nodep
+    #ifdef _OPENMP
+    #pragma omp parallel for
+    #endif
+    for (size_type i = 0; i < size; ++i)
+    {
+      size_type u = srcs[i];
+      size_type v = trgs[i];
+      if (u == v) continue;
+
+      size_type a = mt_incr(cursor[u], 1);
+      size_type b = mt_incr(cursor[v], 1);
+
+      dests[a] = v;
+      rev[a] = b;
+      cap[a] = capacity[i];
+
+      dests[b] = u;
+      rev[b] = a;
+      cap[b] = undirected ? capacity[i] : 0;
+    }
+
+    free(cursor);
+  }
+
+  /// Runs until no vertex that can reach the sink holds excess.  Returns
+  /// the flow into the sink.
+  FlowType run()
+  {
+    #pragma mta noalias *this
+
+    size_type num_arcs = offsets[order];
+    size_type threshold = PUSH_RELABEL_ALPHA * order + num_arcs;
+
+    // Saturate the arcs out of the source.
+    for (size_type k = offsets[src]; k < offsets[src + 1]; ++k)
+    {
+      FlowType delta = cap[k];
+      if (delta <= 0) continue;
+
+      cap[k] = 0;
+      cap[rev[k]] += delta;
+      excess[dests[k]] += delta;
+    }
+
+    size_type num_active = global_relabel();
+    size_type work = 0;
+
+    while (num_active > 0)
+    {
+      if (work > threshold)
+      {
+        num_active = global_relabel();
+        work = 0;
+        continue;
+      }
+
+      size_type num_next = 0;
+
+      // Discharge every active vertex against the labels and excesses of
+      // the previous round.  A push along an arc that is admissible from
+      // both ends is made only by the endpoint that wins the tie-break.
+      #pragma mta assert parallel
+      #ifdef _OPENMP
+      #pragma omp parallel for schedule(dynamic, 64) reduction(+:work)
+      #endif
+      for (size_type i = 0; i < num_active; ++i)
+      {
+        size_type v = active[i];
+        size_type d = label[v];
+        FlowType e = excess[v];
+
+        work += offsets[v + 1] - offsets[v] + PUSH_RELABEL_BETA;
+
+        while (e > 0)
+        {
+          size_type lowest = order;
+          bool skipped = false;
+
+          for (size_type k = offsets[v]; k < offsets[v + 1] && e > 0; ++k)
+          {
+            size_type w = dests[k];
+            bool admissible = d == label[w] + 1;
+
+            if (admissible && excess[w] > 0 && !wins(v, w))
+            {
+              skipped = true;
+              continue;
+            }
+
+            if (admissible && cap[k] > 0)
+            {
+              FlowType delta = cap[k] < e ? cap[k] : e;
+
+              mt_incr(cap[k], -delta);
+              mt_incr(cap[rev[k]], delta);
+              mt_incr(added[w], delta);
+              e -= delta;
+
+              if (w != src && w != sink && mt_incr(discovered[w], 1) == 0)
+              {
+                next[mt_incr(num_next, 1)] = w;
+              }
+            }
+
+            if (cap[k] > 0 && label[w] >= d && label[w] + 1 < lowest)
+            {
+              lowest = label[w] + 1;
+            }
+          }
+
+          if (e == 0 || skipped) break;
+
+          // Relabel.
+          d = lowest;
+          if (d >= order) break;
+        }
+
+        new_label[v] = d;
+        mt_incr(added[v], e - excess[v]);
+
+        if (e > 0 && d < order && mt_incr(discovered[v], 1) == 0)
+        {
+          next[mt_incr(num_next, 1)] = v;
+        }
+      }
+
+      // Apply the round: the new labels, then the excess moved into each
+      // vertex that was discharged or received flow.
+      #pragma mta assert nodep
+      #ifdef _OPENMP
+      #pragma omp parallel for
+      #endif
+      for (size_type i = 0; i < num_active; ++i)
+      {
+        size_type v = active[i];
+        label[v] = new_label[v];
+        excess[v] += added[v];
+        added[v] = 0;
+      }
+
+      #pragma mta assert nodep
+      #ifdef _OPENMP
+      #pragma omp parallel for
+      #endif
+      for (size_type i = 0; i < num_next; ++i)
+      {
+        size_type v = next[i];
+        excess[v] += added[v];
+        added[v] = 0;
+        discovered[v] = 0;
+      }
+
+      size_type* tmp = active;
+      active = next;
+      next = tmp;
+      num_active = num_next;
+    }
+
+    return excess[sink] + added[sink];
+  }
+
+  /*! \brief Sets every label to the residual distance to the sink, or to
+             order if the sink is unreachable, by a parallel breadth first
+             search backwards along arcs with residual capacity.
+
+      Lifting all the vertices cut off from the sink at once is the gap
+      heuristic in global form.  Returns the number of vertices left
+      active, which are put in active.
+  */
+  size_type global_relabel()
+  {
+    #pragma mta assert nodep
+    #ifdef _OPENMP
+    #pragma omp parallel for
+    #endif
+    for (size_type i = 0; i < order; ++i) label[i] = order;
+
+    label[sink] = 0;
+    next[0] = sink;
+
+    size_type head = 0;
+    size_type tail = 1;
+
+    while (head < tail)
+    {
+      size_type level_end = tail;
+
+      #pragma mta assert parallel
+      #ifdef _OPENMP
+      #pragma omp parallel for schedule(dynamic, 64)
+      #endif
+      for (size_type i = head; i < level_end; ++i)
+      {
+        size_type v = next[i];
+        size_type d = label[v] + 1;
+
+        for (size_type k = offsets[v]; k < offsets[v + 1]; ++k)
+        {
+          size_type w = dests[k];
+
+          if (w != src && cap[rev[k]] > 0 && label[w] == order &&
+              detail::push_relabel_cas(label[w], order, d))
+          {
+            next[mt_incr(tail, 1)] = w;
+          }
+        }
+      }
+
+      head = level_end;
+    }
+
+    size_type num_active = 0;
+
+    #pragma mta assert parallel
+    #ifdef _OPENMP
+    #pragma omp parallel for
+    #endif
+    for (size_type i = 0; i < order; ++i)
+    {
+      if (i != src && i != sink && excess[i] > 0 && label[i] < order)
+      {
+        active[mt_incr(num_active, 1)] = i;
+      }
+    }
+
+    return num_active;
+  }
+
+  /// True for the vertices that cannot reach the sink in the residual
+  /// graph.  Valid after global_relabel().
+  bool on_source_side(size_type v) const { return label[v] >= order; }
+
+private:
+  bool wins(size_type v, size_type w) const
+  {
+    return label[v] == label[w] + 1 || label[v] + 1 < label[w] ||
+           (label[v] == label[w] && v < w);
+  }
+
+  size_type order;
+  size_type src;
+  size_type sink;
+  size_type* offsets;
+  size_type* dests;
+  size_type* rev;
+  FlowType* cap;
+  size_type* label;
+  size_type* new_label;
+  FlowType* excess;
+  FlowType* added;
+  size_type* discovered;
+  size_type* active;
+  size_type* next;
+};
+
+}
+
+/*! \brief Computes the maximum flow from s to t with parallel push-relabel.
+
+    \param g The graph.
+    \param s The source.
+    \param t The sink.
+    \param capacity The capacity of each edge, indexed by edge id as for
+                    edmonds_karp_max_flow().  On an undirected graph an
+                    edge's capacity applies in both directions.
+    \param source_side If given, source_side[i] is set to true for the
+                       vertices with id i on the source side of a minimum
+                       cut: those that cannot reach t in the final residual
+                       graph.
+
+    Every round discharges all the active vertices at once, and the labels
+    are recomputed exactly by a global relabel whenever the work since the
+    last one exceeds 6n + m.  Only the first phase of push-relabel is run,
+    as it already gives the flow value and the cut; excess that cannot
+    reach t is not returned to s.
+*/
+template <typename Graph, typename FlowType>
+FlowType
+push_relabel_max_flow(Graph& g,
+                      typename graph_traits<Graph>::vertex_descriptor s,
+                      typename graph_traits<Graph>::vertex_descriptor t,
+                      FlowType* capacity, bool* source_side = 0)
+{
+  #pragma mta noalias g
+  #pragma mta noalias *capacity
+
+  typedef typename graph_traits<Graph>::size_type size_type;
+  typedef typename graph_traits<Graph>::edge_descriptor edge_descriptor;
+  typedef typename graph_traits<Graph>::edge_iterator edge_iterator;
+
+  vertex_id_map<Graph> vid_map = get(_vertex_id_map, g);
+  edge_id_map<Graph> eid_map = get(_edge_id_map, g);
+
+  size_type order = num_vertices(g);
+  size_type size = num_edges(g);
+  size_type src_id = get(vid_map, s);
+  size_type sink_id = get(vid_map, t);
+
+  if (src_id == sink_id) return static_cast<FlowType>(0);
+
+  size_type* srcs = (size_type*) malloc(size * sizeof(size_type));
+  size_type* trgs = (size_type*) malloc(size * sizeof(size_type));
+
+  edge_iterator edgs = edges(g);
+
+  #pragma mta assert nodep
+  #ifdef _OPENMP
+  #pragma omp parallel for
+  #endif
+  for (size_type i = 0; i < size; ++i)
+  {
+    edge_descriptor e = edgs[i];
+    size_type eid = get(eid_map, e);
+    srcs[eid] = get(vid_map, source(e, g));
+    trgs[eid] = get(vid_map, target(e, g));
+  }
+
+  detail::push_relabel<size_type, FlowType> pr(order, src_id, sink_id);
+  pr.init_arcs(size, srcs, trgs, capacity, is_undirected(g));
+
+  free(srcs);
+  free(trgs);
+
+  FlowType flow = pr.run();
+
+  if (source_side)
+  {
+    pr.global_relabel();
+
+    #pragma mta assert nodep
+    #ifdef _OPENMP
+    #pragma omp parallel for
+    #endif
+    for (size_type i = 0; i < order; ++i)
+    {
+      source_side[i] = pr.on_source_side(i);
+    }
+  }
+
+  return flow;
+}
+
+}
+
+#undef PUSH_RELABEL_ALPHA
+#undef PUSH_RELABEL_BETA
+
+#endif
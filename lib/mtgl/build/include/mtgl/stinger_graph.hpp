@@ -430,6 +430,129 @@ public:
     free(etype_block_counts);
   }
 
+  /// \brief Inserts the edges from compressed sparse row arrays.
+  ///
+  /// Equivalent to init_edges() with edge i running from the vertex whose
+  /// row holds position i to dests[i].  Each vertex's edge blocks are laid
+  /// out by prefix sums over the per-vertex block counts, and a vertex's row
+  /// is placed into its own blocks by one thread, so only the in-degrees
+  /// need atomic updates.
+  #pragma mta no inline
+  void init_edges_csr(l_vertex_t* offsets, l_vertex_t* dests,
+                      etype_t* types, eweight_t* weights)
+  {
+    #pragma mta noalias *offsets
+    #pragma mta noalias *dests
+    #pragma mta noalias *types
+    #pragma mta noalias *weights
+
+    size_type n = n_vertices;
+    size_type net = n_etypes;
+    size_type m = offsets[n];
+
+    n_edges = m;
+
+    // The number of edges of each type in each vertex's row, turned into a
+    // number of edge blocks.
+    size_type total_vtypes = n * net;
+    size_type* vertex_eblock_counts =
+      (size_type*) calloc(total_vtypes, sizeof(size_type));
+
+    #pragma mta assert parallel
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 1024)
+    #endif
+    for (size_type i = 0; i < n; ++i)
+    {
+      size_type* counts = vertex_eblock_counts + i * net;
+
+      for (l_vertex_t j = offsets[i]; j < offsets[i + 1]; ++j) ++counts[types[j]];
+      for (size_type t = 0; t < net; ++t)
+      {
+        counts[t] = (counts[t] + EDGES_IN_BLOCK - 1) / EDGES_IN_BLOCK;
+      }
+
+      vertices[i].out_deg = offsets[i + 1] - offsets[i];
+    }
+
+    // Prefix sums give each (vertex, type) pair the position of its first
+    // block in edge_blocks and in the edge type's block array.
+    size_type* block_start =
+      (size_type*) malloc(sizeof(size_type) * total_vtypes);
+    size_type* etype_start =
+      (size_type*) malloc(sizeof(size_type) * total_vtypes);
+    size_type* etype_block_counts =
+      (size_type*) calloc(net, sizeof(size_type));
+    size_type total_edge_blocks = 0;
+
+    for (size_type i = 0; i < total_vtypes; ++i)
+    {
+      block_start[i] = total_edge_blocks;
+      etype_start[i] = etype_block_counts[i % net];
+      etype_block_counts[i % net] += vertex_eblock_counts[i];
+      total_edge_blocks += vertex_eblock_counts[i];
+    }
+
+    #pragma mta assert par_newdelete
+    edge_types = new etype_entry_t[net];
+
+    #pragma mta assert nodep
+    for (size_type i = 0; i < net; ++i)
+    {
+      edge_types[i].num_blocks = etype_block_counts[i];
+      edge_types[i].edge_blocks =
+        (edge_block_t**) malloc(sizeof(edge_block_t*) * etype_block_counts[i]);
+    }
+
+    edge_blocks =
+      (edge_block_t*) malloc(total_edge_blocks * sizeof(edge_block_t));
+
+    // Create and link each vertex's edge blocks, then fill them from its row.
+    #pragma mta assert parallel
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 1024)
+    #endif
+    for (size_type i = 0; i < n; ++i)
+    {
+      edge_block_t** cur = &(vertices[i].edge_blocks);
+
+      for (size_type t = 0; t < net; ++t)
+      {
+        size_type entry = i * net + t;
+
+        for (size_type k = 0; k < vertex_eblock_counts[entry]; ++k)
+        {
+          *cur = new(edge_blocks + block_start[entry] + k) edge_block_t(t, i);
+          edge_types[t].edge_blocks[etype_start[entry] + k] = *cur;
+          cur = &((*cur)->next);
+        }
+      }
+
+      // Reuse the vertex's block counts as its running edge count per type.
+      size_type* filled = vertex_eblock_counts + i * net;
+      for (size_type t = 0; t < net; ++t) filled[t] = 0;
+
+      for (l_vertex_t j = offsets[i]; j < offsets[i + 1]; ++j)
+      {
+        size_type c = filled[types[j]]++;
+        edge_block_t* blk =
+          edge_blocks + block_start[i * net + types[j]] + c / EDGES_IN_BLOCK;
+        size_type slot = c % EDGES_IN_BLOCK;
+
+        blk->edges[slot].to_id = dests[j];
+        blk->edges[slot].weight = weights[j];
+        blk->num_edges = slot + 1;
+
+        mt_incr(vertices[dests[j]].in_deg, 1);
+      }
+    }
+
+    free(block_start);
+    free(etype_start);
+    free(vertex_eblock_counts);
+    free(etype_block_counts);
+  }
+
   vertex_t& get_vertex(l_vertex_t v) const { return vertices[v]; }
 
   size_type num_edges() const { return n_edges; }
@@ -30,6 +30,11 @@
     corresponds to vertex 82 in the transposed graph.  The same is true of the
     edges.  Thus, the associations don't have to be explicitly stored.
 
+    The transpose of a directed graph is built from its out-edges with
+    transpose_csr() from csr_transpose.hpp, which scatters the edges in
+    parallel without building an edge list first.  This relies on the edge
+    ids of the original graph running from 0 to num_edges() - 1.
+
     Note that a transpose only has meaning for a directed graph.  The
     transpose of an undirected graph gives you back the original graph.  The
     adapter allows you to take the transpose of an undirected graph, but it
@@ -45,6 +50,8 @@
 
 #include <mtgl/mtgl_adapter.hpp>
 #include <mtgl/compressed_sparse_row_graph.hpp>
+#include <mtgl/partitioning.hpp>
+#include <mtgl/csr_transpose.hpp>
 
 namespace mtgl {
 
@@ -79,6 +86,86 @@ public:
   typedef typename traits::iterator_category iterator_category;
 
   transpose_adapter(graph_adapter& g) : original_graph(&g)
+  {
+    init_transpose(base_directed_category());
+  }
+
+  // The compiler-synthesized copy control works fine for this class, so we
+  // don't implement it ourselves.  We assume that the graph adapter passed
+  // as a template parameter has a correctly implemented deep copy which makes
+  // the transpose adapter perform a deep copy.
+
+  const wrapper_adapter& get_adapter() const { return transpose_graph; }
+
+  void print() { transpose_graph.print(); }
+
+private:
+  // A directed graph is transposed straight from its out-edges by a
+  // counting scatter, so the transpose is built in parallel without an
+  // edge list and the edge ids carry over.
+  void init_transpose(directedS)
+  {
+    typedef typename base_traits::vertex_iterator base_vertex_iterator;
+    typedef typename base_traits::out_edge_iterator base_out_edge_iterator;
+
+    size_type order = num_vertices(*original_graph);
+    size_type size = num_edges(*original_graph);
+
+    vertex_id_map<graph_adapter> vid_map = get(_vertex_id_map, *original_graph);
+    edge_id_map<graph_adapter> eid_map = get(_edge_id_map, *original_graph);
+    base_vertex_iterator verts = vertices(*original_graph);
+
+    size_type* offsets = (size_type*) malloc((order + 1) * sizeof(size_type));
+    size_type* adj = (size_type*) malloc(size * sizeof(size_type));
+    size_type* ids = (size_type*) malloc(size * sizeof(size_type));
+
+    accumulate_out_degree(offsets, *original_graph);
+
+    #pragma mta assert parallel
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 1024)
+    #endif
+    for (size_type i = 0; i < order; ++i)
+    {
+      base_out_edge_iterator edgs = out_edges(verts[i], *original_graph);
+      size_type begin = offsets[i];
+      size_type end = offsets[i + 1];
+
+      for (size_type k = begin; k < end; ++k)
+      {
+        base_edge_descriptor e = edgs[k - begin];
+        adj[k] = get(vid_map, target(e, *original_graph));
+        ids[k] = get(eid_map, e);
+      }
+    }
+
+    size_type* t_offsets =
+      (size_type*) malloc((order + 1) * sizeof(size_type));
+    size_type* t_adj = (size_type*) malloc(size * sizeof(size_type));
+    size_type* t_ids = (size_type*) malloc(size * sizeof(size_type));
+
+    transpose_csr(order, offsets, adj, t_offsets, t_adj, t_ids);
+
+    // Each transposed entry holds the position of its edge in adj.
+    #pragma mta assert nodep
+    #ifdef _OPENMP
+    #pragma omp parallel for
+    #endif
+    for (size_type k = 0; k < size; ++k) t_ids[k] = ids[t_ids[k]];
+
+    free(offsets);
+    free(adj);
+    free(ids);
+
+    init_csr(order, t_offsets, t_adj, t_ids, transpose_graph);
+
+    free(t_offsets);
+    free(t_adj);
+    free(t_ids);
+  }
+
+  template <typename DIRECTION>
+  void init_transpose(DIRECTION)
   {
     base_size_type order = num_vertices(*original_graph);
     base_size_type size = num_edges(*original_graph);
@@ -109,16 +196,6 @@ public:
     delete [] e_dests;
   }
 
-  // The compiler-synthesized copy control works fine for this class, so we
-  // don't implement it ourselves.  We assume that the graph adapter passed
-  // as a template parameter has a correctly implemented deep copy which makes
-  // the transpose adapter perform a deep copy.
-
-  const wrapper_adapter& get_adapter() const { return transpose_graph; }
-
-  void print() { transpose_graph.print(); }
-
-private:
   graph_adapter* original_graph;
   wrapper_adapter transpose_graph;
 };
@@ -41,6 +41,7 @@
 #include <limits>
 
 #include <mtgl/mtgl_adapter.hpp>
+#include <mtgl/parallel_primitives.hpp>
 
 #ifdef USING_QTHREADS
 #include <qthread/qloop.hpp>
@@ -667,13 +668,7 @@ public:
     }
 
     // Find the starting index in the endpoints array for each vertex.
-    numEdges[0] = 0;
-
-    #pragma mta block schedule
-    for (size_type i = 1; i <= order; ++i)
-    {
-      numEdges[i] = numEdges[i - 1] + degree[i - 1];
-    }
+    numEdges[order] = exclusive_prefix_sum(degree, numEdges, order);
 
     // Reset degree to be all 0's.
 #ifdef USING_QTHREADS
@@ -747,6 +742,114 @@ public:
     free(degree);
   }
 
+  /// \brief Builds the graph from compressed sparse row arrays.
+  ///
+  /// Equivalent to init() with edge i running from the vertex whose row
+  /// holds position i to adjacencies[i].  The input is already grouped by
+  /// source, so a directed graph is a parallel copy of the arrays with the
+  /// internal order equal to the input order.  An undirected graph places
+  /// each vertex's own row first and the reverse entries after it, with one
+  /// fetch-and-add per edge.  If ids is given, the entry at position i of
+  /// adjacencies becomes the edge with id ids[i] instead of id i.  The ids
+  /// must be a permutation of 0 to offsets[order] - 1.
+  void init_csr(size_type order, size_type* offsets, size_type* adjacencies,
+                size_type* ids = 0)
+  {
+    clear();
+
+    n = order;
+    m = offsets[order];
+    size_type a_size = DIRECTION::is_directed() ? m : 2 * m;
+
+    index = (size_type*) malloc((n + 1) * sizeof(size_type));
+    src_points = (size_type*) malloc(a_size * sizeof(size_type));
+    end_points = (size_type*) malloc(a_size * sizeof(size_type));
+    original_ids = (size_type*) malloc(a_size * sizeof(size_type));
+    internal_ids = (size_type*) malloc(m * sizeof(size_type));
+
+    size_type* rev_count = 0;
+
+    if (DIRECTION::is_directed())
+    {
+      #pragma mta assert nodep
+      #ifdef _OPENMP
+      #pragma omp parallel for
+      #endif
+      for (size_type i = 0; i < n + 1; ++i) index[i] = offsets[i];
+    }
+    else
+    {
+      // Each vertex's row holds its own adjacencies and then the reverse
+      // entries of the edges that point to it.
+      rev_count = (size_type*) calloc(n, sizeof(size_type));
+
+      #pragma mta assert parallel
+      #ifdef _OPENMP
+      #pragma omp parallel for
+      #endif
+      for (size_type i = 0; i < m; ++i) mt_incr(rev_count[adjacencies[i]], 1);
+
+      #pragma mta assert nodep
+      #ifdef _OPENMP
+      #pragma omp parallel for
+      #endif
+      for (size_type i = 0; i < n; ++i)
+      {
+        index[i] = (offsets[i + 1] - offsets[i]) + rev_count[i];
+      }
+
+      index[n] = exclusive_prefix_sum(index, index, n);
+
+      #pragma mta assert nodep
+      #ifdef _OPENMP
+      #pragma omp parallel for
+      #endif
+      for (size_type i = 0; i < n; ++i) rev_count[i] = 0;
+    }
+
+    #pragma mta assert parallel
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 1024)
+    #endif
+    for (size_type i = 0; i < n; ++i)
+    {
+      size_type begin = offsets[i];
+      size_type out_deg = offsets[i + 1] - begin;
+
+      for (size_type j = 0; j < out_deg; ++j)
+      {
+        size_type vpos = index[i] + j;
+        src_points[vpos] = i;
+        end_points[vpos] = adjacencies[begin + j];
+        size_type id = ids ? ids[begin + j] : begin + j;
+        original_ids[vpos] = id;
+        internal_ids[id] = vpos;
+      }
+    }
+
+    if (!DIRECTION::is_directed())
+    {
+      #pragma mta assert parallel
+      #ifdef _OPENMP
+      #pragma omp parallel for schedule(dynamic, 1024)
+      #endif
+      for (size_type i = 0; i < n; ++i)
+      {
+        for (size_type j = offsets[i]; j < offsets[i + 1]; ++j)
+        {
+          size_type u = adjacencies[j];
+          size_type vpos = index[u] + (offsets[u + 1] - offsets[u]) +
+                           mt_incr(rev_count[u], 1);
+          src_points[vpos] = u;
+          end_points[vpos] = i;
+          original_ids[vpos] = ids ? ids[j] : j;
+        }
+      }
+
+      free(rev_count);
+    }
+  }
+
   size_type get_order() const { return n; }
   size_type get_size() const { return m; }
 
@@ -1304,6 +1407,33 @@ void init(typename compressed_sparse_row_graph<DIRECTION>::size_type n,
 
 /***/
 
+template <typename DIRECTION>
+inline
+void
+init_csr(typename compressed_sparse_row_graph<DIRECTION>::size_type n,
+         typename compressed_sparse_row_graph<DIRECTION>::size_type* offsets,
+         typename compressed_sparse_row_graph<DIRECTION>::size_type* adjacencies,
+         compressed_sparse_row_graph<DIRECTION>& g)
+{
+  return g.init_csr(n, offsets, adjacencies);
+}
+
+/***/
+
+template <typename DIRECTION>
+inline
+void
+init_csr(typename compressed_sparse_row_graph<DIRECTION>::size_type n,
+         typename compressed_sparse_row_graph<DIRECTION>::size_type* offsets,
+         typename compressed_sparse_row_graph<DIRECTION>::size_type* adjacencies,
+         typename compressed_sparse_row_graph<DIRECTION>::size_type* ids,
+         compressed_sparse_row_graph<DIRECTION>& g)
+{
+  return g.init_csr(n, offsets, adjacencies, ids);
+}
+
+/***/
+
 template <typename DIRECTION>
 inline
 void clear(compressed_sparse_row_graph<DIRECTION>& g)
@@ -1522,20 +1652,8 @@ public:
     }
 #endif
 
-    in_numEdges[0] = 0;
-    out_numEdges[0] = 0;
-
-    #pragma mta block schedule
-    for (size_type i = 1; i <= order; ++i)
-    {
-      out_numEdges[i] = out_numEdges[i - 1] + out_degree[i - 1];
-    }
-
-    #pragma mta block schedule
-    for (size_type i = 1; i <= order; ++i)
-    {
-      in_numEdges[i] = in_numEdges[i - 1] + in_degree[i - 1];
-    }
+    out_numEdges[order] = exclusive_prefix_sum(out_degree, out_numEdges, order);
+    in_numEdges[order] = exclusive_prefix_sum(in_degree, in_numEdges, order);
 
     // Reset out_degree and in_degree to be all 0's.
 #ifdef USING_QTHREADS
@@ -29,9 +29,12 @@
 #define MTGL_INDEPENDENT_SET_HPP
 
 #include <climits>
+#include <cstdlib>
 #include <iostream>
 #include <iomanip>
 
+#include <mtgl/parallel_primitives.hpp>
+
 #define IS_CHUNK 256
 
 namespace mtgl {
@@ -299,9 +302,6 @@ independent_set(Graph& g, VertexMap& ind_set)
   #pragma mta noalias ind_set
 
   typedef typename graph_traits<Graph>::size_type size_type;
-  typedef typename graph_traits<Graph>::vertex_descriptor vertex_descriptor;
-  typedef typename graph_traits<Graph>::thread_vertex_iterator
-          thread_vertex_iterator;
 
   size_type order = num_vertices(g);
 
@@ -644,6 +644,224 @@ maximal_independent_set(Graph& g, VertexMap& ind_set,
   return issize;
 }
 
+namespace detail {
+
+/// A fixed pseudo-random priority for the vertex with id i.  splitmix64 is
+/// a bijection, so no two vertices tie.
+inline unsigned long vertex_priority(unsigned long i)
+{
+  unsigned long z = i + 0x9E3779B97F4A7C15UL;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9UL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBUL;
+  return z ^ (z >> 31);
+}
+
+/// \brief Builds a CSR over vertex ids holding every vertex's neighbors in
+///        both directions.  On an undirected graph that is the adjacency;
+///        on a directed graph it is the out- and in-neighbors.
+template <typename Graph>
+void undirected_adjacency(Graph& g,
+                          typename graph_traits<Graph>::size_type*& offsets,
+                          typename graph_traits<Graph>::size_type*& adj)
+{
+  typedef typename graph_traits<Graph>::size_type size_type;
+  typedef typename graph_traits<Graph>::vertex_iterator vertex_iterator;
+  typedef typename graph_traits<Graph>::adjacency_iterator adjacency_iterator;
+
+  vertex_id_map<Graph> vid_map = get(_vertex_id_map, g);
+  vertex_iterator verts = vertices(g);
+  size_type order = num_vertices(g);
+  bool directed = is_directed(g);
+
+  size_type* cursor = (size_type*) calloc(order, sizeof(size_type));
+
+  #pragma mta assert parallel
+  #ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic, 1024)
+  #endif
+  for (size_type i = 0; i < order; ++i)
+  {
+    size_type deg = out_degree(verts[i], g);
+    mt_incr(cursor[i], deg);
+
+    if (directed)
+    {
+      adjacency_iterator adjs = adjacent_vertices(verts[i], g);
+      for (size_type k = 0; k < deg; ++k)
+      {
+        mt_incr(cursor[get(vid_map, adjs[k])], 1);
+      }
+    }
+  }
+
+  offsets = (size_type*) malloc((order + 1) * sizeof(size_type));
+  offsets[order] = exclusive_prefix_sum(cursor, offsets, order);
+
+  #pragma mta assert nodep
+  #ifdef _OPENMP
+  #pragma omp parallel for
+  #endif
+  for (size_type i = 0; i < order; ++i) cursor[i] = offsets[i];
+
+  adj = (size_type*) malloc(offsets[order] * sizeof(size_type));
+
+  #pragma mta assert parallel
+  #ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic, 1024)
+  #endif
+  for (size_type i = 0; i < order; ++i)
+  {
+    size_type deg = out_degree(verts[i], g);
+    adjacency_iterator adjs = adjacent_vertices(verts[i], g);
+
+    for (size_type k = 0; k < deg; ++k)
+    {
+      size_type j = get(vid_map, adjs[k]);
+      adj[mt_incr(cursor[i], 1)] = j;
+      if (directed) adj[mt_incr(cursor[j], 1)] = i;
+    }
+  }
+
+  free(cursor);
+}
+
+}
+
+/*! \brief Finds the maximal independent set that the sequential greedy
+           algorithm finds when it visits the vertices in a fixed random
+           order, after Blelloch, Fineman and Shun, "Greedy Sequential
+           Maximal Independent Set and Matching are Parallel on Average"
+           (SPAA 2012).
+
+    In each round every undecided vertex whose higher-priority neighbors
+    have all left the set joins it, and every undecided vertex with a
+    neighbor in the set leaves.  Decisions are made against the previous
+    round's state, so the set and the number of rounds do not depend on the
+    number of threads.  Edges are treated as undirected.
+
+    \param g The graph.
+    \param ind_set Set to true for the vertices in the set.
+    \param num_rounds If given, set to the number of rounds taken.
+    \return The size of the set.
+*/
+template <typename Graph, typename VertexMap>
+typename graph_traits<Graph>::size_type
+deterministic_maximal_independent_set(
+    Graph& g, VertexMap& ind_set,
+    typename graph_traits<Graph>::size_type* num_rounds = 0)
+{
+  #pragma mta noalias g
+  #pragma mta noalias ind_set
+
+  typedef typename graph_traits<Graph>::size_type size_type;
+  typedef typename graph_traits<Graph>::vertex_iterator vertex_iterator;
+
+  const char undecided = 0;
+  const char in_set = 1;
+  const char out_of_set = 2;
+
+  vertex_iterator verts = vertices(g);
+  size_type order = num_vertices(g);
+
+  size_type* offsets;
+  size_type* adj;
+  detail::undirected_adjacency(g, offsets, adj);
+
+  char* state = (char*) malloc(order * sizeof(char));
+  char* decision = (char*) malloc(order * sizeof(char));
+  size_type* live = (size_type*) malloc(order * sizeof(size_type));
+  size_type* next = (size_type*) malloc(order * sizeof(size_type));
+
+  #pragma mta assert nodep
+  #ifdef _OPENMP
+  #pragma omp parallel for
+  #endif
+  for (size_type i = 0; i < order; ++i)
+  {
+    state[i] = undecided;
+    live[i] = i;
+  }
+
+  size_type num_live = order;
+  size_type rounds = 0;
+
+  while (num_live > 0)
+  {
+    ++rounds;
+
+    #pragma mta assert parallel
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 1024)
+    #endif
+    for (size_type i = 0; i < num_live; ++i)
+    {
+      size_type v = live[i];
+      unsigned long pv = detail::vertex_priority(v);
+      char d = in_set;
+
+      for (size_type k = offsets[v]; k < offsets[v + 1]; ++k)
+      {
+        size_type w = adj[k];
+
+        if (state[w] == in_set)
+        {
+          d = out_of_set;
+          break;
+        }
+
+        if (state[w] == undecided && w != v &&
+            detail::vertex_priority(w) > pv)
+        {
+          d = undecided;
+        }
+      }
+
+      decision[v] = d;
+    }
+
+    size_type num_next = 0;
+
+    #pragma mta assert parallel
+    #ifdef _OPENMP
+    #pragma omp parallel for
+    #endif
+    for (size_type i = 0; i < num_live; ++i)
+    {
+      size_type v = live[i];
+      state[v] = decision[v];
+      if (decision[v] == undecided) next[mt_incr(num_next, 1)] = v;
+    }
+
+    size_type* tmp = live;
+    live = next;
+    next = tmp;
+    num_live = num_next;
+  }
+
+  size_type issize = 0;
+
+  #pragma mta assert nodep
+  #ifdef _OPENMP
+  #pragma omp parallel for reduction(+:issize)
+  #endif
+  for (size_type i = 0; i < order; ++i)
+  {
+    ind_set[verts[i]] = state[i] == in_set;
+    issize += state[i] == in_set;
+  }
+
+  if (num_rounds) *num_rounds = rounds;
+
+  free(offsets);
+  free(adj);
+  free(state);
+  free(decision);
+  free(live);
+  free(next);
+
+  return issize;
+}
+
 }
 
 #endif
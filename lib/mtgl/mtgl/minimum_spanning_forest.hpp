@@ -0,0 +1,506 @@
+/*  _________________________________________________________________________
+ *
+ *  MTGL: The MultiThreaded Graph Library
+ *  Copyright (c) 2008 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the README file in the top MTGL directory.
+ *  _________________________________________________________________________
+ */
+
+/****************************************************************************/
+/*! \file minimum_spanning_forest.hpp
+
+    \brief Minimum spanning forests by parallel Boruvka, and by the
+           filter-Kruskal algorithm of Osipov, Sanders, and Singler, "The
+           Filter-Kruskal Minimum Spanning Tree Algorithm" (ALENEX 2009).
+
+    \date 10/17/2026
+*/
+/****************************************************************************/
+
+#ifndef MTGL_MINIMUM_SPANNING_FOREST_HPP
+#define MTGL_MINIMUM_SPANNING_FOREST_HPP
+
+#include <cstdlib>
+#include <algorithm>
+
+#include <mtgl/util.hpp>
+#include <mtgl/mtgl_adapter.hpp>
+
+#define MSF_KRUSKAL_CUTOFF 8192
+
+namespace mtgl {
+
+namespace detail {
+
+template <typename T>
+inline bool msf_cas(T& target, T oldval, T newval)
+{
+#ifdef __MTA__
+  T cur = mt_readfe(target);
+  bool swapped = cur == oldval;
+  mt_write(target, swapped ? newval : cur);
+  return swapped;
+#elif defined(_OPENMP)
+  return __sync_bool_compare_and_swap(&target, oldval, newval);
+#else
+  if (target != oldval) return false;
+  target = newval;
+  return true;
+#endif
+}
+
+/// Orders edge ids by weight, and equal weights by id, so that no two edges
+/// tie and the minimum spanning forest is unique.
+template <typename size_type, typename WeightType>
+class msf_lighter {
+public:
+  msf_lighter(const WeightType* w) : weights(w) {}
+
+  bool operator()(size_type a, size_type b) const
+  {
+    return weights[a] < weights[b] || (weights[a] == weights[b] && a < b);
+  }
+
+private:
+  const WeightType* weights;
+};
+
+/// Lowers best to e if e is lighter, where best is -1 if no edge is set.
+template <typename size_type, typename WeightType>
+inline void msf_min(size_type& best, size_type e,
+                    const msf_lighter<size_type, WeightType>& lighter)
+{
+  size_type cur = best;
+
+  while (cur == static_cast<size_type>(-1) || lighter(e, cur))
+  {
+    if (msf_cas(best, cur, e)) return;
+    cur = best;
+  }
+}
+
+/// Fills srcs and trgs, indexed by edge id, with the ids of the endpoints.
+template <typename Graph>
+void msf_endpoints(Graph& g, typename graph_traits<Graph>::size_type* srcs,
+                   typename graph_traits<Graph>::size_type* trgs)
+{
+  typedef typename graph_traits<Graph>::size_type size_type;
+  typedef typename graph_traits<Graph>::edge_descriptor edge_descriptor;
+  typedef typename graph_traits<Graph>::edge_iterator edge_iterator;
+
+  vertex_id_map<Graph> vid_map = get(_vertex_id_map, g);
+  edge_id_map<Graph> eid_map = get(_edge_id_map, g);
+
+  size_type size = num_edges(g);
+  edge_iterator edgs = edges(g);
+
+  #pragma mta assert nodep
+  #ifdef _OPENMP
+  #pragma omp parallel for
+  #endif
+  for (size_type i = 0; i < size; ++i)
+  {
+    edge_descriptor e = edgs[i];
+    size_type eid = get(eid_map, e);
+    srcs[eid] = get(vid_map, source(e, g));
+    trgs[eid] = get(vid_map, target(e, g));
+  }
+}
+
+template <typename size_type, typename WeightType>
+WeightType msf_total_weight(const WeightType* weights,
+                            const size_type* forest, size_type num_forest)
+{
+  WeightType total = WeightType();
+
+  #pragma mta assert parallel
+  #ifdef _OPENMP
+  #pragma omp parallel for reduction(+:total)
+  #endif
+  for (size_type i = 0; i < num_forest; ++i) total += weights[forest[i]];
+
+  return total;
+}
+
+/*! \brief The union-find state of a filter-Kruskal run.
+
+    Partitioning around a pivot and filtering the heavy side are parallel.
+    The filter only reads the union-find forest, which is written by the
+    sequential Kruskal steps on the small light sides in between.
+*/
+template <typename size_type, typename WeightType>
+class filter_kruskal {
+public:
+  filter_kruskal(size_type n, const size_type* s, const size_type* t,
+                 const WeightType* w, size_type* f) :
+    order(n), srcs(s), trgs(t), lighter(w), forest(f), num_forest(0)
+  {
+    parent = (size_type*) malloc(order * sizeof(size_type));
+    rank = (unsigned char*) calloc(order, sizeof(unsigned char));
+
+    #pragma mta assert nodep
+    #ifdef _OPENMP
+    #pragma omp parallel for
+    #endif
+    for (size_type i = 0; i < order; ++i) parent[i] = i;
+  }
+
+  ~filter_kruskal()
+  {
+    free(parent);
+    free(rank);
+  }
+
+  /// Adds the forest edges among edgs[0..count) to the forest, using
+  /// scratch[0..count) as workspace.  Reorders edgs.
+  void run(size_type* edgs, size_type count, size_type* scratch)
+  {
+    if (count <= MSF_KRUSKAL_CUTOFF)
+    {
+      kruskal(edgs, count);
+      return;
+    }
+
+    size_type pivot = median(edgs[0], edgs[count / 2], edgs[count - 1]);
+    size_type num_light = 0;
+    size_type num_heavy = 0;
+
+    #pragma mta assert parallel
+    #ifdef _OPENMP
+    #pragma omp parallel for
+    #endif
+    for (size_type i = 0; i < count; ++i)
+    {
+      size_type e = edgs[i];
+
+      if (!lighter(pivot, e))
+      {
+        scratch[mt_incr(num_light, 1)] = e;
+      }
+      else
+      {
+        scratch[count - 1 - mt_incr(num_heavy, 1)] = e;
+      }
+    }
+
+    copy(scratch, count, edgs);
+
+    run(edgs, num_light, scratch);
+
+    // Drop the heavy edges that the light ones already connected.
+    size_type* heavy = edgs + num_light;
+    size_type num_kept = 0;
+
+    #pragma mta assert parallel
+    #ifdef _OPENMP
+    #pragma omp parallel for
+    #endif
+    for (size_type i = 0; i < num_heavy; ++i)
+    {
+      size_type e = heavy[i];
+
+      if (root(srcs[e]) != root(trgs[e]))
+      {
+        scratch[mt_incr(num_kept, 1)] = e;
+      }
+    }
+
+    copy(scratch, num_kept, heavy);
+
+    run(heavy, num_kept, scratch);
+  }
+
+  size_type size() const { return num_forest; }
+
+private:
+  size_type median(size_type a, size_type b, size_type c) const
+  {
+    if (lighter(b, a)) std::swap(a, b);
+    if (lighter(c, b)) b = lighter(c, a) ? a : c;
+    return b;
+  }
+
+  static void copy(const size_type* from, size_type count, size_type* to)
+  {
+    #pragma mta assert nodep
+    #ifdef _OPENMP
+    #pragma omp parallel for
+    #endif
+    for (size_type i = 0; i < count; ++i) to[i] = from[i];
+  }
+
+  size_type root(size_type v) const
+  {
+    while (parent[v] != v) v = parent[v];
+    return v;
+  }
+
+  size_type find(size_type v)
+  {
+    while (parent[v] != v)
+    {
+      parent[v] = parent[parent[v]];
+      v = parent[v];
+    }
+
+    return v;
+  }
+
+  void kruskal(size_type* edgs, size_type count)
+  {
+    std::sort(edgs, edgs + count, lighter);
+
+    for (size_type i = 0; i < count; ++i)
+    {
+      size_type e = edgs[i];
+      size_type u = find(srcs[e]);
+      size_type v = find(trgs[e]);
+
+      if (u == v) continue;
+
+      if (rank[u] < rank[v]) std::swap(u, v);
+      if (rank[u] == rank[v]) ++rank[u];
+
+      parent[v] = u;
+      forest[num_forest++] = e;
+    }
+  }
+
+  size_type order;
+  const size_type* srcs;
+  const size_type* trgs;
+  msf_lighter<size_type, WeightType> lighter;
+  size_type* forest;
+  size_type num_forest;
+  size_type* parent;
+  unsigned char* rank;
+};
+
+}
+
+/*! \brief Finds a minimum spanning forest of g by parallel Boruvka.
+
+    weights is indexed by edge id, and edges are taken as undirected.  Ties
+    between equal weights are broken by edge id, so the forest is unique
+    and the same one filter_kruskal_minimum_spanning_forest() returns.
+
+    Each round every component picks its lightest edge to another component
+    with a compare-and-swap minimum, and hooks its root to the component at
+    the other end.  Two components that pick the same edge would hook to
+    each other, so the one with the lower id stays the root.  The hooked
+    trees are then compressed, and the edges inside a component dropped, so
+    each round only scans the edges still between components.
+
+    The ids of the forest edges are written to forest, which needs room for
+    num_vertices(g) - 1 of them, in no particular order.  Returns their
+    number, and their total weight in total_weight if it is given.
+*/
+template <typename Graph, typename WeightType>
+typename graph_traits<Graph>::size_type
+boruvka_minimum_spanning_forest(Graph& g, const WeightType* weights,
+                                typename graph_traits<Graph>::size_type* forest,
+                                WeightType* total_weight = 0)
+{
+  #pragma mta noalias g
+  #pragma mta noalias *weights
+  #pragma mta noalias *forest
+
+  typedef typename graph_traits<Graph>::size_type size_type;
+
+  const size_type none = static_cast<size_type>(-1);
+
+  size_type order = num_vertices(g);
+  size_type size = num_edges(g);
+
+  size_type* srcs = (size_type*) malloc(size * sizeof(size_type));
+  size_type* trgs = (size_type*) malloc(size * sizeof(size_type));
+  size_type* live = (size_type*) malloc(size * sizeof(size_type));
+  size_type* kept = (size_type*) malloc(size * sizeof(size_type));
+  size_type* comp = (size_type*) malloc(order * sizeof(size_type));
+  size_type* best = (size_type*) malloc(order * sizeof(size_type));
+  size_type* hook = (size_type*) malloc(order * sizeof(size_type));
+
+  detail::msf_endpoints(g, srcs, trgs);
+  detail::msf_lighter<size_type, WeightType> lighter(weights);
+
+  #pragma mta assert nodep
+  #ifdef _OPENMP
+  #pragma omp parallel for
+  #endif
+  for (size_type i = 0; i < order; ++i) comp[i] = i;
+
+  #pragma mta assert nodep
+  #ifdef _OPENMP
+  #pragma omp parallel for
+  #endif
+  for (size_type i = 0; i < size; ++i) live[i] = i;
+
+  size_type num_live = size;
+  size_type num_forest = 0;
+
+  while (true)
+  {
+    // Keep the edges between components, which drops self loops at first.
+    size_type num_kept = 0;
+
+    #pragma mta assert parallel
+    #ifdef _OPENMP
+    #pragma omp parallel for
+    #endif
+    for (size_type i = 0; i < num_live; ++i)
+    {
+      size_type e = live[i];
+
+      if (comp[srcs[e]] != comp[trgs[e]]) kept[mt_incr(num_kept, 1)] = e;
+    }
+
+    std::swap(live, kept);
+    num_live = num_kept;
+
+    if (num_live == 0) break;
+
+    #pragma mta assert nodep
+    #ifdef _OPENMP
+    #pragma omp parallel for
+    #endif
+    for (size_type i = 0; i < order; ++i) best[i] = none;
+
+    #pragma mta assert parallel
+    #ifdef _OPENMP
+    #pragma omp parallel for
+    #endif
+    for (size_type i = 0; i < num_live; ++i)
+    {
+      size_type e = live[i];
+      detail::msf_min(best[comp[srcs[e]]], e, lighter);
+      detail::msf_min(best[comp[trgs[e]]], e, lighter);
+    }
+
+    #pragma mta assert parallel
+    #ifdef _OPENMP
+    #pragma omp parallel for
+    #endif
+    for (size_type i = 0; i < order; ++i)
+    {
+      size_type e = best[i];
+      hook[i] = i;
+
+      if (comp[i] != i || e == none) continue;
+
+      size_type c = comp[srcs[e]];
+      size_type d = c == i ? comp[trgs[e]] : c;
+
+      if (best[d] == e && i < d) continue;
+
+      hook[i] = d;
+      forest[mt_incr(num_forest, 1)] = e;
+    }
+
+    #pragma mta assert nodep
+    #ifdef _OPENMP
+    #pragma omp parallel for
+    #endif
+    for (size_type i = 0; i < order; ++i)
+    {
+      if (comp[i] == i) comp[i] = hook[i];
+    }
+
+    #pragma mta assert parallel
+    #ifdef _OPENMP
+    #pragma omp parallel for
+    #endif
+    for (size_type i = 0; i < order; ++i)
+    {
+      while (comp[i] != comp[comp[i]]) comp[i] = comp[comp[i]];
+    }
+  }
+
+  if (total_weight)
+  {
+    *total_weight = detail::msf_total_weight(weights, forest, num_forest);
+  }
+
+  free(srcs);
+  free(trgs);
+  free(live);
+  free(kept);
+  free(comp);
+  free(best);
+  free(hook);
+
+  return num_forest;
+}
+
+/*! \brief Finds a minimum spanning forest of g by filter-Kruskal.
+
+    Kruskal's algorithm on a pivot partition of the edges: the forest of the
+    light half is found first, the heavy edges whose ends it already
+    connects are filtered out in parallel, and the rest are recursed on.
+    Below MSF_KRUSKAL_CUTOFF edges a part is sorted and added sequentially.
+    On sparse graphs most heavy edges are filtered before they are ever
+    sorted, which makes this faster than Boruvka there.
+
+    Takes and returns the same as boruvka_minimum_spanning_forest(), and
+    finds the same forest.
+*/
+template <typename Graph, typename WeightType>
+typename graph_traits<Graph>::size_type
+filter_kruskal_minimum_spanning_forest(
+    Graph& g, const WeightType* weights,
+    typename graph_traits<Graph>::size_type* forest,
+    WeightType* total_weight = 0)
+{
+  #pragma mta noalias g
+  #pragma mta noalias *weights
+  #pragma mta noalias *forest
+
+  typedef typename graph_traits<Graph>::size_type size_type;
+
+  size_type order = num_vertices(g);
+  size_type size = num_edges(g);
+
+  size_type* srcs = (size_type*) malloc(size * sizeof(size_type));
+  size_type* trgs = (size_type*) malloc(size * sizeof(size_type));
+  size_type* edgs = (size_type*) malloc(size * sizeof(size_type));
+  size_type* scratch = (size_type*) malloc(size * sizeof(size_type));
+
+  detail::msf_endpoints(g, srcs, trgs);
+
+  size_type count = 0;
+
+  #pragma mta assert parallel
+  #ifdef _OPENMP
+  #pragma omp parallel for
+  #endif
+  for (size_type i = 0; i < size; ++i)
+  {
+    if (srcs[i] != trgs[i]) edgs[mt_incr(count, 1)] = i;
+  }
+
+  detail::filter_kruskal<size_type, WeightType>
+    fk(order, srcs, trgs, weights, forest);
+  fk.run(edgs, count, scratch);
+
+  size_type num_forest = fk.size();
+
+  if (total_weight)
+  {
+    *total_weight = detail::msf_total_weight(weights, forest, num_forest);
+  }
+
+  free(srcs);
+  free(trgs);
+  free(edgs);
+  free(scratch);
+
+  return num_forest;
+}
+
+}
+
+#undef MSF_KRUSKAL_CUTOFF
+
+#endif
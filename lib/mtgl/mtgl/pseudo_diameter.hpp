@@ -26,6 +26,7 @@
 #include <cmath>
 
 #include <mtgl/breadth_first_search.hpp>
+#include <mtgl/multi_source_bfs.hpp>
 #include <mtgl/random.hpp>
 
 namespace mtgl {
@@ -49,6 +50,22 @@ private:
   NodeLevelMap& node_level;
 };
 
+/// Records, for every vertex, the deepest level at which a search reached
+/// it.  Levels are settled in order, so the last store is the largest.
+template <typename size_type>
+class msbfs_depth_visitor {
+public:
+  msbfs_depth_visitor(size_type* d) : depth(d) {}
+
+  void operator()(size_type v, const unsigned long* bits, size_type level)
+  {
+    depth[v] = level;
+  }
+
+private:
+  size_type* depth;
+};
+
 }
 
 /// \brief Finds an approximate diameter of a graph.
@@ -191,6 +208,71 @@ pseudo_diameter(Graph& g)
   return prev_diameter;
 }
 
+/// \brief Finds an approximate diameter of a graph with the sweeps of
+///        pseudo_diameter() run as multi-source searches.
+///
+/// The first round searches from one random vertex with an edge.  Every
+/// later round searches at once from up to 64 of the vertices the previous
+/// round found farthest away, so one round tries several far ends for the
+/// price of about one traversal when they lie close together.  Rounds
+/// continue while the largest distance found grows, up to max_rounds.
+/// Unlike pseudo_diameter(), the graph need not be connected: the result is
+/// the largest distance within the component of the first vertex.
+template <typename Graph>
+typename graph_traits<Graph>::size_type
+multi_source_pseudo_diameter(Graph& g, int max_rounds = 8)
+{
+  #pragma mta noalias g
+
+  typedef typename graph_traits<Graph>::size_type size_type;
+  typedef typename graph_traits<Graph>::vertex_iterator vertex_iterator;
+  typedef multi_source_bfs<Graph, 1> msbfs;
+
+  size_type order = num_vertices(g);
+  if (order == 0) return 0;
+
+  vertex_iterator verts = vertices(g);
+  size_type sources[msbfs::max_sources];
+  int num_sources = 0;
+
+  // Isolated vertices give nothing to sweep from, so skip them, but give up
+  // after a bounded number of draws on a graph that is mostly isolated.
+  for (size_type tries = 0; num_sources == 0 && tries < 4096; ++tries)
+  {
+    size_type v = mt_lrand48_64() % order;
+    if (out_degree(verts[v], g) > 0) sources[num_sources++] = v;
+  }
+
+  if (num_sources == 0) return 0;
+
+  // Every round searches the same component and so overwrites the depth
+  // of every vertex in it; the rest stay 0.
+  size_type* depth = (size_type*) calloc(order, sizeof(size_type));
+  msbfs engine(g);
+  size_type diameter = 0;
+
+  for (int round = 0; round < max_rounds; ++round)
+  {
+    detail::msbfs_depth_visitor<size_type> vis(depth);
+    size_type d = engine.run(sources, num_sources, vis);
+
+    if (round > 0 && d <= diameter) break;
+
+    diameter = d;
+
+    // The next sources are the vertices reached at the deepest level.
+    num_sources = 0;
+    for (size_type i = 0; i < order && num_sources < msbfs::max_sources; ++i)
+    {
+      if (depth[i] == d) sources[num_sources++] = i;
+    }
+  }
+
+  free(depth);
+
+  return diameter;
+}
+
 }
 
 #endif
@@ -26,6 +26,8 @@
 #include <mtgl/compressed_sparse_row_graph.hpp>
 #include <mtgl/adjacency_list.hpp>
 #include <mtgl/connected_components.hpp>
+#include <mtgl/afforest.hpp>
+#include <mtgl/minimum_spanning_forest.hpp>
 #include <mtgl/util.hpp>
 #include <mtgl/mtgl_test.hpp>
 #include <mtgl/random.hpp>
@@ -73,19 +75,82 @@ int main(int argc, char* argv[])
   mt_timer cc_time;
 
   cc_time.start();
-  connected_components(ga, components);
+  shiloach_vishkin(ga, components);
   cc_time.stop();
 
-  std::cout << "gcc_sv time: " << cc_time.getElapsedSeconds() << std::endl;
-  std::cout << "There are " << count_connected_components(ga, components)
-            << " connected components." << std::endl;
+  std::cout << "sv time (going through edges): " << cc_time.getElapsedSeconds()
+            << std::endl;
 
+  size_type num_components = count_connected_components(ga, components);
+  std::cout << "There are " << num_components << " connected components."
+            << std::endl;
+
+  // Afforest and the forests are checked before gcc_sv below, which crashes
+  // on some platforms.
   cc_time.start();
-  shiloach_vishkin(ga, components);
+  afforest(ga, components);
   cc_time.stop();
 
-  std::cout << "sv time (going through edges): " << cc_time.getElapsedSeconds()
+  size_type afforest_components = count_connected_components(ga, components);
+
+  std::cout << "afforest time: " << cc_time.getElapsedSeconds() << std::endl;
+  std::cout << "There are " << afforest_components << " connected components."
+            << std::endl;
+
+  if (afforest_components != num_components)
+  {
+    std::cout << "ERROR: afforest and shiloach_vishkin disagree." << std::endl;
+  }
+
+  // A spanning forest has one edge fewer than vertices per component, and
+  // both algorithms find the same unique minimum one.
+
+  long* weights = (long*) malloc(size * sizeof(long));
+  size_type* forest = (size_type*) malloc(order * sizeof(size_type));
+  for (size_type i = 0; i < size; ++i) weights[i] = mt_lrand48() % 1000;
+
+  long boruvka_weight;
+  cc_time.start();
+  size_type num_forest =
+    boruvka_minimum_spanning_forest(ga, weights, forest, &boruvka_weight);
+  cc_time.stop();
+
+  std::cout << "boruvka msf time: " << cc_time.getElapsedSeconds()
+            << std::endl;
+  std::cout << "The forest has " << num_forest << " edges of total weight "
+            << boruvka_weight << "." << std::endl;
+
+  if (num_forest != order - num_components)
+  {
+    std::cout << "ERROR: expected " << order - num_components
+              << " forest edges." << std::endl;
+  }
+
+  long kruskal_weight;
+  cc_time.start();
+  num_forest =
+    filter_kruskal_minimum_spanning_forest(ga, weights, forest,
+                                           &kruskal_weight);
+  cc_time.stop();
+
+  std::cout << "filter-kruskal msf time: " << cc_time.getElapsedSeconds()
             << std::endl;
+  std::cout << "The forest has " << num_forest << " edges of total weight "
+            << kruskal_weight << "." << std::endl;
+
+  if (num_forest != order - num_components || kruskal_weight != boruvka_weight)
+  {
+    std::cout << "ERROR: filter-kruskal and boruvka disagree." << std::endl;
+  }
+
+  free(weights);
+  free(forest);
+
+  cc_time.start();
+  connected_components(ga, components);
+  cc_time.stop();
+
+  std::cout << "gcc_sv time: " << cc_time.getElapsedSeconds() << std::endl;
   std::cout << "There are " << count_connected_components(ga, components)
             << " connected components." << std::endl;
 
@@ -25,6 +25,7 @@
 
 #include <mtgl/subgraph_adapter.hpp>
 #include <mtgl/duplicate_adapter.hpp>
+#include <mtgl/csr_transpose.hpp>
 
 using namespace mtgl;
 
@@ -194,5 +195,49 @@ int main(int argc, char *argv[])
   dg3 = dg;
   dg3.print();
 
+  // The same closure straight from the edge arrays, without self loops and
+  // repeated edges.
+  size_type* offsets = (size_type*) calloc(numVerts + 1, sizeof(size_type));
+  size_type* adjacencies = (size_type*) malloc(numEdges * sizeof(size_type));
+
+  for (size_type i = 0; i < numEdges; ++i) ++offsets[sources[i] + 1];
+  for (size_type i = 0; i < numVerts; ++i) offsets[i + 1] += offsets[i];
+  for (size_type i = 0; i < numEdges; ++i)
+  {
+    adjacencies[offsets[sources[i]]++] = targets[i];
+  }
+  for (size_type i = numVerts; i > 0; --i) offsets[i] = offsets[i - 1];
+  offsets[0] = 0;
+
+  size_type* s_offsets = (size_type*) malloc((numVerts + 1) *
+                                             sizeof(size_type));
+  size_type* s_adjacencies =
+    (size_type*) malloc(2 * numEdges * sizeof(size_type));
+  unsigned long peak_bytes = 0;
+
+  size_type s_size =
+    symmetrize_csr(numVerts, offsets, adjacencies, s_offsets, s_adjacencies,
+                   (size_type*) 0, REMOVE_SELF_LOOPS | REMOVE_DUPLICATE_EDGES,
+                   &peak_bytes);
+
+  std::cout << std::endl << "Symmetrized Graph: (" << numVerts << ", "
+            << s_size << "), workspace " << peak_bytes << " bytes"
+            << std::endl;
+
+  for (size_type i = 0; i < numVerts; ++i)
+  {
+    std::cout << i << ":";
+    for (size_type j = s_offsets[i]; j < s_offsets[i + 1]; ++j)
+    {
+      std::cout << " " << s_adjacencies[j];
+    }
+    std::cout << std::endl;
+  }
+
+  free(offsets);
+  free(adjacencies);
+  free(s_offsets);
+  free(s_adjacencies);
+
   return 0;
 }
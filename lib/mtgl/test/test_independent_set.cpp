@@ -22,6 +22,7 @@
 
 #include <mtgl/compressed_sparse_row_graph.hpp>
 #include <mtgl/independent_set.hpp>
+#include <mtgl/graph_coloring.hpp>
 #include <mtgl/mtgl_test.hpp>
 #include <mtgl/random.hpp>
 
@@ -67,6 +68,60 @@ int main(int argc, char* argv[])
 //  print_independent_set(active, order);
   validate_maximal_independent_set(g, active);
 
+  size_type num_rounds;
+
+  std::cout << std::endl
+            << "---------------------------------" << std::endl
+            << "Deterministic MIS" << std::endl
+            << "---------------------------------" << std::endl;
+
+  timer.start();
+
+  ind_set_size = deterministic_maximal_independent_set(g, active, &num_rounds);
+
+  timer.stop();
+  std::cout << "  Time: " << timer.getElapsedSeconds() << std::endl
+            << "  Size: " << ind_set_size << std::endl
+            << "Rounds: " << num_rounds << std::endl;
+
+  validate_maximal_independent_set(g, active);
+
+  size_type* color = new size_type[order];
+  size_type num_colors;
+
+  std::cout << std::endl
+            << "---------------------------------" << std::endl
+            << "Jones-Plassmann coloring" << std::endl
+            << "---------------------------------" << std::endl;
+
+  timer.start();
+
+  num_colors = jones_plassmann_coloring(g, color, &num_rounds);
+
+  timer.stop();
+  std::cout << "  Time: " << timer.getElapsedSeconds() << std::endl
+            << "Colors: " << num_colors << std::endl
+            << "Rounds: " << num_rounds << std::endl;
+
+  validate_coloring(g, color);
+
+  std::cout << std::endl
+            << "---------------------------------" << std::endl
+            << "Speculative greedy coloring" << std::endl
+            << "---------------------------------" << std::endl;
+
+  timer.start();
+
+  num_colors = speculative_greedy_coloring(g, color, &num_rounds);
+
+  timer.stop();
+  std::cout << "  Time: " << timer.getElapsedSeconds() << std::endl
+            << "Colors: " << num_colors << std::endl
+            << "Rounds: " << num_rounds << std::endl;
+
+  validate_coloring(g, color);
+
+  delete [] color;
   delete [] active;
 
   return 0;
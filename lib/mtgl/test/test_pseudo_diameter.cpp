@@ -59,4 +59,13 @@ int main(int argc, char *argv[])
 
   std::cout << "Pseudo-diameter: " << pd << std::endl
             << "           Time: " << timer.getElapsedSeconds() << std::endl;
+
+  timer.start();
+  size_type mpd = multi_source_pseudo_diameter(g);
+  timer.stop();
+
+  std::cout << std::endl
+            << "Multi-source pseudo-diameter: " << mpd << std::endl
+            << "                        Time: " << timer.getElapsedSeconds()
+            << std::endl;
 }
@@ -27,6 +27,7 @@
 #include <iomanip>
 
 #include <mtgl/algorithm.hpp>
+#include <mtgl/parallel_primitives.hpp>
 #include <mtgl/random.hpp>
 #include <mtgl/util.hpp>
 #include <mtgl/mtgl_io.hpp>
@@ -203,6 +204,76 @@ int main(int argc, char* argv[])
     std::cout << "Sorting two arrays worked out." << std::endl;
   }
 
+  // Sort segments of random lengths up to 2000 of a fresh copy of the
+  // data, as when sorting the adjacencies of each vertex.
+  long* offsets = (long*) malloc((size + 1) * sizeof(long));
+  long num_segments = 0;
+
+  offsets[0] = 0;
+  while (offsets[num_segments] < size)
+  {
+    long len = mt_lrand48() % 2000;
+    offsets[num_segments + 1] = offsets[num_segments] + len < size ?
+                                offsets[num_segments] + len : size;
+    ++num_segments;
+  }
+
+  for (int i = 0; i < size; i++) arr1[i] = arr2[size - 1 - i];
+
+  #pragma mta fence
+  mt.start();
+  segmented_sort(offsets, num_segments, arr1);
+  #pragma mta fence
+  mt.stop();
+
+  std::cout << "Segmented sort time: " << mt.getElapsedSeconds()
+            << std::endl;
+
+  cnt = 0;
+  for (long j = 0; j < num_segments; j++)
+  {
+    if (!correctly_sorted(arr1 + offsets[j], offsets[j + 1] - offsets[j]))
+    {
+      cnt++;
+    }
+  }
+
+  if (cnt)
+  {
+    std::cout << "Segments not sorted correctly." << std::endl;
+  }
+  else
+  {
+    std::cout << "Segments sorted correctly." << std::endl;
+  }
+
+  // The prefix sums of the sorted array.
+  #pragma mta fence
+  mt.start();
+  long total = exclusive_prefix_sum(arr, arr1, size);
+  #pragma mta fence
+  mt.stop();
+
+  std::cout << "Prefix sum time: " << mt.getElapsedSeconds() << std::endl;
+
+  long sum = 0;
+  cnt = 0;
+  for (int i = 0; i < size; i++)
+  {
+    if (arr1[i] != sum) cnt++;
+    sum += arr[i];
+  }
+
+  if (cnt || total != sum)
+  {
+    std::cout << "Prefix sum not computed correctly." << std::endl;
+  }
+  else
+  {
+    std::cout << "Prefix sum computed correctly." << std::endl;
+  }
+
+  free(offsets);
   free(arr);
   free(arr1);
   free(arr2);
@@ -0,0 +1,657 @@
+#define _POSIX_C_SOURCE 200112L
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "replay.h"
+
+/* Sub-bucket bits of the latency histogram.  Values below 2^SUB_BITS are
+   exact, larger values share a bucket with the 2^(SUB_BITS-1) neighbours of
+   the same magnitude. */
+#define SUB_BITS 7
+#define SUB_HALF (1L << (SUB_BITS - 1))
+#define NBUCKETS ((64 - SUB_BITS + 1) * SUB_HALF + SUB_HALF)
+
+/* Search parameters: a trial passes when it meets the SLO and applies at
+   least KEEPUP of the offered rate, and the search stops after REFINE
+   bisection steps between the best passing and worst failing rates. */
+#define START_RATE 1000.0
+#define KEEPUP 0.95
+#define REFINE 6
+
+/* Seed of the mixed workload readers' vertex choices; reader r uses
+   MIXED_SEED + r. */
+#define MIXED_SEED 0x5EEDF00DULL
+
+struct hist {
+  int64_t count[NBUCKETS];
+  int64_t total;
+  int64_t max;
+};
+
+struct stream {
+  const int64_t * actions;
+  int64_t naction;
+  int64_t cursor;
+  int64_t applied;
+  replay_apply_fn apply;
+  void * ctx;
+};
+
+static double
+now (void)
+{
+  struct timespec tp;
+  clock_gettime (CLOCK_MONOTONIC, &tp);
+  return (double) tp.tv_sec + 1.0e-9 * (double) tp.tv_nsec;
+}
+
+/* Sleep through long waits, spin through the last stretch of each. */
+static void
+wait_until (double t)
+{
+  for (;;) {
+    const double left = t - now ();
+    if (left <= 0)
+      return;
+    if (left > 2.0e-4) {
+      struct timespec ts;
+      const double nap = left - 1.0e-4;
+      ts.tv_sec = (time_t) nap;
+      ts.tv_nsec = (long) ((nap - (double) ts.tv_sec) * 1.0e9);
+      nanosleep (&ts, NULL);
+    }
+  }
+}
+
+static int64_t
+hist_index (int64_t v)
+{
+  if (v < 2 * SUB_HALF)
+    return v;
+  const int64_t e = 63 - __builtin_clzll (v) - (SUB_BITS - 1);
+  return e * SUB_HALF + (v >> e);
+}
+
+/* Largest value that falls into a bucket. */
+static int64_t
+hist_value (int64_t idx)
+{
+  if (idx < 2 * SUB_HALF)
+    return idx;
+  const int64_t e = idx / SUB_HALF - 1;
+  const int64_t sub = idx - e * SUB_HALF;
+  return ((sub + 1) << e) - 1;
+}
+
+static void
+hist_record (struct hist * h, double seconds)
+{
+  int64_t ns = (int64_t) (seconds * 1.0e9);
+  if (ns < 0)
+    ns = 0;
+  h->count[hist_index (ns)]++;
+  h->total++;
+  if (ns > h->max)
+    h->max = ns;
+}
+
+static double
+hist_quantile (const struct hist * h, double q)
+{
+  if (!h->total)
+    return 0;
+  int64_t target = (int64_t) ceil (q * (double) h->total);
+  if (target < 1)
+    target = 1;
+  int64_t seen = 0;
+  for (int64_t b = 0; b < NBUCKETS; b++) {
+    seen += h->count[b];
+    if (seen >= target) {
+      const int64_t v = hist_value (b);
+      return 1.0e-9 * (double) (v < h->max ? v : h->max);
+    }
+  }
+  return 1.0e-9 * (double) h->max;
+}
+
+/* Hand the next n actions to the backend, splitting where the stream wraps
+   back to its start. */
+static void
+stream_apply (struct stream * s, int64_t n)
+{
+  while (n > 0) {
+    int64_t m = s->naction - s->cursor;
+    if (m > n)
+      m = n;
+    s->apply (s->ctx, s->actions + 2 * s->cursor, m, s->applied);
+    s->cursor += m;
+    if (s->cursor == s->naction)
+      s->cursor = 0;
+    s->applied += m;
+    n -= m;
+  }
+}
+
+/* Offer ntrial actions at the given rate and measure them. */
+static void
+trial (const replay_config_t * cfg, double rate, int64_t ntrial,
+       struct stream * s, struct hist * h, replay_result_t * r)
+{
+  const int64_t max_batch = cfg->max_batch > 0 ? cfg->max_batch : 1;
+  int64_t k = 0, batches = 0;
+
+  memset (h, 0, sizeof (*h));
+
+  const double t0 = now ();
+  while (k < ntrial) {
+    const double t = now ();
+    int64_t arrived = (int64_t) ((t - t0) * rate) + 1;
+    if (arrived > ntrial)
+      arrived = ntrial;
+
+    if (arrived <= k) {
+      wait_until (t0 + k / rate);
+      continue;
+    }
+
+    /* hold a partial batch until it fills or its oldest action's deadline */
+    const int64_t pending = arrived - k;
+    const double oldest = t0 + k / rate;
+    if (pending < max_batch && arrived < ntrial && t < oldest + cfg->deadline) {
+      const double full = t0 + (k + max_batch - 1) / rate;
+      wait_until (full < oldest + cfg->deadline ? full : oldest + cfg->deadline);
+      continue;
+    }
+
+    const int64_t n = pending < max_batch ? pending : max_batch;
+    stream_apply (s, n);
+    const double done = now ();
+
+    for (int64_t a = k; a < k + n; a++)
+      hist_record (h, done - (t0 + a / rate));
+    k += n;
+    batches++;
+  }
+  const double elapsed = now () - t0;
+
+  r->rate = rate;
+  r->achieved = elapsed > 0 ? ntrial / elapsed : rate;
+  r->actions = ntrial;
+  r->batches = batches;
+  r->p50 = hist_quantile (h, 0.5);
+  r->p99 = hist_quantile (h, 0.99);
+  r->p999 = hist_quantile (h, 0.999);
+  r->max = 1.0e-9 * (double) h->max;
+  r->sustainable = r->p99 <= cfg->slo_p99 && r->achieved >= KEEPUP * rate;
+}
+
+static int64_t
+trial_length (const replay_config_t * cfg, double rate)
+{
+  const int64_t n = (int64_t) (rate * cfg->trial);
+  return n > 0 ? n : 1;
+}
+
+static double
+env_double (const char * name, double dflt)
+{
+  const char * v = getenv (name);
+  return v && *v ? atof (v) : dflt;
+}
+
+/**
+* @brief Read the replay settings from the environment.
+*
+* REPLAY_RATE (actions per second, 0 to search for the highest sustainable
+* rate) turns replay on.  REPLAY_DEADLINE_US, REPLAY_BATCH_MAX,
+* REPLAY_SLO_P99_US and REPLAY_TRIAL_SECONDS default to 1000, 4096, 10000
+* and 1.
+*
+* @return 1 if replay was requested, else 0
+*/
+int
+replay_config_from_env (replay_config_t * cfg)
+{
+  cfg->rate = env_double ("REPLAY_RATE", 0);
+  cfg->deadline = 1.0e-6 * env_double ("REPLAY_DEADLINE_US", 1000);
+  cfg->max_batch = (int64_t) env_double ("REPLAY_BATCH_MAX", 4096);
+  cfg->slo_p99 = 1.0e-6 * env_double ("REPLAY_SLO_P99_US", 10000);
+  cfg->trial = env_double ("REPLAY_TRIAL_SECONDS", 1);
+  return getenv ("REPLAY_RATE") != NULL;
+}
+
+/**
+* @brief Replay an action stream at a fixed rate and measure latency.
+*
+* With a positive cfg->rate the whole stream is offered once at that rate.
+* Otherwise trials of cfg->trial seconds double the rate from START_RATE
+* until one breaks the p99 SLO or falls behind the arrivals, then bisect
+* between the last passing and first failing rates.  The result is that of
+* the fastest passing trial, or of the slowest trial if none passed.  Search
+* trials keep cycling through the stream, so a backend will see actions
+* again once the stream wraps.
+*
+* @param cfg Replay settings
+* @param actions The action stream, 2 * naction entries
+* @param naction Number of actions
+* @param apply Applies one batch to the backend
+* @param ctx Passed through to apply
+* @param result Output
+*/
+void
+replay_measure (const replay_config_t * cfg,
+		const int64_t * actions, int64_t naction,
+		replay_apply_fn apply, void * ctx,
+		replay_result_t * result)
+{
+  struct stream s = { actions, naction, 0, 0, apply, ctx };
+  struct hist * h = calloc (1, sizeof (*h));
+  replay_result_t r, best, worst;
+
+  memset (result, 0, sizeof (*result));
+  if (naction <= 0 || !h) {
+    free (h);
+    return;
+  }
+
+  if (cfg->rate > 0) {
+    trial (cfg, cfg->rate, naction, &s, h, result);
+    result->trials = 1;
+    free (h);
+    return;
+  }
+
+  int64_t trials = 0;
+  double good = 0, bad = 0;
+  memset (&best, 0, sizeof (best));
+  memset (&worst, 0, sizeof (worst));
+
+  /* bracket the sustainable rate */
+  for (double rate = START_RATE; ; ) {
+    trial (cfg, rate, trial_length (cfg, rate), &s, h, &r);
+    trials++;
+    if (r.sustainable) {
+      good = rate;
+      best = r;
+      if (bad > 0)
+	break;
+      rate *= 2;
+    } else {
+      bad = rate;
+      worst = r;
+      if (good > 0 || rate < 1.0)
+	break;
+      rate /= 2;
+    }
+  }
+
+  if (good > 0)
+    for (int64_t step = 0; step < REFINE; step++) {
+      const double rate = 0.5 * (good + bad);
+      trial (cfg, rate, trial_length (cfg, rate), &s, h, &r);
+      trials++;
+      if (r.sustainable) {
+	good = rate;
+	best = r;
+      } else
+	bad = rate;
+    }
+
+  *result = good > 0 ? best : worst;
+  result->trials = trials;
+  free (h);
+}
+
+/**
+* @brief Print a replay result as a "replay" entry of the RSLT: JSON.
+*/
+void
+replay_report (const char * name, const replay_result_t * r)
+{
+  printf ("RSLT: \"replay\": {\n");
+  printf ("RSLT: \"name\":\"%s\",\n", name);
+  printf ("RSLT: \"rate\":%le,\n", r->rate);
+  printf ("RSLT: \"achieved\":%le,\n", r->achieved);
+  printf ("RSLT: \"sustainable\":%d,\n", r->sustainable);
+  printf ("RSLT: \"batches\":%ld,\n", (long) r->batches);
+  printf ("RSLT: \"trials\":%ld,\n", (long) r->trials);
+  printf ("RSLT: \"p50\":%le,\n", r->p50);
+  printf ("RSLT: \"p99\":%le,\n", r->p99);
+  printf ("RSLT: \"p999\":%le,\n", r->p999);
+  printf ("RSLT: \"max\":%le\n", r->max);
+  printf ("RSLT: },\n");
+}
+
+struct mixed_shared {
+  const mixed_config_t * cfg;
+  const mixed_ops_t * ops;
+  void * ctx;
+  int64_t nv;
+  const int64_t * actions;
+  int64_t naction;
+  int64_t cursor;	/* next action to hand to a writer */
+  int64_t applied;
+  double t0;
+  volatile int done;	/* set once every writer has returned */
+};
+
+struct mixed_reader {
+  struct mixed_shared * sh;
+  int64_t id;
+  int64_t queries, kernels, checks, violations;
+  struct hist query;
+  struct hist kernel;
+};
+
+static uint64_t
+splitmix64 (uint64_t * state)
+{
+  uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+static void *
+mixed_open (const struct mixed_shared * sh)
+{
+  return sh->ops->open ? sh->ops->open (sh->ctx) : sh->ctx;
+}
+
+static void
+mixed_close (const struct mixed_shared * sh, void * h)
+{
+  if (sh->ops->close)
+    sh->ops->close (h);
+}
+
+static void *
+mixed_writer (void * arg)
+{
+  struct mixed_shared * sh = arg;
+  const int64_t batch = sh->cfg->batch > 0 ? sh->cfg->batch : 1;
+  void * h = mixed_open (sh);
+
+  for (;;) {
+    const int64_t k = __sync_fetch_and_add (&sh->cursor, batch);
+    int64_t start = k, n;
+    if (sh->cfg->duration > 0) {
+      if (now () - sh->t0 >= sh->cfg->duration)
+	break;
+      start = k % sh->naction;
+    } else if (k >= sh->naction)
+      break;
+    n = sh->naction - start < batch ? sh->naction - start : batch;
+
+    sh->ops->apply (h, sh->actions + 2 * start, n, k);
+    __sync_fetch_and_add (&sh->applied, n);
+  }
+
+  mixed_close (sh, h);
+  return NULL;
+}
+
+/* All of v's neighbors, growing the buffer while v has more than it holds. */
+static int64_t
+mixed_neighbors (const mixed_ops_t * ops, void * h, int64_t v,
+		 int64_t ** buf, int64_t * cap)
+{
+  int64_t deg = ops->neighbors (h, v, *buf, *cap);
+  while (deg > *cap) {
+    *cap = 2 * deg;
+    *buf = realloc (*buf, *cap * sizeof (int64_t));
+    deg = ops->neighbors (h, v, *buf, *cap);
+  }
+  return deg;
+}
+
+/* Number of vertices within hops of v. */
+static int64_t
+mixed_khop (const struct mixed_shared * sh, void * h, int64_t v, int64_t hops,
+	    int64_t * mark, int64_t stamp, int64_t * queue,
+	    int64_t ** buf, int64_t * cap)
+{
+  int64_t head = 0, tail = 0;
+
+  queue[tail++] = v;
+  mark[v] = stamp;
+  for (int64_t d = 0; d < hops && head < tail; d++) {
+    const int64_t level_end = tail;
+    for (; head < level_end; head++) {
+      const int64_t deg = mixed_neighbors (sh->ops, h, queue[head], buf, cap);
+      for (int64_t k = 0; k < deg; k++) {
+	const int64_t w = (*buf)[k];
+	if (w >= 0 && w < sh->nv && mark[w] != stamp) {
+	  mark[w] = stamp;
+	  queue[tail++] = w;
+	}
+      }
+    }
+  }
+  return tail;
+}
+
+static void *
+mixed_reader (void * arg)
+{
+  struct mixed_reader * r = arg;
+  struct mixed_shared * sh = r->sh;
+  const mixed_ops_t * ops = sh->ops;
+  const double period = sh->cfg->kernel_period;
+  void * h = mixed_open (sh);
+  uint64_t state = MIXED_SEED + (uint64_t) r->id;
+
+  int64_t cap = 1024, cap2 = 1024;
+  int64_t * nbr = malloc (cap * sizeof (int64_t));
+  int64_t * nbr2 = malloc (cap2 * sizeof (int64_t));
+  int64_t * mark = calloc (sh->nv, sizeof (int64_t));
+  int64_t * queue = malloc (sh->nv * sizeof (int64_t));
+  int64_t * parent = ops->kernel && period > 0 ? malloc (sh->nv * sizeof (int64_t)) : NULL;
+  int64_t stamp = 0;
+  double next_kernel = now () + period;
+
+  while (!sh->done) {
+    double t = now ();
+
+    if (parent && t >= next_kernel) {
+      const int64_t root = (int64_t) (splitmix64 (&state) % (uint64_t) sh->nv);
+      if (ops->read_begin)
+	ops->read_begin (h);
+      ops->kernel (h, root, parent);
+      if (ops->read_end)
+	ops->read_end (h);
+      const double done = now ();
+      hist_record (&r->kernel, done - t);
+      r->kernels++;
+      next_kernel = done + period;
+      continue;
+    }
+
+    const int64_t v = (int64_t) (splitmix64 (&state) % (uint64_t) sh->nv);
+    const uint64_t op = splitmix64 (&state) % 10;
+
+    if (ops->read_begin)
+      ops->read_begin (h);
+    if (op < 4) {
+      ops->degree (h, v);
+    } else if (op < 8) {
+      const int64_t deg = mixed_neighbors (ops, h, v, &nbr, &cap);
+      if (deg > 0) {
+	const int64_t u = nbr[splitmix64 (&state) % (uint64_t) deg];
+	const int64_t deg2 = mixed_neighbors (ops, h, u, &nbr2, &cap2);
+	int64_t k;
+	for (k = 0; k < deg2 && nbr2[k] != v; k++)
+	  ;
+	r->checks++;
+	if (k == deg2) {
+	  /* A removal of {u,v} may have finished between the two reads.
+	     Only a u that is still in v's list means a half-applied update. */
+	  const int64_t deg3 = mixed_neighbors (ops, h, v, &nbr, &cap);
+	  for (k = 0; k < deg3 && nbr[k] != u; k++)
+	    ;
+	  r->violations += k < deg3;
+	}
+      }
+    } else {
+      mixed_khop (sh, h, v, sh->cfg->hops, mark, ++stamp, queue, &nbr, &cap);
+    }
+    if (ops->read_end)
+      ops->read_end (h);
+
+    hist_record (&r->query, now () - t);
+    r->queries++;
+  }
+
+  free (parent);
+  free (queue);
+  free (mark);
+  free (nbr2);
+  free (nbr);
+  mixed_close (sh, h);
+  return NULL;
+}
+
+static void
+hist_merge (struct hist * into, const struct hist * h)
+{
+  for (int64_t b = 0; b < NBUCKETS; b++)
+    into->count[b] += h->count[b];
+  into->total += h->total;
+  if (h->max > into->max)
+    into->max = h->max;
+}
+
+/**
+* @brief Read the mixed workload settings from the environment.
+*
+* MIXED_READERS (reader threads) turns the mixed workload on.
+* MIXED_WRITERS, MIXED_BATCH, MIXED_HOPS, MIXED_KERNEL_MS and MIXED_SECONDS
+* default to 1, 1024, 2, 1000 and 0.
+*
+* @return 1 if the mixed workload was requested, else 0
+*/
+int
+mixed_config_from_env (mixed_config_t * cfg)
+{
+  cfg->readers = (int64_t) env_double ("MIXED_READERS", 4);
+  cfg->writers = (int64_t) env_double ("MIXED_WRITERS", 1);
+  cfg->batch = (int64_t) env_double ("MIXED_BATCH", 1024);
+  cfg->hops = (int64_t) env_double ("MIXED_HOPS", 2);
+  cfg->kernel_period = 1.0e-3 * env_double ("MIXED_KERNEL_MS", 1000);
+  cfg->duration = env_double ("MIXED_SECONDS", 0);
+  return getenv ("MIXED_READERS") != NULL;
+}
+
+/**
+* @brief Run readers against the graph while writers apply the action stream.
+*
+* @param cfg Mixed workload settings
+* @param nv Number of vertices; queries pick vertices uniformly from [0, nv)
+* @param actions The action stream, 2 * naction entries
+* @param naction Number of actions
+* @param ops The backend's queries and update path
+* @param ctx Passed to ops->open, or used as every thread's handle
+* @param result Output
+*/
+void
+mixed_run (const mixed_config_t * cfg, int64_t nv,
+	   const int64_t * actions, int64_t naction,
+	   const mixed_ops_t * ops, void * ctx,
+	   mixed_result_t * result)
+{
+  const int64_t nreaders = cfg->readers > 0 ? cfg->readers : 0;
+  const int64_t nwriters = cfg->writers > 0 ? cfg->writers : 1;
+  struct mixed_shared sh = { cfg, ops, ctx, nv, actions, naction, 0, 0, 0, 0 };
+  struct mixed_reader * readers = calloc (nreaders + 1, sizeof (*readers));
+  pthread_t * threads = malloc ((nreaders + nwriters) * sizeof (pthread_t));
+
+  memset (result, 0, sizeof (*result));
+  result->readers = nreaders;
+  result->writers = nwriters;
+  if (naction <= 0 || nv <= 0 || !readers || !threads) {
+    free (threads);
+    free (readers);
+    return;
+  }
+
+  sh.t0 = now ();
+  for (int64_t r = 0; r < nreaders; r++) {
+    readers[r].sh = &sh;
+    readers[r].id = r;
+    pthread_create (&threads[r], NULL, mixed_reader, &readers[r]);
+  }
+  for (int64_t w = 0; w < nwriters; w++)
+    pthread_create (&threads[nreaders + w], NULL, mixed_writer, &sh);
+
+  for (int64_t w = 0; w < nwriters; w++)
+    pthread_join (threads[nreaders + w], NULL);
+  result->elapsed = now () - sh.t0;
+  __sync_synchronize ();
+  sh.done = 1;
+  for (int64_t r = 0; r < nreaders; r++)
+    pthread_join (threads[r], NULL);
+
+  /* readers[nreaders] gathers the per-reader counts */
+  struct mixed_reader * all = &readers[nreaders];
+  for (int64_t r = 0; r < nreaders; r++) {
+    hist_merge (&all->query, &readers[r].query);
+    hist_merge (&all->kernel, &readers[r].kernel);
+    all->queries += readers[r].queries;
+    all->kernels += readers[r].kernels;
+    all->checks += readers[r].checks;
+    all->violations += readers[r].violations;
+  }
+
+  result->actions = sh.applied;
+  result->write_rate = result->elapsed > 0 ? sh.applied / result->elapsed : 0;
+  result->queries = all->queries;
+  result->query_p50 = hist_quantile (&all->query, 0.5);
+  result->query_p99 = hist_quantile (&all->query, 0.99);
+  result->query_p999 = hist_quantile (&all->query, 0.999);
+  result->query_max = 1.0e-9 * (double) all->query.max;
+  result->kernels = all->kernels;
+  result->kernel_p50 = hist_quantile (&all->kernel, 0.5);
+  result->kernel_p99 = hist_quantile (&all->kernel, 0.99);
+  result->kernel_max = 1.0e-9 * (double) all->kernel.max;
+  result->checks = all->checks;
+  result->violations = all->violations;
+
+  free (threads);
+  free (readers);
+}
+
+/**
+* @brief Print a mixed workload result as a "mixed" entry of the RSLT: JSON.
+*
+* "time" holds the writers' actions per second.  "violations" counts the
+* symmetry checks in which u was in v's list, v was missing from u's list,
+* and u was still in v's list when read again.  "violation_rule" says so in
+* the output.
+*/
+void
+mixed_report (const char * name, const mixed_result_t * r)
+{
+  printf ("RSLT: \"mixed\": {\n");
+  printf ("RSLT: \"name\":\"%s\",\n", name);
+  printf ("RSLT: \"time\":%le,\n", r->write_rate);
+  printf ("RSLT: \"readers\":%ld,\n", (long) r->readers);
+  printf ("RSLT: \"writers\":%ld,\n", (long) r->writers);
+  printf ("RSLT: \"elapsed\":%le,\n", r->elapsed);
+  printf ("RSLT: \"actions\":%ld,\n", (long) r->actions);
+  printf ("RSLT: \"queries\":%ld,\n", (long) r->queries);
+  printf ("RSLT: \"query_p50\":%le,\n", r->query_p50);
+  printf ("RSLT: \"query_p99\":%le,\n", r->query_p99);
+  printf ("RSLT: \"query_p999\":%le,\n", r->query_p999);
+  printf ("RSLT: \"query_max\":%le,\n", r->query_max);
+  printf ("RSLT: \"kernels\":%ld,\n", (long) r->kernels);
+  printf ("RSLT: \"kernel_p50\":%le,\n", r->kernel_p50);
+  printf ("RSLT: \"kernel_p99\":%le,\n", r->kernel_p99);
+  printf ("RSLT: \"kernel_max\":%le,\n", r->kernel_max);
+  printf ("RSLT: \"checks\":%ld,\n", (long) r->checks);
+  printf ("RSLT: \"violations\":%ld,\n", (long) r->violations);
+  printf ("RSLT: \"violation_rule\":\"u in N(v), v not in N(u), u in N(v) on re-read\"\n");
+  printf ("RSLT: },\n");
+}
@@ -0,0 +1,114 @@
+#if !defined (REPLAY_H_)
+#define REPLAY_H_
+
+#include <stdint.h>
+
+/*
+ * Fixed-rate replay of an action stream against a graph backend.
+ *
+ * Actions arrive open-loop at a fixed rate: action k arrives at k / rate
+ * seconds whether or not the backend has kept up.  Arrived actions are
+ * grouped into a batch that is handed to the backend when it reaches
+ * max_batch actions, when the oldest action in it has waited deadline
+ * seconds, or when the stream ends.  An action's latency runs from its
+ * arrival to the return of the batch that applied it, so time spent queued
+ * behind a slow batch is counted.
+ *
+ * Latencies go into a log-linear histogram with about 1.6% relative error
+ * from nanoseconds to centuries.
+ */
+
+typedef struct replay_config {
+  double  rate;		/* arrival rate in actions per second, 0 to search */
+  double  deadline;	/* longest wait in seconds for a batch to fill */
+  int64_t max_batch;	/* most actions handed to the backend at once */
+  double  slo_p99;	/* p99 latency bound in seconds, used by the search */
+  double  trial;	/* seconds per search trial */
+} replay_config_t;
+
+typedef struct replay_result {
+  double  rate;		/* offered arrival rate */
+  double  achieved;	/* actions applied per second of wall time */
+  int64_t actions;
+  int64_t batches;
+  int64_t trials;
+  int	  sustainable;	/* met the SLO and kept up with the arrivals */
+  double  p50, p99, p999, max;	/* arrival to visibility, seconds */
+} replay_result_t;
+
+/* Apply n actions in the usual (i, j) pair layout, negated for removal.
+   first is the number of actions applied before these. */
+typedef void (*replay_apply_fn) (void * ctx, const int64_t * actions,
+				 int64_t n, int64_t first);
+
+int replay_config_from_env (replay_config_t * cfg);
+void replay_measure (const replay_config_t * cfg,
+		     const int64_t * actions, int64_t naction,
+		     replay_apply_fn apply, void * ctx,
+		     replay_result_t * result);
+void replay_report (const char * name, const replay_result_t * result);
+
+/*
+ * Mixed read/write workload.
+ *
+ * Writer threads take batches of the action stream in order from a shared
+ * cursor and apply them, while reader threads issue point queries against
+ * the same graph until the writers finish: degree lookups, neighbor lists
+ * and k-hop reachability counts in a 4:4:2 mix, with a kernel run (a search
+ * from a random root) every kernel_period seconds.
+ *
+ * Each neighbor-list query also looks up the list of one returned neighbor
+ * u of v.  If v is missing from it, v's list is read again, and the check
+ * counts as a consistency violation only if u is still there; otherwise a
+ * removal of {u,v} simply finished between the reads.  Every action touches
+ * both directions of an edge at once, so a reader that sees only one of
+ * them saw a half-applied update.
+ */
+
+typedef struct mixed_config {
+  int64_t readers;	/* reader threads */
+  int64_t writers;	/* writer threads */
+  int64_t batch;	/* actions per writer batch */
+  int64_t hops;		/* depth of the k-hop queries */
+  double  kernel_period;	/* seconds between a reader's kernel runs, 0 for none */
+  double  duration;	/* seconds to keep writing, cycling the stream; 0 for one pass */
+} mixed_config_t;
+
+typedef struct mixed_result {
+  int64_t readers, writers;
+  double  elapsed;	/* seconds until the writers finished */
+  int64_t actions;
+  double  write_rate;	/* actions applied per second */
+  int64_t queries;
+  double  query_p50, query_p99, query_p999, query_max;
+  int64_t kernels;
+  double  kernel_p50, kernel_p99, kernel_max;
+  int64_t checks;	/* symmetry checks made */
+  int64_t violations;	/* checks that found a half-applied update, confirmed by a re-read */
+} mixed_result_t;
+
+/* How the harness talks to a backend.  Every thread gets its own handle
+   from open (the ctx itself when open is NULL).  read_begin and read_end,
+   when set, bracket each query and kernel run, e.g. as a snapshot
+   transaction.  Writers call apply with their handle. */
+typedef struct mixed_ops {
+  void *  (*open) (void * ctx);
+  void    (*close) (void * handle);
+  void    (*read_begin) (void * handle);
+  void    (*read_end) (void * handle);
+  int64_t (*degree) (void * handle, int64_t v);
+  /* store up to max neighbors of v in out and return v's degree */
+  int64_t (*neighbors) (void * handle, int64_t v, int64_t * out, int64_t max);
+  /* fill parent[0..nv) from a search, as a graph500_bfs_fn; may be NULL */
+  void    (*kernel) (void * handle, int64_t root, int64_t * parent);
+  replay_apply_fn apply;
+} mixed_ops_t;
+
+int mixed_config_from_env (mixed_config_t * cfg);
+void mixed_run (const mixed_config_t * cfg, int64_t nv,
+		const int64_t * actions, int64_t naction,
+		const mixed_ops_t * ops, void * ctx,
+		mixed_result_t * result);
+void mixed_report (const char * name, const mixed_result_t * result);
+
+#endif /* REPLAY_H_ */
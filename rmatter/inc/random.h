@@ -1,3 +1,5 @@
+#include <stdint.h>
+
 typedef struct dxor128_env {
   unsigned x,y,z,w;
 } dxor128_env_t;
@@ -7,3 +9,17 @@ double dxor128(dxor128_env_t * e);
 void dxor128_init(dxor128_env_t * e);
 
 void dxor128_seed(dxor128_env_t * e, unsigned seed);
+
+/* Counter-based Philox4x32-10 stream.  The numbers drawn depend only on
+   (seed, domain, id), never on which thread draws them or in what order
+   the streams are used. */
+typedef struct philox_env {
+  uint32_t key[2];
+  uint32_t ctr[4];
+  uint32_t out[4];
+  int pos;
+} philox_env_t;
+
+void philox_seed(philox_env_t * e, uint64_t seed, uint32_t domain, uint64_t id);
+
+double philox(philox_env_t * e);
@@ -19,3 +19,48 @@ void dxor128_seed(dxor128_env_t * e, unsigned seed) {
   e->z=521288629;
   e->w=seed;
 }
+
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u
+#define PHILOX_W1 0xBB67AE85u
+
+static void philox_block(const uint32_t key_in[2], const uint32_t ctr_in[4], uint32_t out[4]) {
+  uint32_t k0 = key_in[0], k1 = key_in[1];
+  uint32_t c0 = ctr_in[0], c1 = ctr_in[1], c2 = ctr_in[2], c3 = ctr_in[3];
+  for(int r = 0; r < 10; r++) {
+    uint64_t p0 = (uint64_t)PHILOX_M0 * c0;
+    uint64_t p1 = (uint64_t)PHILOX_M1 * c2;
+    uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+    uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+    c1 = (uint32_t)p1;
+    c3 = (uint32_t)p0;
+    c0 = n0;
+    c2 = n2;
+    k0 += PHILOX_W0;
+    k1 += PHILOX_W1;
+  }
+  out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+}
+
+void philox_seed(philox_env_t * e, uint64_t seed, uint32_t domain, uint64_t id) {
+  e->key[0] = (uint32_t)seed;
+  e->key[1] = (uint32_t)(seed >> 32);
+  e->ctr[0] = 0;
+  e->ctr[1] = domain;
+  e->ctr[2] = (uint32_t)id;
+  e->ctr[3] = (uint32_t)(id >> 32);
+  e->pos = 4;
+}
+
+/* Uniform in [0, 1) with 53 bits, two per Philox block */
+double philox(philox_env_t * e) {
+  if(e->pos == 4) {
+    philox_block(e->key, e->ctr, e->out);
+    e->ctr[0]++;
+    e->pos = 0;
+  }
+  uint64_t bits = ((uint64_t)e->out[e->pos] << 32) | e->out[e->pos + 1];
+  e->pos += 2;
+  return (bits >> 11) * (1.0/9007199254740992.0);
+}
@@ -68,15 +68,19 @@ prefix_sum (const int64_t n, int64_t *ary)
   return ary[n-1];
 }
 
+/* Philox stream domains, one per kind of random decision */
+#define RNG_EDGE 0
+#define RNG_ACTION 1
+
 static void
 rmat_edge (int64_t * iout, int64_t * jout,
-           int SCALE, double A, double B, double C, double D, dxor128_env_t * env)
+           int SCALE, double A, double B, double C, double D, philox_env_t * env)
 {
   int64_t i = 0, j = 0;
   int64_t bit = ((int64_t) 1) << (SCALE - 1);
 
   while (1) {
-    const double r = dxor128(env);
+    const double r = philox(env);
     if (r > A) {                /* outside quadrant 1 */
       if (r <= A + B)           /* in quadrant 2 */
         j |= bit;
@@ -95,10 +99,10 @@ rmat_edge (int64_t * iout, int64_t * jout,
       So the new probabilities are *not* the old +/- 10% but
       instead the old +/- 5%.
     */
-    A *= (9.5 + dxor128(env)) / 10;
-    B *= (9.5 + dxor128(env)) / 10;
-    C *= (9.5 + dxor128(env)) / 10;
-    D *= (9.5 + dxor128(env)) / 10;
+    A *= (9.5 + philox(env)) / 10;
+    B *= (9.5 + philox(env)) / 10;
+    C *= (9.5 + philox(env)) / 10;
+    D *= (9.5 + philox(env)) / 10;
     /* Used 5 random numbers. */
 
     {
@@ -117,18 +121,67 @@ rmat_edge (int64_t * iout, int64_t * jout,
   *jout = j;
 }
 
+/* Order-sensitive fingerprint of n 64-bit words that sit at word offset
+   first of a file.  Words are mixed with their offset and summed, so the
+   result does not depend on how the loop is split across threads. */
+static uint64_t
+fingerprint (const uint64_t * w, uint64_t n, uint64_t first)
+{
+  uint64_t sum = 0;
+
+  #pragma omp parallel for reduction(+:sum)
+  for(uint64_t k = 0; k < n; k++) {
+    uint64_t z = w[k] + (first + k) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    sum += z ^ (z >> 31);
+  }
+  return sum;
+}
+
+/* Fingerprint of a whole file, as printed when it was generated */
+static uint64_t
+fingerprint_file (const char * name)
+{
+  FILE * fp;
+  NULLCHECK(fp = fopen(name, "r"));
+  fseek(fp, 0, SEEK_END);
+  uint64_t n = ftell(fp) / sizeof(uint64_t);
+  fseek(fp, 0, SEEK_SET);
+
+  uint64_t * w;
+  NULLCHECK(w = malloc(sizeof(uint64_t) * (n ? n : 1)));
+  if(n)
+    ZEROCHECK(fread(w, sizeof(uint64_t), n, fp));
+  fclose(fp);
+
+  uint64_t rtn = fingerprint(w, n, 0);
+  free(w);
+  return rtn;
+}
+
+/* Is action a an insertion?  Decided by the first number of its stream. */
+static int
+action_is_insert (uint64_t seed, uint64_t a, double P_delete)
+{
+  philox_env_t env;
+  philox_seed(&env, seed, RNG_ACTION, a);
+  return philox(&env) > P_delete;
+}
+
 
 
 int main(int argc, char *argv[]) {
   uint64_t SCALE = 20;
   uint64_t EDGEFACTOR = 8;
   uint64_t NUM_ACTIONS = 100000;
+  uint64_t SEED = 1;
 
-  uint64_t nv, ne;
+  uint64_t nv, ne, ne_gen;
   uint64_t * src, * dst;
   uint64_t * off, * of2, * ind, * in2, * wgt, * wg2;
 
-  int64_t * actions, a_count = 0;
+  int64_t * actions;
 
   double A = 0.55;
   double B = 0.1;
@@ -144,7 +197,7 @@ int main(int argc, char *argv[]) {
   FILE * fp_graph, * fp_actions;
 
   int c;
-  while(-1 != (c = getopt(argc, argv, "s:S:e:E:n:N:g:G:a:A:"))) {
+  while(-1 != (c = getopt(argc, argv, "s:S:e:E:n:N:g:G:a:A:r:R:f:F:"))) {
     switch(c) {
       case 's':
       case 'S':
@@ -166,6 +219,15 @@ int main(int argc, char *argv[]) {
       case 'G':
 	graph_file = optarg;
       break;
+      case 'r':
+      case 'R':
+	SEED = strtoull(optarg, NULL, 0);
+      break;
+      case 'f':
+      case 'F':
+	printf("0x%016lx\n", fingerprint_file(optarg));
+	exit(0);
+      break;
       case '?':
 	printf(
 	  "Options: \n"
@@ -173,7 +235,9 @@ int main(int argc, char *argv[]) {
 	  "   -e EDGEFACTOR\n" 
 	  "   -n NUM_ACTIONS\n" 
 	  "   -g GRAPH_NAME\n" 
-	  "   -a ACTIONS_NAME\n");
+	  "   -a ACTIONS_NAME\n"
+	  "   -r SEED\n"
+	  "   -f FILE (print the fingerprint of a generated file and exit)\n");
 	exit(-1);
       break;
     }
@@ -195,6 +259,7 @@ int main(int argc, char *argv[]) {
   printf("%18s : %ld,\n", "SCALE", SCALE);
   printf("%18s : %ld,\n", "EDGEFACTOR", EDGEFACTOR);
   printf("%18s : %ld,\n", "NUM_ACTIONS", NUM_ACTIONS);
+  printf("%18s : %ld,\n", "SEED", SEED);
   printf("%18s : %lf,\n", "A", A);
   printf("%18s : %lf,\n", "B", B);
   printf("%18s : %lf,\n", "C", C);
@@ -208,25 +273,23 @@ int main(int argc, char *argv[]) {
   NULLCHECK(src = malloc(sizeof(uint64_t) * ne * 2));
   NULLCHECK(dst = malloc(sizeof(uint64_t) * ne * 2));
 
-  /* Generate edges */
+  /* Generate edges, each from its own stream so that the output does not
+     depend on the number of threads */
   tic();
-  #pragma omp parallel
-  {
-    dxor128_env_t env;
-    dxor128_seed(&env, omp_get_thread_num());
-
-    #pragma omp for
-    for(uint64_t e = 0; e < ne; e++) {
-      rmat_edge (&(src[e]), &(dst[e]), SCALE, A, B, C, D, &env);
-
-      /* add reverse edge */
-      src[e + ne] = dst[e];
-      dst[e + ne] = src[e];
-    }
+  #pragma omp parallel for
+  for(uint64_t e = 0; e < ne; e++) {
+    philox_env_t env;
+    philox_seed(&env, SEED, RNG_EDGE, e);
+    rmat_edge (&(src[e]), &(dst[e]), SCALE, A, B, C, D, &env);
+
+    /* add reverse edge */
+    src[e + ne] = dst[e];
+    dst[e + ne] = src[e];
   }
 
   /* for reverse edges on the end */
   ne *= 2;
+  ne_gen = ne;
 
   printf("%18s : %lf,\n", "Generation", toc());
 
@@ -273,13 +336,13 @@ int main(int argc, char *argv[]) {
 
   #pragma omp parallel for
   for(uint64_t v = 0; v < nv; v++) {
-    qsort(off + v, off[v+1] - off[v], sizeof(uint64_t), i64_cmp); 
+    qsort(ind + off[v], off[v+1] - off[v], sizeof(uint64_t), i64_cmp); 
     int64_t cur = off[v];
     int64_t last = off[v];
 
     while(cur < off[v+1]) {
       int64_t weight = 1;
-      while(ind[cur] == ind[cur+weight] && cur + weight < off[v+1]) {
+      while(cur + weight < off[v+1] && ind[cur] == ind[cur+weight]) {
 	weight++;
       }
       ind[last] = ind[cur];
@@ -326,46 +389,59 @@ int main(int argc, char *argv[]) {
   ZEROCHECK(fwrite(wg2, sizeof(uint64_t), ne, fp_graph));
 
   fclose(fp_graph);
+
+  uint64_t header[3] = {endian_check, nv, ne};
+  uint64_t graph_fp = fingerprint(header, 3, 0) + fingerprint(of2, nv+1, 3) +
+    fingerprint(in2, ne, nv+4) + fingerprint(wg2, ne, nv+4+ne);
+
   free(off); free(ind); free(wgt);
   free(of2); free(in2); free(wg2);
 
   printf("%18s : %lf,\n", "Graph file write", toc());
+  printf("%18s : \"0x%016lx\",\n", "graph_fingerprint", graph_fp);
 
   /* Begin actions */
   tic();
 
   NULLCHECK(actions = malloc(2 * NUM_ACTIONS * sizeof(int64_t)));
 
-  #pragma omp parallel
-  {
-    dxor128_env_t env;
-
-    /* seed with + nv to get different seeds than above */
-    dxor128_seed(&env, omp_get_thread_num() + nv);
+  /* Insertions first.  Action a draws from its own stream, and its first
+     number decides whether it is an insertion. */
+  #pragma omp parallel for
+  for(uint64_t a = 0; a < NUM_ACTIONS; a++) {
+    philox_env_t env;
+    philox_seed(&env, SEED, RNG_ACTION, a);
+    if(philox(&env) > P_delete) {
+      do {
+	rmat_edge (&(actions[a*2]), &(actions[a*2+1]), SCALE, A, B, C, D, &env);
+      } while (actions[a*2] == actions[a*2+1]);
+    }
+  }
 
-    #pragma omp for
-    for(uint64_t a = 0; a < NUM_ACTIONS; a++) {
-      uint64_t place = stinger_int64_fetch_add(&a_count, 1);
-      if(dxor128(&env) > P_delete) {
-	do {
-	  rmat_edge (&(actions[place*2]), &(actions[place*2+1]), SCALE, A, B, C, D, &env);
-	} while (actions[place*2] == actions[place*2+1]);
+  /* Then deletions, each of a generated edge or of an earlier insertion.
+     Insertions are all in place by now, so the choice is deterministic. */
+  #pragma omp parallel for
+  for(uint64_t a = 0; a < NUM_ACTIONS; a++) {
+    philox_env_t env;
+    philox_seed(&env, SEED, RNG_ACTION, a);
+    if(philox(&env) > P_delete)
+      continue;
+
+    int64_t done = 0;
+    while(!done) {
+      uint64_t source = philox(&env) * (ne_gen + a);
+      if(source < ne_gen) {
+	if(src[source] != dst[source]) {
+	  actions[a*2] = ~src[source];
+	  actions[a*2+1] = ~dst[source];
+	  done = 1;
+	}
       } else {
-	int64_t done = 0;
-	while(!done) {
-	  uint64_t source = dxor128(&env) * (ne + a_count);
-	  if(source < ne) {
-	    actions[place*2] = ~src[source];
-	    actions[place*2+1] = ~dst[source];
-	    done = 1;
-	  } else {
-	    source -= ne;
-	    if(actions[source*2] > 0) {
-	      actions[place*2] = ~actions[source*2];
-	      actions[place*2+1] = ~actions[source*2+1];
-	      done = 1;
-	    }
-	  }
+	source -= ne_gen;
+	if(action_is_insert(SEED, source, P_delete)) {
+	  actions[a*2] = ~actions[source*2];
+	  actions[a*2+1] = ~actions[source*2+1];
+	  done = 1;
 	}
       }
     }
@@ -381,5 +457,11 @@ int main(int argc, char *argv[]) {
   ZEROCHECK(fwrite(actions, sizeof(uint64_t), NUM_ACTIONS * 2, fp_actions));
 
   fclose(fp_actions);
+
+  uint64_t actions_header[2] = {endian_check, NUM_ACTIONS};
+  uint64_t actions_fp = fingerprint(actions_header, 2, 0) +
+    fingerprint((uint64_t *)actions, NUM_ACTIONS * 2, 2);
+
   printf("%18s : %lf,\n", "Write actions", toc());
+  printf("%18s : \"0x%016lx\",\n", "actions_fingerprint", actions_fp);
 }
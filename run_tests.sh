@@ -33,6 +33,10 @@ for g in $graphs
 	    echo "Running Graph: $g, Framework: $f Start Time: $(date '+%Y/%m/%d %H:%M:%S')..."
 	    outfile=$cwd/$resultsdir/$run.$f.$g
 	    sh sysinfo.sh > $outfile
+	    echo "\"input\" : {
+  \"graph_fingerprint\" : \"$($cwd/rmatter/rmatter -f $cwd/$graphdir/$g.g)\",
+  \"actions_fingerprint\" : \"$($cwd/rmatter/rmatter -f $cwd/$graphdir/$g.a)\"
+}" >> $outfile
 	    cd $testdir/$f; sh runme.sh $cwd/$graphdir/$g.g $cwd/$graphdir/$g.a >> $outfile; cd $cwd
 	    echo "  done."
 	  fi
@@ -0,0 +1,334 @@
+#include  <cstdio>
+#include  <algorithm>
+#include  <iterator>
+#include  <vector>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include  "boost/graph/graph_traits.hpp"
+#include  "boost/graph/compressed_sparse_row_graph.hpp"
+#include  "bgl_omp.hpp"
+
+extern "C" {
+#include  "timer.h"
+#include  "replay.h"
+#include  "graph500.h"
+}
+
+#define E_A(X,...) fprintf(stderr, "%s %s %d:\n\t" #X "\n", __FILE__, __func__, __LINE__, __VA_ARGS__); exit(-1);
+#define E(X) E_A(X,NULL)
+#define V_A(X,...) fprintf(stdout, "%s %s %d:\n\t" #X "\n", __FILE__, __func__, __LINE__, __VA_ARGS__);
+#define V(X) V_A(X,NULL)
+#define R_A(X,...) fprintf(stdout, "RSLT: " X, __VA_ARGS__);
+#define R(X) R_A(X,NULL)
+
+using namespace boost;
+
+struct EdgeWeight {
+  int64_t weight;
+  EdgeWeight(int64_t w = 0) : weight(w) { }
+};
+
+/* The input is symmetric, so a directed CSR holds both directions of each
+   undirected edge, as STINGER and the MTGL CSR do. */
+typedef compressed_sparse_row_graph<directedS, no_property, EdgeWeight> Graph;
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ *
+ * CSR EDGE ITERATOR
+ * Walks the rmatter off/ind arrays as (source, target) pairs in order, which
+ * is what the edges_are_sorted constructor consumes, so the graph is built
+ * in one pass without an intermediate edge list.
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+class csr_edge_iterator {
+  public:
+    typedef std::input_iterator_tag iterator_category;
+    typedef std::pair<int64_t, int64_t> value_type;
+    typedef ptrdiff_t difference_type;
+    typedef const value_type * pointer;
+    typedef const value_type & reference;
+
+    csr_edge_iterator(const int64_t * off, const int64_t * ind, int64_t nv, int64_t i) :
+      off(off), ind(ind), nv(nv), v(0), i(i) {
+      skip();
+    }
+
+    reference operator*() const { return cur; }
+    pointer operator->() const { return &cur; }
+
+    csr_edge_iterator & operator++() {
+      i++;
+      skip();
+      return *this;
+    }
+
+    bool operator==(const csr_edge_iterator & other) const { return i == other.i; }
+    bool operator!=(const csr_edge_iterator & other) const { return i != other.i; }
+
+  private:
+    void skip() {
+      while(v < nv && off[v+1] <= i)
+	v++;
+      if(v < nv)
+	cur = value_type(v, ind[i]);
+    }
+
+    const int64_t * off;
+    const int64_t * ind;
+    int64_t nv;
+    int64_t v;
+    int64_t i;
+    value_type cur;
+};
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ *
+ * MUTABLE OVERLAY
+ * The CSR cannot change, so updates are recorded per vertex beside it.  An
+ * edge is present if it is in the CSR and not in removed, or if it is in
+ * added.  The static kernels run on the CSR alone.
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+struct csr_overlay {
+  Graph * g;
+  std::vector< std::vector<int64_t> > added;
+  std::vector< std::vector<int64_t> > removed;
+};
+
+static bool
+csr_has_edge(const Graph & g, int64_t i, int64_t j) {
+  Graph::adjacency_iterator adjIt, adjEnd; tie(adjIt, adjEnd) = adjacent_vertices((Graph::vertex_descriptor)i, g);
+  return std::binary_search(adjIt, adjEnd, (Graph::vertex_descriptor)j);
+}
+
+static bool
+erase_value(std::vector<int64_t> & list, int64_t x) {
+  std::vector<int64_t>::iterator it = std::find(list.begin(), list.end(), x);
+  if(it == list.end())
+    return false;
+  *it = list.back();
+  list.pop_back();
+  return true;
+}
+
+static void
+overlay_insert(csr_overlay & o, int64_t i, int64_t j) {
+  if(csr_has_edge(*o.g, i, j)) {
+    erase_value(o.removed[i], j);
+  } else if(std::find(o.added[i].begin(), o.added[i].end(), j) == o.added[i].end()) {
+    o.added[i].push_back(j);
+  }
+}
+
+static void
+overlay_remove(csr_overlay & o, int64_t i, int64_t j) {
+  if(erase_value(o.added[i], j))
+    return;
+  if(csr_has_edge(*o.g, i, j) &&
+     std::find(o.removed[i].begin(), o.removed[i].end(), j) == o.removed[i].end()) {
+    o.removed[i].push_back(j);
+  }
+}
+
+static void
+graph500_bfs(void * ctx, int64_t root, int64_t * parent) {
+  Graph & g = *(Graph *)ctx;
+
+  bgl_omp::bfs(g, root, parent);
+}
+
+static void
+apply_actions(void * ctx, const int64_t * actions, int64_t na, int64_t first) {
+  csr_overlay & o = *(csr_overlay *)ctx;
+
+  for(uint64_t a = 0; a < na; a++) {
+    int64_t i = actions[2*a];
+    int64_t j = actions[2*a+1];
+
+    /* is insertion? */
+    if(i >= 0) {
+      overlay_insert(o, i, j);
+      overlay_insert(o, j, i);
+    } else {
+      i = ~i;
+      j = ~j;
+      overlay_remove(o, i, j);
+      overlay_remove(o, j, i);
+    }
+  }
+}
+
+int main(int argc, char *argv[]) {
+  if(argc < 3) {
+    E_A(Not enough arguments. Usage %s graphfile actionsfile, argv[0]);
+  }
+
+  R("{\n")
+  R("\"type\":\"boost-csr\",\n")
+
+  FILE * fp = fopen(argv[1], "r");
+
+  int64_t nv;
+  int64_t ne;
+  int64_t * off, * ind, * wgt;
+
+  const uint64_t endian_check = 0x1234ABCDul;
+  uint64_t check;
+
+  fread(&check, sizeof(uint64_t), 1, fp);
+
+  if(check != endian_check) {
+    E(Endianness does not agree.  Order swapping not implemented.);
+  }
+
+  fread(&nv, sizeof(int64_t), 1, fp);
+  fread(&ne, sizeof(int64_t), 1, fp);
+
+  off = (int64_t *)malloc(sizeof(int64_t) * (nv+1));
+  ind = (int64_t *)malloc(sizeof(int64_t) * ne);
+  wgt = (int64_t *)malloc(sizeof(int64_t) * ne);
+
+  fread(off, sizeof(int64_t), nv+1, fp);
+  fread(ind, sizeof(int64_t), ne, fp);
+  fread(wgt, sizeof(int64_t), ne, fp);
+
+  fclose(fp);
+
+  R_A("\"nv\":%ld,\n", nv)
+  R_A("\"ne\":%ld,\n", ne)
+  R("\"results\": {\n")
+
+  V(Creating graph...);
+
+  tic();
+  V(Loading data into graph...);
+  Graph g(edges_are_sorted,
+	  csr_edge_iterator(off, ind, nv, 0), csr_edge_iterator(off, ind, nv, ne),
+	  wgt, nv, ne);
+
+  double build_time = toc();
+  R("\"build\": {\n")
+  R("\"name\":\"boost-csr\",\n")
+  R_A("\"time\":%le\n", build_time)
+  R("},\n")
+
+  free(wgt);
+
+  V(Shiloach-Vishkin  Connected components...)
+  int64_t * components = (int64_t *)malloc(sizeof(int64_t) * nv);
+
+  tic();
+  bgl_omp::shiloach_vishkin(g, components);
+
+  double sv_time = toc();
+
+  R("\"sv\": {\n")
+  R("\"name\":\"boost-csr\",\n")
+  R_A("\"time\":%le\n", sv_time)
+  R("},\n")
+
+  printf("\tDone %lf\n", sv_time);
+
+  V(Afforest Connected components...)
+  tic();
+  bgl_omp::afforest(g, components);
+  double afforest_time = toc();
+
+  R("\"afforest\": {\n")
+  R("\"name\":\"boost-csr\",\n")
+  R_A("\"time\":%le\n", afforest_time)
+  R("},\n")
+
+  printf("\tDone %lf\n", afforest_time);
+  free(components);
+
+  V(BFS...);
+  graph500_result_t bfs_result;
+  graph500_run(off, ind, nv, graph500_bfs, &g, &bfs_result);
+  double sssv_time = bfs_result.time_mean;
+
+  R("\"sssp\": {\n")
+  R("\"name\":\"boost-csr\",\n")
+  R_A("\"time\":%le\n", sssv_time)
+  R("},\n")
+  graph500_report("boost-csr", &bfs_result);
+
+  printf("\tDone %lf\n", sssv_time);
+
+  free(off); free(ind);
+
+  V(PageRank...);
+  tic();
+
+  std::vector<double> pr(nv);
+  bgl_omp::pagerank(g, &pr[0], 0.85, 1e-8, 100);
+
+  double pr_time = toc();
+
+  R("\"pr\": {\n")
+  R("\"name\":\"boost-csr\",\n")
+  R_A("\"time\":%le\n", pr_time)
+  R("},\n")
+
+  printf("\tDone %lf\n", pr_time);
+
+  V(Reading actions...)
+  tic();
+
+  fp = fopen(argv[2], "r");
+
+  int64_t na;
+  int64_t * actions;
+
+  fread(&check, sizeof(uint64_t), 1, fp);
+
+  if(check != endian_check) {
+    E(Endianness does not agree.  Order swapping not implemented.);
+  }
+
+  fread(&na, sizeof(int64_t), 1, fp);
+
+  actions = (int64_t *)malloc(sizeof(int64_t) * na*2);
+
+  fread(actions, sizeof(int64_t), na*2, fp);
+
+  fclose(fp);
+
+  printf("\t%ld actions read\n", na);
+
+  printf("\tDone %lf\n", toc());
+
+  V(Insert / remove...)
+  csr_overlay overlay;
+  overlay.g = &g;
+  overlay.added.resize(nv);
+  overlay.removed.resize(nv);
+
+  replay_config_t replay;
+  double eps;
+
+  if(replay_config_from_env(&replay)) {
+    replay_result_t rr;
+    replay_measure(&replay, actions, na, apply_actions, &overlay, &rr);
+    replay_report("boost-csr", &rr);
+    na = rr.actions;
+    eps = rr.achieved;
+  } else {
+    tic();
+    apply_actions(&overlay, actions, na, 0);
+    eps = na / toc();
+  }
+
+  R("\"update\": {\n")
+  R("\"name\":\"boost-csr\",\n")
+  R_A("\"time\":%le\n", eps)
+  R("}\n")
+  R("},\n")
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+
+  R_A("\"na\":%ld,\n", na)
+  R_A("\"mem\":%ld\n", usage.ru_maxrss)
+  R("}\n")
+
+  printf("\tDone %lf\n", eps);
+  free(actions);
+}
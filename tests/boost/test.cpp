@@ -5,10 +5,12 @@
 #include  "boost/graph/graph_traits.hpp"
 #include  "boost/graph/adjacency_list.hpp"
 #include  "boost/graph/undirected_graph.hpp"
-#include  "boost/graph/breadth_first_search.hpp"
+#include  "bgl_omp.hpp"
 
 extern "C" {
 #include  "timer.h"
+#include  "replay.h"
+#include  "graph500.h"
 }
 
 #define E_A(X,...) fprintf(stderr, "%s %s %d:\n\t" #X "\n", __FILE__, __func__, __LINE__, __VA_ARGS__); exit(-1);
@@ -20,6 +22,36 @@ extern "C" {
 
 using namespace boost;
 
+typedef adjacency_list<vecS, vecS, undirectedS> Graph;
+
+static void
+graph500_bfs(void * ctx, int64_t root, int64_t * parent) {
+  Graph & g = *(Graph *)ctx;
+
+  bgl_omp::bfs(g, root, parent);
+}
+
+static void
+apply_actions(void * ctx, const int64_t * actions, int64_t na, int64_t first) {
+  Graph & g = *(Graph *)ctx;
+
+  for(uint64_t a = 0; a < na; a++) {
+    int64_t i = actions[2*a];
+    int64_t j = actions[2*a+1];
+
+    /* is insertion? */
+    if(i >= 0) {
+      add_edge(i, j, g);
+      add_edge(j, i, g);
+    } else {
+      i = ~i;
+      j = ~j;
+      remove_edge(i, j, g);
+      remove_edge(j, i, g);
+    }
+  }
+}
+
 int main(int argc, char *argv[]) {
   if(argc < 3) {
     E_A(Not enough arguments. Usage %s graphfile actionsfile, argv[0]);
@@ -62,8 +94,6 @@ int main(int argc, char *argv[]) {
 
   V(Creating graph...);
 
-  typedef adjacency_list<vecS, vecS, undirectedS> Graph;
-
   Graph g(nv);
 
   tic();
@@ -80,37 +110,13 @@ int main(int argc, char *argv[]) {
   R_A("\"time\":%le\n", build_time)
   R("},\n")
 
-  free(off); free(ind); free(wgt);
+  free(wgt);
 
   V(Shiloach-Vishkin  Connected components...)
   int64_t * components = (int64_t *)malloc(sizeof(int64_t) * nv);
 
   tic();
-  for(uint64_t v = 0; v < nv; v++) {
-    components[v] = v;
-  }
-
-  while(1) {
-    uint64_t changed = 0;
-
-    Graph::edge_iterator edgesIt, edgesEnd; tie(edgesIt, edgesEnd) = edges(g);
-
-    for(; edgesIt != edgesEnd; ++edgesIt) {
-      if (components[target(*edgesIt,g)] <
-	  components[source(*edgesIt,g)]) {
-	components[source(*edgesIt,g)] = components[target(*edgesIt,g)];
-	changed++;
-      }
-    }
-
-    if(!changed)
-      break;
-
-    for (uint64_t i = 0; i < nv; i++) {
-      while (components[i] != components[components[i]])
-	components[i] = components[components[i]];
-    }
-  }
+  bgl_omp::shiloach_vishkin(g, components);
 
   double sv_time = toc();
 
@@ -120,72 +126,40 @@ int main(int argc, char *argv[]) {
   R("},\n")
 
   printf("\tDone %lf\n", sv_time);
-  free(components);
 
-  V(BFS...);
+  V(Afforest Connected components...)
   tic();
+  bgl_omp::afforest(g, components);
+  double afforest_time = toc();
 
-  graph_traits<Graph>::vertices_size_type * d = new graph_traits<Graph>::vertices_size_type[nv];
-  std::fill_n(d, nv, 0);
+  R("\"afforest\": {\n")
+  R("\"name\":\"boost-std\",\n")
+  R_A("\"time\":%le\n", afforest_time)
+  R("},\n")
 
-  breadth_first_search(g, 0, visitor(make_bfs_visitor(record_distances(d, on_tree_edge()))));
+  printf("\tDone %lf\n", afforest_time);
+  free(components);
 
-  double sssv_time = toc();
+  V(BFS...);
+  graph500_result_t bfs_result;
+  graph500_run(off, ind, nv, graph500_bfs, &g, &bfs_result);
+  double sssv_time = bfs_result.time_mean;
 
   R("\"sssp\": {\n")
   R("\"name\":\"boost-std\",\n")
   R_A("\"time\":%le\n", sssv_time)
   R("},\n")
+  graph500_report("boost-std", &bfs_result);
 
   printf("\tDone %lf\n", sssv_time);
 
-  delete[] d;
+  free(off); free(ind);
 
   V(PageRank...);
   tic();
 
-  std::vector<double> tmp_pr(nv);
   std::vector<double> pr(nv);
-  double epsilon = 1e-8;
-  double dampingfactor = 0.85;
-  int64_t maxiter = 100;
-
-  std::fill_n(pr.begin(), nv, 1/((double)nv));
-
-  int64_t iter = maxiter;
-  double delta = 1;
-
-  while(delta > epsilon && iter > 0) {
-    Graph::vertex_iterator vtxIt, vtxEnd; tie(vtxIt, vtxEnd) = vertices(g);
-    for(; vtxIt != vtxEnd; ++vtxIt++) {
-      tmp_pr[*vtxIt] = 0;
-
-      Graph::out_edge_iterator edgesIt, edgesEnd; 
-
-      tie(edgesIt, edgesEnd) = out_edges(Graph::vertex_descriptor(*vtxIt), g);
-      for(; edgesIt != edgesEnd; ++edgesIt) {
-	tmp_pr[source(*edgesIt,g)] += (((double)pr[target(*edgesIt, g)]) / 
-	  ((double) out_degree(target(*edgesIt, g), g)));
-      }
-    }
-
-    for(uint64_t v = 0; v < nv; v++) {
-      tmp_pr[v] = tmp_pr[v] * dampingfactor + (((double)(1-dampingfactor)) / ((double)nv));
-    }
-
-    delta = 0;
-    for(uint64_t v = 0; v < nv; v++) {
-      double mydelta = tmp_pr[v] - pr[v];
-
-      if(mydelta < 0)
-	mydelta = -mydelta;
-
-      delta += mydelta;
-      pr[v] = tmp_pr[v];
-    }
-
-    iter--;
-  }
+  bgl_omp::pagerank(g, &pr[0], 0.85, 1e-8, 100);
 
   double pr_time = toc();
 
@@ -223,26 +197,21 @@ int main(int argc, char *argv[]) {
   printf("\tDone %lf\n", toc());
 
   V(Insert / remove...)
-  tic();
-
-  for(uint64_t a = 0; a < na; a++) {
-    int64_t i = actions[2*a];
-    int64_t j = actions[2*a+1];
-
-    /* is insertion? */
-    if(i >= 0) {
-      add_edge(i, j, g);
-      add_edge(j, i, g);
-    } else {
-      i = ~i;
-      j = ~j;
-      remove_edge(i, j, g);
-      remove_edge(j, i, g);
-    }
+  replay_config_t replay;
+  double eps;
+
+  if(replay_config_from_env(&replay)) {
+    replay_result_t rr;
+    replay_measure(&replay, actions, na, apply_actions, &g, &rr);
+    replay_report("boost-std", &rr);
+    na = rr.actions;
+    eps = rr.achieved;
+  } else {
+    tic();
+    apply_actions(&g, actions, na, 0);
+    eps = na / toc();
   }
 
-  double eps = na / toc();
-
   R("\"update\": {\n")
   R("\"name\":\"boost-std\",\n")
   R_A("\"time\":%le\n", eps)
@@ -10,10 +10,12 @@
 #include  <algorithm>
 #include <sys/time.h>
 #include <sys/resource.h>
-#include  <map>
+#include  <vector>
 
 extern "C" {
 #include  "timer.h"
+#include  "replay.h"
+#include  "graph500.h"
 }
 
 #define E_A(X,...) fprintf(stderr, "%s %s %d:\n\t" #X "\n", __FILE__, __func__, __LINE__, __VA_ARGS__); exit(-1);
@@ -31,6 +33,142 @@ using namespace dex::algorithms;
 typedef long int int64;
 typedef long unsigned int uint64;
 
+/* Open-addressing map from DEX oids to dense vertex ids, filled once after
+   the load so the kernels can keep their state in flat arrays. */
+struct dense_index {
+  std::vector<oid_t> keys;
+  std::vector<int64> vals;
+  uint64 mask;
+
+  dense_index(const oid_t * vertices, int64 nv) {
+    uint64 size = 2;
+    while(size < (uint64)(2 * nv))
+      size <<= 1;
+    keys.assign(size, Objects::InvalidOID);
+    vals.assign(size, -1);
+    mask = size - 1;
+
+    for(int64 v = 0; v < nv; v++) {
+      uint64 s = slot(vertices[v]);
+      while(keys[s] != Objects::InvalidOID)
+	s = (s + 1) & mask;
+      keys[s] = vertices[v];
+      vals[s] = v;
+    }
+  }
+
+  uint64 slot(oid_t oid) const {
+    uint64 h = (uint64)oid * 0x9E3779B97F4A7C15ul;
+    return (h ^ (h >> 32)) & mask;
+  }
+
+  int64 operator[](oid_t oid) const {
+    for(uint64 s = slot(oid); keys[s] != Objects::InvalidOID; s = (s + 1) & mask) {
+      if(keys[s] == oid)
+	return vals[s];
+    }
+    return -1;
+  }
+};
+
+/* Dense ids of v's neighbors, fetched with one Neighbors call rather than an
+   EdgeData lookup per edge. */
+static void
+dense_neighbors(Graph * graph, type_t edgeType, const dense_index & index,
+		oid_t v, std::vector<int64> & out) {
+  out.clear();
+  Objects * neighborObjects = graph->Neighbors(v, edgeType, Outgoing);
+  ObjectsIterator * neighbor = neighborObjects->Iterator();
+  while(neighbor->HasNext())
+    out.push_back(index[neighbor->Next()]);
+  delete neighbor;
+  delete neighborObjects;
+}
+
+struct graph500_ctx {
+  Session * sess;
+  oid_t * vertices;
+  const dense_index * index;
+  int64 * off, * ind;
+  int64 nv;
+  int64 * depth;
+};
+
+/* DEX's traversal reports depths rather than parents, so the parent array is
+   rebuilt from the depths and the input graph */
+static void
+graph500_bfs(void * ctx, int64_t root, int64_t * parent) {
+  graph500_ctx * c = (graph500_ctx *)ctx;
+
+  std::fill_n(c->depth, c->nv, -1);
+  {
+    TraversalBFS bfs(*c->sess, c->vertices[root]);
+    bfs.AddAllEdgeTypes(Outgoing);
+    bfs.AddAllNodeTypes();
+    while(bfs.HasNext()) {
+      oid_t cur = bfs.Next();
+      c->depth[(*c->index)[cur]] = bfs.GetCurrentDepth();
+    }
+  }
+
+  graph500_parents_from_depth(c->off, c->ind, c->nv, root, c->depth, parent);
+}
+
+struct update_ctx {
+  Graph * graph;
+  type_t vtxType, edgeType;
+  attr_t edgeWeightType;
+  Value * value;
+  oid_t * vertices;
+};
+
+static void
+apply_actions(void * ctx, const int64_t * actions, int64_t na, int64_t first) {
+  update_ctx * c = (update_ctx *)ctx;
+
+  for(int64 a = 0; a < na; a++) {
+    int64 i = actions[2*a];
+    int64 j = actions[2*a+1];
+
+    /* is insertion? */
+    if(i >= 0) {
+      if(c->vertices[i] == -1) {
+	c->vertices[i] = c->graph->NewNode(c->vtxType);
+      }
+      if(c->vertices[j] == -1) {
+	c->vertices[j] = c->graph->NewNode(c->vtxType);
+      }
+      oid_t edge = c->graph->FindEdge(c->edgeType, c->vertices[i], c->vertices[j]);
+      if(Objects::InvalidOID !=  edge) {
+	c->graph->GetAttribute(edge, c->edgeWeightType, *c->value);
+	c->value->SetLong(c->value->GetLong()+1);
+	c->graph->SetAttribute(edge, c->edgeWeightType, *c->value);
+      } else {
+	edge = c->graph->NewEdge(c->edgeType, c->vertices[i], c->vertices[j]);
+	c->graph->SetAttribute(edge, c->edgeWeightType, c->value->SetLong(1));
+      }
+      edge = c->graph->FindEdge(c->edgeType, c->vertices[j], c->vertices[i]);
+      if(Objects::InvalidOID !=  edge) {
+	c->graph->GetAttribute(edge, c->edgeWeightType, *c->value);
+	c->value->SetLong(c->value->GetLong()+1);
+	c->graph->SetAttribute(edge, c->edgeWeightType, *c->value);
+      } else {
+	edge = c->graph->NewEdge(c->edgeType, c->vertices[j], c->vertices[i]);
+	c->graph->SetAttribute(edge, c->edgeWeightType, c->value->SetLong(1));
+      }
+    } else {
+      i = ~i;
+      j = ~j;
+      if(c->vertices[i] != -1 && c->vertices[j] != -1) {
+	oid_t edge = c->graph->FindEdge(c->edgeType, c->vertices[i], c->vertices[j]);
+	if(Objects::InvalidOID !=  edge) {
+	  c->graph->Drop(edge);
+	}
+      }
+    }
+  }
+}
+
 int main(int argc, char *argv[])
 {
   if(argc < 3) {
@@ -58,7 +196,7 @@ int main(int argc, char *argv[])
   fread(&nv, sizeof(int64), 1, fp);
   fread(&ne, sizeof(int64), 1, fp);
 
-  off = (int64 *)malloc(sizeof(int64) * nv+1);
+  off = (int64 *)malloc(sizeof(int64) * (nv+1));
   ind = (int64 *)malloc(sizeof(int64) * ne);
   wgt = (int64 *)malloc(sizeof(int64) * ne);
 
@@ -75,7 +213,6 @@ int main(int argc, char *argv[])
   V(Creating graph...);
 
   oid_t * vertices = new oid_t[nv];
-  std::fill_n(vertices, nv, -1);
 
   tic();
   DexConfig cfg;
@@ -86,66 +223,62 @@ int main(int argc, char *argv[])
 
   type_t vtxType = graph->NewNodeType(L"Vertex");
 
-  type_t edgeType = graph->NewEdgeType(L"Edge", false, false);
+  /* materialized neighbors, so Neighbors() is an index lookup */
+  type_t edgeType = graph->NewEdgeType(L"Edge", false, true);
   attr_t edgeWeightType = graph->NewAttribute(edgeType, L"weight", Long, Basic);
 
   Value * value = new Value();
 
+  /* all nodes first, so vertices[] is the dense id -> oid map and the edge
+     pass below never branches on missing endpoints */
   for(int64 v = 0; v < nv; v++) {
-    if(vertices[v] == -1) {
-      vertices[v] = graph->NewNode(vtxType);
-    }
+    vertices[v] = graph->NewNode(vtxType);
+  }
+
+  /* DEX 4.7 has no bulk edge or attribute call outside its CSV loaders,
+     which look endpoints up through an indexed node attribute, so each edge
+     is one NewEdge and one SetAttribute straight from the CSR arrays */
+  for(int64 v = 0; v < nv; v++) {
+    const oid_t head = vertices[v];
     for(int64 i = off[v]; i < off[v+1]; i++) {
-      int64 u = ind[i];
-      if(vertices[u] == -1) {
-	vertices[u] = graph->NewNode(vtxType);
-      }
-      oid_t edge = graph->NewEdge(edgeType, vertices[u], vertices[v]);
+      oid_t edge = graph->NewEdge(edgeType, vertices[ind[i]], head);
       graph->SetAttribute(edge, edgeWeightType, value->SetLong(wgt[i]));
     }
   }
 
+  dense_index index(vertices, nv);
+
   double build_time = toc();
   R("\"build\": {\n")
   R("\"name\":\"dex-std\",\n")
   R_A("\"time\":%le\n", build_time)
   R("},\n")
 
+  free(wgt);
+
 #if 1
   V(Shiloach-Vishkin  Connected components...)
-  std::map<oid_t, int64> components;
+  std::vector<int64> components(nv);
+  std::vector<int64> neighbors;
 
   tic();
-  {
-    Objects * vtxObjects = graph->Select(vtxType);
-    ObjectsIterator * vtx = vtxObjects->Iterator();
-    while(vtx->HasNext()) {
-      oid_t cur = vtx->Next();
-      components[cur] = cur;
-    }
-    delete vtx;
-    delete vtxObjects;
+  for(int64 v = 0; v < nv; v++) {
+    components[v] = v;
   }
 
-  Objects * edgeObjects = graph->Select(edgeType);
   while(1) {
     uint64 changed = 0;
 
-    ObjectsIterator * edges = edgeObjects->Iterator();
-
-    while(edges->HasNext()) {
-      oid_t cur = edges->Next();
-      EdgeData * data = graph->GetEdgeData(cur);
-      if (components[data->GetTail()] <
-	  components[data->GetHead()]) {
-	components[data->GetHead()] = components[data->GetTail()];
-	changed++;
+    for(int64 v = 0; v < nv; v++) {
+      dense_neighbors(graph, edgeType, index, vertices[v], neighbors);
+      for(size_t k = 0; k < neighbors.size(); k++) {
+	if (components[neighbors[k]] < components[v]) {
+	  components[v] = components[neighbors[k]];
+	  changed++;
+	}
       }
-      delete data;
     }
 
-    delete edges;
-
     if(!changed)
       break;
 
@@ -154,7 +287,6 @@ int main(int argc, char *argv[])
 	components[i] = components[components[i]];
     }
   }
-  delete edgeObjects;
 
   double sv_time = toc();
 
@@ -166,101 +298,67 @@ int main(int argc, char *argv[])
   printf("\tDone %lf\n", sv_time);
 
   V(BFS...);
-  tic();
-
-  std::map<oid_t, int64> distance;
-  distance[vertices[0]] = 0;
-  
-  {
-    TraversalBFS bfs(*sess, vertices[0]);
-    bfs.AddAllEdgeTypes(Outgoing);
-    bfs.AddAllNodeTypes();
-    while(bfs.HasNext()) {
-      distance[bfs.Next()] = bfs.GetCurrentDepth();
-    }
-  }
 
-
-  double sssv_time = toc();
+  int64 * depth = new int64[nv];
+  graph500_ctx bfs_ctx = { sess, vertices, &index, off, ind, nv, depth };
+  graph500_result_t bfs_result;
+  graph500_run(off, ind, nv, graph500_bfs, &bfs_ctx, &bfs_result);
+  double sssv_time = bfs_result.time_mean;
+  delete[] depth;
 
   R("\"sssp\": {\n")
   R("\"name\":\"dex-std\",\n")
   R_A("\"time\":%le\n", sssv_time)
   R("},\n")
+  graph500_report("dex-std", &bfs_result);
 
   printf("\tDone %lf\n", sssv_time);
 
   V(PageRank...);
 
-  std::map<oid_t,double> tmp_pr;
-  std::map<oid_t,double> pr;
+  std::vector<double> contrib(nv);
+  std::vector<double> pr(nv);
+  std::vector<int64> degree(nv);
   double epsilon = 1e-8;
   double dampingfactor = 0.85;
   int64 maxiter = 100;
   tic();
 
-  Objects * vtxObjects = graph->Select(vtxType);
-  {
-    ObjectsIterator * vtx = vtxObjects->Iterator();
-    while(vtx->HasNext()) {
-      oid_t cur = vtx->Next();
-      pr[cur] = 1/((double)nv);
-    }
-    delete vtx;
+  for(int64 v = 0; v < nv; v++) {
+    pr[v] = 1/((double)nv);
+    degree[v] = graph->Degree(vertices[v], edgeType, Outgoing);
   }
 
   int64 iter = maxiter;
   double delta = 1;
 
   while(delta > epsilon && iter > 0) {
-    {
-      ObjectsIterator * vtx = vtxObjects->Iterator();
-      while(vtx->HasNext()) {
-	oid_t cur = vtx->Next();
-	tmp_pr[cur] = 0;
-
-	Objects * neighborObjects = graph->Neighbors(cur, edgeType, Outgoing);
-	ObjectsIterator * neighbor = neighborObjects->Iterator();
-	while(neighbor->HasNext()) {
-	  oid_t neigh = neighbor->Next();
-	  tmp_pr[cur] += (pr[neigh] / ((double) graph->Degree(neigh, edgeType, Outgoing)));
-	}
-	delete neighbor;
-	delete neighborObjects;
-      }
-      delete vtx;
+    for(int64 v = 0; v < nv; v++) {
+      contrib[v] = degree[v] ? pr[v] / ((double)degree[v]) : 0;
     }
 
-    {
-      ObjectsIterator * vtx = vtxObjects->Iterator();
-      while(vtx->HasNext()) {
-	oid_t cur = vtx->Next();
-	tmp_pr[cur] = tmp_pr[cur] * dampingfactor + (((double)(1-dampingfactor))/((double)nv));
+    delta = 0;
+    for(int64 v = 0; v < nv; v++) {
+      double sum = 0;
+      dense_neighbors(graph, edgeType, index, vertices[v], neighbors);
+      for(size_t k = 0; k < neighbors.size(); k++) {
+	sum += contrib[neighbors[k]];
       }
-      delete vtx;
-    }
 
-    delta = 0;
-    {
-      ObjectsIterator * vtx = vtxObjects->Iterator();
-      while(vtx->HasNext()) {
-	oid_t cur = vtx->Next();
-	double mydelta = tmp_pr[cur] - pr[cur];
+      sum = sum * dampingfactor + (((double)(1-dampingfactor))/((double)nv));
 
-	if(mydelta < 0)
-	  mydelta = -mydelta;
+      double mydelta = sum - pr[v];
 
-	delta += mydelta;
-	pr[cur] = tmp_pr[cur];
-      }
-      delete vtx;
+      if(mydelta < 0)
+	mydelta = -mydelta;
+
+      delta += mydelta;
+      pr[v] = sum;
     }
 
     iter--;
   }
 
-  delete vtxObjects;
-
   double pr_time = toc();
 
   R("\"pr\": {\n")
@@ -298,57 +396,22 @@ int main(int argc, char *argv[])
   printf("\tDone %lf\n", toc());
 
   V(Insert / remove...)
-  tic();
-
-  if(na > 100000) {
-    V(Due to object limit lowering insert / delete to 100k);
-    na = 100000;
-  }
-
-  for(uint64 a = 0; a < na; a++) {
-    int64 i = actions[2*a];
-    int64 j = actions[2*a+1];
-
-    /* is insertion? */
-    if(i >= 0) {
-      if(vertices[i] == -1) {
-	vertices[i] = graph->NewNode(vtxType);
-      }
-      if(vertices[j] == -1) {
-	vertices[j] = graph->NewNode(vtxType);
-      }
-      oid_t edge = graph->FindEdge(edgeType, vertices[i], vertices[j]);
-      if(Objects::InvalidOID !=  edge) {
-	graph->GetAttribute(edge, edgeWeightType, *value);
-	value->SetLong(value->GetLong()+1);
-	graph->SetAttribute(edge, edgeWeightType, *value);
-      } else {
-	edge = graph->NewEdge(edgeType, vertices[i], vertices[j]);
-	graph->SetAttribute(edge, edgeWeightType, value->SetLong(1));
-      }
-      edge = graph->FindEdge(edgeType, vertices[j], vertices[i]);
-      if(Objects::InvalidOID !=  edge) {
-	graph->GetAttribute(edge, edgeWeightType, *value);
-	value->SetLong(value->GetLong()+1);
-	graph->SetAttribute(edge, edgeWeightType, *value);
-      } else {
-	edge = graph->NewEdge(edgeType, vertices[j], vertices[i]);
-	graph->SetAttribute(edge, edgeWeightType, value->SetLong(1));
-      }
-    } else {
-      i = ~i;
-      j = ~j;
-      if(vertices[i] != -1 && vertices[j] != -1) {
-	oid_t edge = graph->FindEdge(edgeType, vertices[i], vertices[j]);
-	if(Objects::InvalidOID !=  edge) {
-	  graph->Drop(edge);
-	}
-      }
-    }
+  update_ctx update = { graph, vtxType, edgeType, edgeWeightType, value, vertices };
+  replay_config_t replay;
+  double eps;
+
+  if(replay_config_from_env(&replay)) {
+    replay_result_t rr;
+    replay_measure(&replay, actions, na, apply_actions, &update, &rr);
+    replay_report("dex-std", &rr);
+    na = rr.actions;
+    eps = rr.achieved;
+  } else {
+    tic();
+    apply_actions(&update, actions, na, 0);
+    eps = na / toc();
   }
 
-  double eps = na / toc();
-
   R("\"update\": {\n")
   R("\"name\":\"dex-std\",\n")
   R_A("\"time\":%le\n", eps)
@@ -1,15 +1,27 @@
 #include  <cstdio>
 #include  <omp.h>
+#include  <pthread.h>
 #include  <vector>
 #include <sys/time.h>
 #include <sys/resource.h>
 
 #include    "mtgl/adjacency_list.hpp"
+#include    "mtgl/compressed_sparse_row_graph.hpp"
+#include    "mtgl/stinger_graph.hpp"
 #include    "mtgl/breadth_first_search.hpp"
 #include    "mtgl/pagerank.hpp"
+#include    "mtgl/afforest.hpp"
+#include    "mtgl/pseudo_diameter.hpp"
+#include    "mtgl/multi_source_bfs.hpp"
+#include    "mtgl/batch_random_walk.hpp"
+#include    "mtgl/push_relabel_max_flow.hpp"
+#include    "mtgl/graph_coloring.hpp"
+#include    "mtgl/minimum_spanning_forest.hpp"
 
 extern "C" {
 #include  "timer.h"
+#include  "replay.h"
+#include  "graph500.h"
 }
 
 #define E_A(X,...) fprintf(stderr, "%s %s %d:\n\t" #X "\n", __FILE__, __func__, __LINE__, __VA_ARGS__); exit(-1);
@@ -19,8 +31,48 @@ extern "C" {
 #define R_A(X,...) fprintf(stdout, "RSLT: " X, __VA_ARGS__);
 #define R(X) R_A(X,NULL)
 
+#define WALK_LENGTH 20
+
 using namespace mtgl;
 
+typedef adjacency_list<undirectedS> UndirectedGraph;
+
+struct graph_ctx {
+  UndirectedGraph * g;
+  graph_traits<UndirectedGraph>::vertex_iterator verts;
+  pthread_rwlock_t * lock;	/* mixed workload only, else NULL */
+};
+
+/* Removals are skipped, see the insert-only result name below */
+static void
+apply_actions(void * ctx, const int64_t * actions, int64_t na, int64_t first) {
+  UndirectedGraph & g = *((graph_ctx *)ctx)->g;
+  graph_traits<UndirectedGraph>::vertex_iterator verts = ((graph_ctx *)ctx)->verts;
+  pthread_rwlock_t * lock = ((graph_ctx *)ctx)->lock;
+
+  if(lock)
+    pthread_rwlock_wrlock(lock);
+
+  for(uint64_t a = 0; a < na; a++) {
+    int64_t i = actions[2*a];
+    int64_t j = actions[2*a+1];
+
+    /* is insertion? */
+    if(i >= 0) {
+      add_edge(verts[i], verts[j], g);
+      add_edge(verts[j], verts[i], g);
+    } else {
+      i = ~i;
+      j = ~j;
+      //remove_edge(i, j, g);
+      //remove_edge(j, i, g);
+    }
+  }
+
+  if(lock)
+    pthread_rwlock_unlock(lock);
+}
+
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ *
  * REIMPLEMENTATION OF SHILOACH-VISHKIN 
  * I could not get their version to work with their adjacency_list 
@@ -167,25 +219,84 @@ shiloach_vishkin(Graph& g, ComponentMap& result)
 }
 
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ *
- * DISTANCE BFS VISITOR
+ * PARENT BFS VISITOR
+ * Records the Graph500 parent array by vertex ID.
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
-template<typename Graph, typename DistMap>
-class hop_count_bfs_visitor : public default_bfs_visitor<Graph> {
+template<typename Graph>
+class parent_bfs_visitor : public default_bfs_visitor<Graph> {
   public:
     typedef typename graph_traits<Graph>::vertex_descriptor vertex_descriptor;
     typedef typename graph_traits<Graph>::edge_descriptor edge_descriptor;
 
-    hop_count_bfs_visitor(DistMap &d) : dist(d) { }
+    parent_bfs_visitor(int64_t * p, vertex_id_map<Graph> & vm) :
+      parent(p), vid_map(vm) { }
 
     void tree_edge(edge_descriptor & e, Graph & g) {
       vertex_descriptor src = source(e, g);
       vertex_descriptor dst = target(e, g);
 
-      mt_write(dist[dst], dist[src] + 1);
+      parent[get(vid_map, dst)] = get(vid_map, src);
     }
 
   private:
-    DistMap & dist;
+    int64_t * parent;
+    vertex_id_map<Graph> & vid_map;
+};
+
+static void
+graph500_bfs(void * ctx, int64_t root, int64_t * parent) {
+  UndirectedGraph & g = *((graph_ctx *)ctx)->g;
+  vertex_id_map<UndirectedGraph> vid_map = get(_vertex_id_map, g);
+  int64_t n = num_vertices(g);
+
+  #pragma omp parallel for
+  for(int64_t v = 0; v < n; v++)
+    parent[v] = -1;
+  parent[root] = root;
+
+  parent_bfs_visitor<UndirectedGraph> vis(parent, vid_map);
+  breadth_first_search(g, ((graph_ctx *)ctx)->verts[root], vis);
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ *
+ * MIXED WORKLOAD
+ * The adjacency_list has no concurrency control of its own: add_edge may
+ * move an edge list under a reader.  Readers and writers share a
+ * reader-writer lock, each query or kernel run holding it for reading and
+ * each write batch for writing.
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+static void
+mixed_read_begin(void * ctx) {
+  pthread_rwlock_rdlock(((graph_ctx *)ctx)->lock);
+}
+
+static void
+mixed_read_end(void * ctx) {
+  pthread_rwlock_unlock(((graph_ctx *)ctx)->lock);
+}
+
+static int64_t
+mixed_degree(void * ctx, int64_t v) {
+  UndirectedGraph & g = *((graph_ctx *)ctx)->g;
+  return out_degree(((graph_ctx *)ctx)->verts[v], g);
+}
+
+static int64_t
+mixed_neighbors(void * ctx, int64_t v, int64_t * out, int64_t max) {
+  UndirectedGraph & g = *((graph_ctx *)ctx)->g;
+  vertex_id_map<UndirectedGraph> vid_map = get(_vertex_id_map, g);
+  graph_traits<UndirectedGraph>::vertex_descriptor u = ((graph_ctx *)ctx)->verts[v];
+  graph_traits<UndirectedGraph>::adjacency_iterator adjs = adjacent_vertices(u, g);
+  int64_t deg = out_degree(u, g);
+
+  for(int64_t k = 0; k < deg && k < max; k++)
+    out[k] = get(vid_map, adjs[k]);
+  return deg;
+}
+
+static const mixed_ops_t mixed_ops = {
+  NULL, NULL, mixed_read_begin, mixed_read_end,
+  mixed_degree, mixed_neighbors, graph500_bfs, apply_actions
 };
 
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ *
@@ -374,7 +485,7 @@ int main(int argc, char *argv[]) {
   fread(&nv, sizeof(int64_t), 1, fp);
   fread(&ne, sizeof(int64_t), 1, fp);
 
-  off = (int64_t *)malloc(sizeof(int64_t) * nv+1);
+  off = (int64_t *)malloc(sizeof(int64_t) * (nv + 1));
   ind = (int64_t *)malloc(sizeof(int64_t) * ne);
   wgt = (int64_t *)malloc(sizeof(int64_t) * ne);
 
@@ -394,25 +505,41 @@ int main(int argc, char *argv[]) {
   typedef graph_traits<Graph>::size_type size_type;
   typedef graph_traits<Graph>::vertex_iterator vertex_iterator;
 
-  size_type * src = new size_type[ne];
-  size_type * dst = new size_type[ne];
+  /* The other graph types are built first and freed, so they do not add
+     to the peak memory reported for the adjacency_list.  The STINGER
+     structure allocates a full edge block per vertex, so this is opt-in. */
+  double csr_rate = 0, stinger_rate = 0;
+  bool build_rates = getenv("BUILD_RATES") != NULL;
 
-  for(uint64_t e = 0; e < ne; e++) {
-    src[e] = 0;
-    dst[e] = 0;
-  }
+  if(build_rates) {
+    V(Loading data into compressed_sparse_row_graph...);
+    {
+      compressed_sparse_row_graph<undirectedS> csr;
+      tic();
+      init_csr(nv, (size_type *)off, (size_type *)ind, csr);
+      csr_rate = ne / toc();
+    }
 
+    V(Loading data into stinger_graph...);
+    {
+      typedef stinger_graph<int64_t, int64_t, int64_t> StingerGraph;
+      int64_t * vzero = (int64_t *)calloc(nv, sizeof(int64_t));
+      int64_t * ezero = (int64_t *)calloc(ne, sizeof(int64_t));
+      StingerGraph sg(1);
+      tic();
+      sg.init_vertices(nv, vzero, vzero);
+      sg.init_edges_csr(off, ind, ezero, wgt);
+      stinger_rate = ne / toc();
+      free(vzero);
+      free(ezero);
+    }
+  }
 
   V(Loading data into graph...);
   tic();
-  for(uint64_t v = 0; v < nv; v++) {
-    for(uint64_t i = off[v]; i < off[v+1]; i++) {
-      src[i] = v; dst[i] = ind[i];
-    }
-  }
 
   Graph g;
-  init(nv, ne, src, dst, g);
+  init_csr(nv, (size_type *)off, (size_type *)ind, g);
 
   double build_time = toc();
   R("\"build\": {\n")
@@ -420,9 +547,17 @@ int main(int argc, char *argv[]) {
   R_A("\"time\":%le\n", build_time)
   R("},\n")
 
-  free(off); free(ind); free(wgt);
-  delete[] src;
-  delete[] dst;
+  R("\"build_rate\": {\n")
+  R("\"name\":\"mtgl-std\",\n")
+  R_A("\"time\":%le,\n", ne / build_time)
+  if(build_rates) {
+    R_A("\"adjacency_list\":%le,\n", ne / build_time)
+    R_A("\"compressed_sparse_row_graph\":%le,\n", csr_rate)
+    R_A("\"stinger_graph\":%le\n", stinger_rate)
+  } else {
+    R_A("\"adjacency_list\":%le\n", ne / build_time)
+  }
+  R("},\n")
 
 
   V(Shiloach-Vishkin  Connected components...)
@@ -443,30 +578,233 @@ int main(int argc, char *argv[]) {
   printf("\tDone %lf\n", sv_time);
   printf("\tComponents %ld\n", count);
 
+  V(Afforest Connected components...)
 
-  V(BFS...);
   tic();
 
-  vertex_property_map<Graph, size_type> distanceMap(g);
+  afforest(g, componentsMap);
+
+  double afforest_time = toc();
+
+  R("\"afforest\": {\n")
+  R("\"name\":\"mtgl-std\",\n")
+  R_A("\"time\":%le\n", afforest_time)
+  R("},\n")
 
   vertex_iterator verts = vertices(g);
-  for(size_type v = 0; v < nv; v++) {
-    distanceMap[verts[v]] = 0;
-  }
 
-  hop_count_bfs_visitor<Graph, vertex_property_map<Graph, size_type> > hop_count(distanceMap);
+  count = 0;
+  for(uint64_t v = 0; v < nv; v++)
+    count += (componentsMap[verts[v]] == v);
 
-  breadth_first_search(g, verts[0], hop_count);
+  printf("\tDone %lf\n", afforest_time);
+  printf("\tComponents %ld\n", count);
 
-  double sssv_time = toc();
+
+  V(BFS...);
+
+  graph_ctx gctx = { &g, verts, NULL };
+  graph500_result_t bfs_result;
+  graph500_run(off, ind, nv, graph500_bfs, &gctx, &bfs_result);
+  double sssv_time = bfs_result.time_mean;
 
   R("\"sssp\": {\n")
   R("\"name\":\"mtgl-std\",\n")
   R_A("\"time\":%le\n", sssv_time)
   R("},\n")
+  graph500_report("mtgl-std", &bfs_result);
 
   printf("\tDone %lf\n", sssv_time);
 
+  free(off); free(ind);
+
+  V(Pseudo-diameter...);
+  tic();
+
+  size_type diameter = multi_source_pseudo_diameter(g);
+
+  double diameter_time = toc();
+
+  R("\"diameter\": {\n")
+  R("\"name\":\"mtgl-std\",\n")
+  R_A("\"time\":%le,\n", diameter_time)
+  R_A("\"value\":%ld\n", (int64_t)diameter)
+  R("},\n")
+
+  printf("\tDone %lf\n", diameter_time);
+  printf("\tPseudo-diameter %ld\n", (int64_t)diameter);
+
+  V(Closeness centrality...);
+  std::vector<double> closeness(nv);
+  tic();
+
+  closeness_centrality(g, 256, &closeness[0]);
+
+  double closeness_time = toc();
+
+  R("\"closeness\": {\n")
+  R("\"name\":\"mtgl-std\",\n")
+  R_A("\"time\":%le\n", closeness_time)
+  R("},\n")
+
+  printf("\tDone %lf\n", closeness_time);
+
+  V(Random walks...);
+  std::vector<size_type> walk_starts(nv);
+  std::vector<size_type> walk_lengths(nv);
+  std::vector<size_type> walks(nv * WALK_LENGTH);
+  for(uint64_t v = 0; v < nv; v++)
+    walk_starts[v] = v;
+
+  batch_random_walk<Graph> walker(g);
+
+  tic();
+  size_type walk_steps = walker.run(&walk_starts[0], nv, WALK_LENGTH,
+				    &walks[0], &walk_lengths[0]);
+  double walk_time = toc();
+
+  R("\"walk\": {\n")
+  R("\"name\":\"mtgl-std\",\n")
+  R_A("\"time\":%le,\n", walk_time)
+  R_A("\"rate\":%le\n", walk_steps / walk_time)
+  R("},\n")
+
+  printf("\tDone %lf\n", walk_time);
+  printf("\tSteps/sec %le\n", walk_steps / walk_time);
+
+  walker.set_node2vec(1.0, 0.5);
+
+  tic();
+  walk_steps = walker.run(&walk_starts[0], nv, WALK_LENGTH,
+			  &walks[0], &walk_lengths[0]);
+  double node2vec_time = toc();
+
+  R("\"node2vec\": {\n")
+  R("\"name\":\"mtgl-std\",\n")
+  R_A("\"time\":%le,\n", node2vec_time)
+  R_A("\"rate\":%le\n", walk_steps / node2vec_time)
+  R("},\n")
+
+  printf("\tDone %lf\n", node2vec_time);
+  printf("\tSteps/sec %le\n", walk_steps / node2vec_time);
+
+  V(Max flow...);
+  /* Unit capacities between the two highest-degree vertices, which gives
+     their edge connectivity. */
+  uint64_t flow_s = 0, flow_t = 1;
+  for(uint64_t v = 0; v < nv; v++) {
+    size_type deg = out_degree(verts[v], g);
+    if(deg > out_degree(verts[flow_s], g)) {
+      flow_t = flow_s;
+      flow_s = v;
+    } else if(v != flow_s && deg > out_degree(verts[flow_t], g)) {
+      flow_t = v;
+    }
+  }
+
+  std::vector<int> capacity(num_edges(g), 1);
+
+  tic();
+  int flow = push_relabel_max_flow(g, verts[flow_s], verts[flow_t], &capacity[0]);
+  double flow_time = toc();
+
+  R("\"maxflow\": {\n")
+  R("\"name\":\"mtgl-std\",\n")
+  R_A("\"time\":%le,\n", flow_time)
+  R_A("\"value\":%d\n", flow)
+  R("},\n")
+
+  printf("\tDone %lf\n", flow_time);
+  printf("\tFlow %d\n", flow);
+
+  V(Maximal independent set...);
+  vertex_property_map<Graph, bool> in_mis(g);
+  size_type mis_rounds;
+
+  tic();
+  size_type mis_size = deterministic_maximal_independent_set(g, in_mis, &mis_rounds);
+  double mis_time = toc();
+
+  R("\"mis\": {\n")
+  R("\"name\":\"mtgl-std\",\n")
+  R_A("\"time\":%le,\n", mis_time)
+  R_A("\"size\":%ld,\n", (int64_t)mis_size)
+  R_A("\"rounds\":%ld\n", (int64_t)mis_rounds)
+  R("},\n")
+
+  printf("\tDone %lf\n", mis_time);
+  printf("\tSize %ld Rounds %ld\n", (int64_t)mis_size, (int64_t)mis_rounds);
+
+  V(Coloring...);
+  vertex_property_map<Graph, size_type> color(g);
+  size_type color_rounds;
+
+  tic();
+  size_type num_colors = jones_plassmann_coloring(g, color, &color_rounds);
+  double color_time = toc();
+
+  R("\"coloring\": {\n")
+  R("\"name\":\"mtgl-std\",\n")
+  R_A("\"time\":%le,\n", color_time)
+  R_A("\"colors\":%ld,\n", (int64_t)num_colors)
+  R_A("\"rounds\":%ld\n", (int64_t)color_rounds)
+  R("},\n")
+
+  printf("\tDone %lf\n", color_time);
+  printf("\tColors %ld Rounds %ld\n", (int64_t)num_colors, (int64_t)color_rounds);
+
+  tic();
+  num_colors = speculative_greedy_coloring(g, color, &color_rounds);
+  color_time = toc();
+
+  R("\"coloring_speculative\": {\n")
+  R("\"name\":\"mtgl-std\",\n")
+  R_A("\"time\":%le,\n", color_time)
+  R_A("\"colors\":%ld,\n", (int64_t)num_colors)
+  R_A("\"rounds\":%ld\n", (int64_t)color_rounds)
+  R("},\n")
+
+  printf("\tDone %lf\n", color_time);
+  printf("\tColors %ld Rounds %ld\n", (int64_t)num_colors, (int64_t)color_rounds);
+
+  V(Minimum spanning forest...);
+  /* Edge i of the graph is edge i of the file, so the file's weights are
+     indexed by edge id. */
+  std::vector<size_type> forest(nv);
+  int64_t msf_weight;
+
+  tic();
+  size_type msf_edges = boruvka_minimum_spanning_forest(g, wgt, &forest[0],
+							&msf_weight);
+  double msf_time = toc();
+
+  R("\"msf\": {\n")
+  R("\"name\":\"mtgl-std\",\n")
+  R_A("\"time\":%le,\n", msf_time)
+  R_A("\"weight\":%ld,\n", msf_weight)
+  R_A("\"edges\":%ld\n", (int64_t)msf_edges)
+  R("},\n")
+
+  printf("\tDone %lf\n", msf_time);
+  printf("\tEdges %ld Weight %ld\n", (int64_t)msf_edges, msf_weight);
+
+  tic();
+  msf_edges = filter_kruskal_minimum_spanning_forest(g, wgt, &forest[0],
+						     &msf_weight);
+  msf_time = toc();
+
+  R("\"msf_filter_kruskal\": {\n")
+  R("\"name\":\"mtgl-std\",\n")
+  R_A("\"time\":%le,\n", msf_time)
+  R_A("\"weight\":%ld,\n", msf_weight)
+  R_A("\"edges\":%ld\n", (int64_t)msf_edges)
+  R("},\n")
+
+  printf("\tDone %lf\n", msf_time);
+  printf("\tEdges %ld Weight %ld\n", (int64_t)msf_edges, msf_weight);
+
+  free(wgt);
+
   V(PageRank...);
 
   vertex_property_map<Graph, double> ranks(g);
@@ -514,26 +852,40 @@ int main(int argc, char *argv[]) {
   printf("\tDone %lf\n", toc());
 
   V(Insert / remove...)
-  tic();
-
-  for(uint64_t a = 0; a < na; a++) {
-    int64_t i = actions[2*a];
-    int64_t j = actions[2*a+1];
-
-    /* is insertion? */
-    if(i >= 0) {
-      add_edge(verts[i], verts[j], g);
-      add_edge(verts[j], verts[i], g);
-    } else {
-      i = ~i;
-      j = ~j;
-      //remove_edge(i, j, g);
-      //remove_edge(j, i, g);
-    }
+  replay_config_t replay;
+  mixed_config_t mixed;
+  double eps;
+
+  if(mixed_config_from_env(&mixed)) {
+    /* glibc favours readers by default, which starves the writers */
+    pthread_rwlockattr_t attr;
+    pthread_rwlockattr_init(&attr);
+    pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+    pthread_rwlock_t lock;
+    pthread_rwlock_init(&lock, &attr);
+    pthread_rwlockattr_destroy(&attr);
+    gctx.lock = &lock;
+
+    mixed_result_t mr;
+    mixed_run(&mixed, nv, actions, na, &mixed_ops, &gctx, &mr);
+    mixed_report("mtgl-insertonly", &mr);
+    na = mr.actions;
+    eps = mr.write_rate;
+
+    gctx.lock = NULL;
+    pthread_rwlock_destroy(&lock);
+  } else if(replay_config_from_env(&replay)) {
+    replay_result_t rr;
+    replay_measure(&replay, actions, na, apply_actions, &gctx, &rr);
+    replay_report("mtgl-insertonly", &rr);
+    na = rr.actions;
+    eps = rr.achieved;
+  } else {
+    tic();
+    apply_actions(&gctx, actions, na, 0);
+    eps = na / toc();
   }
 
-  double eps = na / toc();
-
   R("\"update\": {\n")
   R("\"name\":\"mtgl-insertonly\",\n")
   R_A("\"time\":%le\n", eps)
@@ -1,5 +1,7 @@
 #include    "sqlite3.h"
 #include    "timer.h"
+#include    "replay.h"
+#include    "graph500.h"
 
 #include  <stdio.h>
 #include  <stdlib.h>
@@ -41,6 +43,208 @@ get_double(void * rtn, int argc, char ** argv, char **azColName) {
   return 0;
 }
 
+static int
+get_parent(void * parent, int argc, char ** argv, char **azColName) {
+  ((int64_t *)parent)[atol(argv[0])] = atol(argv[1]);
+  return 0;
+}
+
+struct bfs_ctx {
+  sqlite3 * db;
+  int64_t nv;
+};
+
+/* Level-synchronous BFS in SQL.  Each level joins only the frontier table
+   against edges, and each new vertex takes its smallest parent from the
+   frontier. */
+static void
+graph500_bfs(void * ctx, int64_t root, int64_t * parent) {
+  sqlite3 * db = ((struct bfs_ctx *)ctx)->db;
+  int64_t nv = ((struct bfs_ctx *)ctx)->nv;
+  char *zErrMsg = 0;
+  char sqlcmd[1024];
+
+  DB_OR_DIE("DELETE FROM bfs");
+  DB_OR_DIE("DELETE FROM bfs_frontier");
+  sprintf(sqlcmd, "INSERT INTO bfs (vtx, parent, dist) VALUES (%ld, %ld, 0)", root, root);
+  DB_OR_DIE(sqlcmd);
+  sprintf(sqlcmd, "INSERT INTO bfs_frontier (vtx) VALUES (%ld)", root);
+  DB_OR_DIE(sqlcmd);
+
+  for(int64_t dist = 0; ; dist++) {
+    DB_OR_DIE("DELETE FROM bfs_next");
+    DB_OR_DIE("INSERT INTO bfs_next (vtx, parent) "
+      "SELECT edges.dst, MIN(edges.src) "
+      "FROM bfs_frontier "
+      "JOIN edges "
+      "ON edges.src = bfs_frontier.vtx "
+      "WHERE NOT EXISTS (SELECT 1 FROM bfs WHERE bfs.vtx = edges.dst) "
+      "GROUP BY edges.dst");
+
+    if(sqlite3_changes(db) < 1)
+      break;
+
+    sprintf(sqlcmd, "INSERT INTO bfs (vtx, parent, dist) SELECT vtx, parent, %ld FROM bfs_next", dist + 1);
+    DB_OR_DIE(sqlcmd);
+    DB_OR_DIE("DELETE FROM bfs_frontier");
+    DB_OR_DIE("INSERT INTO bfs_frontier (vtx) SELECT vtx FROM bfs_next");
+  }
+
+  for(int64_t v = 0; v < nv; v++)
+    parent[v] = -1;
+
+  if(SQLITE_OK != sqlite3_exec(db, "SELECT vtx, parent FROM bfs", get_parent, parent, &zErrMsg)) {
+    E_A(Reading BFS parents failed: %s, zErrMsg);
+  }
+}
+
+static void
+apply_actions(sqlite3 * db, const int64_t * actions, int64_t na) {
+  char *zErrMsg = 0;
+  char sqlcmd[1024];
+
+  for(uint64_t a = 0; a < na; a++) {
+    int64_t i = actions[2*a];
+    int64_t j = actions[2*a+1];
+
+    /* is insertion? */
+    if(i >= 0) {
+      sprintf(sqlcmd, "INSERT OR IGNORE INTO edges (src, dst, wgt) VALUES (%ld, %ld, 1) ", i, j);
+      DB_OR_DIE(sqlcmd);
+      sprintf(sqlcmd, "INSERT OR IGNORE INTO edges (src, dst, wgt) VALUES (%ld, %ld, 1) ", j, i);
+      DB_OR_DIE(sqlcmd);
+    } else {
+      i = ~i;
+      j = ~j;
+
+      sprintf(sqlcmd, "DELETE FROM edges WHERE src = %ld AND dst = %ld", i, j);
+      DB_OR_DIE(sqlcmd);
+      sprintf(sqlcmd, "DELETE FROM edges WHERE src = %ld AND dst = %ld", j, i);
+      DB_OR_DIE(sqlcmd);
+    }
+  }
+}
+
+/* A replayed batch becomes visible when its transaction commits */
+static void
+replay_apply(void * ctx, const int64_t * actions, int64_t na, int64_t first) {
+  sqlite3 * db = ctx;
+  char *zErrMsg = 0;
+
+  DB_OR_DIE("BEGIN IMMEDIATE TRANSACTION");
+  apply_actions(db, actions, na);
+  DB_OR_DIE("COMMIT TRANSACTION");
+}
+
+/* Mixed workload.  Every thread opens its own connection to the database
+   file, which runs in WAL mode so that readers see a committed snapshot
+   while a writer holds the write lock.  Searches use per-connection TEMP
+   tables, which shadow the shared bfs tables. */
+struct mixed_db {
+  const char * file;
+  int64_t nv;
+};
+
+struct mixed_conn {
+  struct bfs_ctx bctx;
+  sqlite3_stmt * degree;
+  sqlite3_stmt * neighbors;
+};
+
+static void *
+mixed_open(void * ctx) {
+  struct mixed_db * m = ctx;
+  struct mixed_conn * c = calloc(1, sizeof(struct mixed_conn));
+  sqlite3 * db;
+  char *zErrMsg = 0;
+
+  if(sqlite3_open_v2(m->file, &db, SQLITE_OPEN_READWRITE, NULL)) {
+    E_A(failed to open db %s, m->file);
+  }
+  sqlite3_busy_timeout(db, 60000);
+
+  DB_OR_DIE("CREATE TEMP TABLE bfs (vtx INTEGER PRIMARY KEY, parent BIGINT NOT NULL, dist BIGINT NOT NULL)");
+  DB_OR_DIE("CREATE TEMP TABLE bfs_frontier (vtx INTEGER PRIMARY KEY)");
+  DB_OR_DIE("CREATE TEMP TABLE bfs_next (vtx INTEGER PRIMARY KEY, parent BIGINT NOT NULL)");
+
+  if(SQLITE_OK != sqlite3_prepare_v2(db, "SELECT COUNT(*) FROM edges WHERE src = ?", -1, &c->degree, NULL) ||
+     SQLITE_OK != sqlite3_prepare_v2(db, "SELECT dst FROM edges WHERE src = ?", -1, &c->neighbors, NULL)) {
+    E_A(Preparing queries failed: %s, sqlite3_errmsg(db));
+  }
+
+  c->bctx.db = db;
+  c->bctx.nv = m->nv;
+  return c;
+}
+
+static void
+mixed_close(void * handle) {
+  struct mixed_conn * c = handle;
+
+  sqlite3_finalize(c->degree);
+  sqlite3_finalize(c->neighbors);
+  sqlite3_close(c->bctx.db);
+  free(c);
+}
+
+static void
+mixed_read_begin(void * handle) {
+  sqlite3 * db = ((struct mixed_conn *)handle)->bctx.db;
+  char *zErrMsg = 0;
+
+  DB_OR_DIE("BEGIN TRANSACTION");
+}
+
+static void
+mixed_read_end(void * handle) {
+  sqlite3 * db = ((struct mixed_conn *)handle)->bctx.db;
+  char *zErrMsg = 0;
+
+  DB_OR_DIE("COMMIT TRANSACTION");
+}
+
+static int64_t
+mixed_degree(void * handle, int64_t v) {
+  sqlite3_stmt * stmt = ((struct mixed_conn *)handle)->degree;
+  int64_t deg = 0;
+
+  sqlite3_bind_int64(stmt, 1, v);
+  if(SQLITE_ROW == sqlite3_step(stmt))
+    deg = sqlite3_column_int64(stmt, 0);
+  sqlite3_reset(stmt);
+  return deg;
+}
+
+static int64_t
+mixed_neighbors(void * handle, int64_t v, int64_t * out, int64_t max) {
+  sqlite3_stmt * stmt = ((struct mixed_conn *)handle)->neighbors;
+  int64_t deg = 0;
+
+  sqlite3_bind_int64(stmt, 1, v);
+  while(SQLITE_ROW == sqlite3_step(stmt)) {
+    if(deg < max)
+      out[deg] = sqlite3_column_int64(stmt, 0);
+    deg++;
+  }
+  sqlite3_reset(stmt);
+  return deg;
+}
+
+static void
+mixed_kernel(void * handle, int64_t root, int64_t * parent) {
+  graph500_bfs(&((struct mixed_conn *)handle)->bctx, root, parent);
+}
+
+static void
+mixed_apply(void * handle, const int64_t * actions, int64_t na, int64_t first) {
+  replay_apply(((struct mixed_conn *)handle)->bctx.db, actions, na, first);
+}
+
+static const mixed_ops_t mixed_ops = {
+  mixed_open, mixed_close, mixed_read_begin, mixed_read_end,
+  mixed_degree, mixed_neighbors, mixed_kernel, mixed_apply
+};
+
 int main(int argc, char *argv[]) {
   if(argc < 3) {
     E_A(Not enough arguments. Usage %s graphfile actionsfile, argv[0]);
@@ -91,8 +295,16 @@ int main(int argc, char *argv[]) {
   char *zErrMsg = 0;
   int rc;
 
-  if(getenv("DB_FILE")) {
-    if(sqlite3_open(getenv("DB_FILE"), &db)) {
+  mixed_config_t mixed;
+  int is_mixed = mixed_config_from_env(&mixed);
+  const char * db_file = getenv("DB_FILE");
+
+  /* the mixed workload connects once per thread, so it needs a file */
+  if(!db_file && is_mixed)
+    db_file = "mixed.db";
+
+  if(db_file) {
+    if(sqlite3_open(db_file, &db)) {
       sqlite3_close(db);
       E(failed to open db);
     }
@@ -103,6 +315,11 @@ int main(int argc, char *argv[]) {
     }
   }
 
+  if(is_mixed) {
+    DB_OR_DIE("PRAGMA journal_mode=WAL");
+    DB_OR_DIE("PRAGMA synchronous=NORMAL");
+  }
+
   if(SQLITE_OK != sqlite3_exec(db, 
     "DROP TABLE IF EXISTS edges", NULL, 0, &zErrMsg)) {
     E(Creating edge table failed);
@@ -132,58 +349,67 @@ int main(int argc, char *argv[]) {
   R_A("\"time\":%le\n", build_time)
   R("},\n")
 
-  free(off); free(ind); free(wgt);
+  free(wgt);
 
   V(Setting up connected components...);
   tic();
 
   DB_OR_DIE("DROP TABLE IF EXISTS components");
-  DB_OR_DIE("CREATE TABLE components (vtx BIGINT UNIQUE, label BIGINT)");
-  DB_OR_DIE("CREATE UNIQUE INDEX IF NOT EXISTS pairs ON components (vtx, label)");
-  DB_OR_DIE("CREATE UNIQUE INDEX IF NOT EXISTS src ON components (vtx)");
-  DB_OR_DIE("CREATE INDEX IF NOT EXISTS labels ON components (label)");
+  DB_OR_DIE("CREATE TABLE components (vtx INTEGER PRIMARY KEY, label BIGINT NOT NULL)");
+
+  /* vertices whose label changed in the last round, and the labels they
+     changed to */
+  DB_OR_DIE("DROP TABLE IF EXISTS components_frontier");
+  DB_OR_DIE("CREATE TABLE components_frontier (vtx INTEGER PRIMARY KEY, label BIGINT NOT NULL)");
 
   DB_OR_DIE("DROP TABLE IF EXISTS components_new");
-  DB_OR_DIE("CREATE TABLE components_new (vtx BIGINT UNIQUE, label BIGINT)");
-  DB_OR_DIE("CREATE UNIQUE INDEX IF NOT EXISTS pairs ON components_new (vtx, label)");
-  DB_OR_DIE("CREATE UNIQUE INDEX IF NOT EXISTS src ON components_new (vtx)");
-  DB_OR_DIE("CREATE INDEX IF NOT EXISTS labels ON components_new (label)");
+  DB_OR_DIE("CREATE TABLE components_new (vtx INTEGER PRIMARY KEY, label BIGINT NOT NULL)");
   
   printf("\tDone %lf\n", toc());
 
   V(Performing connected components...);
   tic();
 
+  DB_OR_DIE("BEGIN TRANSACTION");
   for(uint64_t v = 0; v < nv; v++) {
       sprintf(sqlcmd, "INSERT INTO components (vtx, label) VALUES (%ld, %ld)", v, v);
       DB_OR_DIE(sqlcmd);
-      sprintf(sqlcmd, "INSERT INTO components_new (vtx, label) VALUES (%ld, %ld)", v, v);
-      DB_OR_DIE(sqlcmd);
   }
+  DB_OR_DIE("COMMIT TRANSACTION");
+  DB_OR_DIE("INSERT INTO components_frontier SELECT vtx, label FROM components");
 
-  uint64_t old_count = nv;
+  /* Semi-naive label propagation: only the edges leaving vertices whose
+     label changed can lower a label, so each round reads just those.
+     Vertices that take a new label then shortcut to their label's label. */
   iter = 0;
   while(1) {
-    DB_OR_DIE("UPDATE components_new SET label = ( "
-        "SELECT MIN(CASE WHEN src.label > dst.label THEN dst.label ELSE src.label END) "
-        "FROM edges "
-        "LEFT JOIN components AS src ON edges.src = src.vtx "
-        "LEFT JOIN components AS dst ON edges.dst = dst.vtx "
-        "WHERE components_new.vtx = src.vtx "
-        "GROUP BY edges.src "
-        ")");
-
-    DB_OR_DIE("DELETE FROM components");
-    DB_OR_DIE("INSERT INTO components SELECT components_new.vtx, IFNULL(components_new.label, components_new.vtx)  FROM components_new");
-
-    int64_t new_count = 0;
-    sqlite3_exec(db, "SELECT COUNT(DISTINCT label) FROM components", get_count, &new_count, &zErrMsg);
-
-    printf("\tIteration %ld: Count is %ld\n", iter, new_count);
-    if(old_count == new_count)
+    DB_OR_DIE("DELETE FROM components_new");
+    DB_OR_DIE("INSERT INTO components_new (vtx, label) "
+        "SELECT edges.dst, MIN(components_frontier.label) "
+        "FROM components_frontier "
+        "JOIN edges ON edges.src = components_frontier.vtx "
+        "JOIN components ON components.vtx = edges.dst "
+        "WHERE components_frontier.label < components.label "
+        "GROUP BY edges.dst");
+
+    int64_t changed = sqlite3_changes(db);
+    printf("\tIteration %ld: %ld labels changed\n", iter, changed);
+    if(changed < 1)
       break;
-    else
-      old_count = new_count;
+
+    DB_OR_DIE("UPDATE components SET label = ( "
+        "SELECT label FROM components_new WHERE components_new.vtx = components.vtx "
+        ") WHERE vtx IN (SELECT vtx FROM components_new)");
+    DB_OR_DIE("UPDATE components SET label = ( "
+        "SELECT root.label FROM components AS root WHERE root.vtx = components.label "
+        ") WHERE vtx IN (SELECT vtx FROM components_new)");
+
+    DB_OR_DIE("DELETE FROM components_frontier");
+    DB_OR_DIE("INSERT INTO components_frontier (vtx, label) "
+        "SELECT components.vtx, components.label "
+        "FROM components_new "
+        "JOIN components ON components.vtx = components_new.vtx");
+    iter++;
   }
 
   double sv_time = toc();
@@ -198,63 +424,47 @@ int main(int argc, char *argv[]) {
   V(Setting up BFS...);
   tic();
 
-  DB_OR_DIE("DROP TABLE IF EXISTS distance");
-  DB_OR_DIE("CREATE TABLE distance (vtx BIGINT NOT NULL, dist BIGINT NOT NULL)");
-  DB_OR_DIE("CREATE UNIQUE INDEX IF NOT EXISTS nv ON distance (vtx)");
+  DB_OR_DIE("DROP TABLE IF EXISTS bfs");
+  DB_OR_DIE("CREATE TABLE bfs (vtx INTEGER PRIMARY KEY, parent BIGINT NOT NULL, dist BIGINT NOT NULL)");
+  DB_OR_DIE("DROP TABLE IF EXISTS bfs_frontier");
+  DB_OR_DIE("CREATE TABLE bfs_frontier (vtx INTEGER PRIMARY KEY)");
+  DB_OR_DIE("DROP TABLE IF EXISTS bfs_next");
+  DB_OR_DIE("CREATE TABLE bfs_next (vtx INTEGER PRIMARY KEY, parent BIGINT NOT NULL)");
 
   printf("\tDone %lf\n", toc());
 
   V(Performing BFS...);
-  tic();
-
-  uint64_t dist = 0;
-  uint64_t start = nv / 4;
-  sprintf(sqlcmd, "INSERT INTO distance (vtx, dist) VALUES (%ld, %ld)", start, dist);
-  DB_OR_DIE(sqlcmd);
 
-  while (1) {
-    uint64_t newdist = dist + 1;
-    sprintf(sqlcmd, 
-      "INSERT OR IGNORE INTO distance (vtx, dist) "
-      "SELECT DISTINCT edges.dst, %ld "
-      "FROM edges "
-      "LEFT JOIN distance "
-      "ON edges.src = distance.vtx "
-      "WHERE distance.dist = %ld", newdist, dist);
-    DB_OR_DIE(sqlcmd);
-
-    int rows_affected = sqlite3_changes(db);
-    printf("\tAffected %d rows\n", rows_affected);
-
-    if(rows_affected < 1)
-      break;
-
-    dist++;
-  }
-
-  double sssv_time = toc();
+  struct bfs_ctx bctx = { db, nv };
+  graph500_result_t bfs_result;
+  graph500_run(off, ind, nv, graph500_bfs, &bctx, &bfs_result);
+  double sssv_time = bfs_result.time_mean;
 
   R("\"sssp\": {\n")
   R("\"name\":\"sqlite-std\",\n")
   R_A("\"time\":%le\n", sssv_time)
   R("},\n")
+  graph500_report("sqlite-std", &bfs_result);
 
   printf("\tDone %lf\n", sssv_time);
 
+  free(off); free(ind);
+
   V(Setting up PageRank...);
   tic();
 
   DB_OR_DIE("DROP TABLE IF EXISTS outdegree");
-  DB_OR_DIE("CREATE TABLE outdegree (vtx BIGINT NOT NULL, degree BIGINT NOT NULL) ");
-  DB_OR_DIE("CREATE INDEX IF NOT EXISTS deg ON outdegree (vtx, degree)");
+  DB_OR_DIE("CREATE TABLE outdegree (vtx INTEGER PRIMARY KEY, degree BIGINT NOT NULL) ");
 
+  /* delta is rank not yet applied to pagerank nor passed on to neighbors */
   DB_OR_DIE("DROP TABLE IF EXISTS pagerank");
-  DB_OR_DIE("CREATE TABLE pagerank (vtx BIGINT NOT NULL, pagerank DOUBLE NOT NULL) ");
-  DB_OR_DIE("CREATE UNIQUE INDEX IF NOT EXISTS nv ON pagerank (vtx)");
+  DB_OR_DIE("CREATE TABLE pagerank (vtx INTEGER PRIMARY KEY, pagerank DOUBLE NOT NULL, delta DOUBLE NOT NULL) ");
+
+  DB_OR_DIE("DROP TABLE IF EXISTS pagerank_frontier");
+  DB_OR_DIE("CREATE TABLE pagerank_frontier (vtx INTEGER PRIMARY KEY, delta DOUBLE NOT NULL, push DOUBLE NOT NULL) ");
 
   DB_OR_DIE("DROP TABLE IF EXISTS pagerank_new");
-  DB_OR_DIE("CREATE TABLE pagerank_new (vtx BIGINT NOT NULL, pagerank DOUBLE NOT NULL) ");
-  DB_OR_DIE("CREATE UNIQUE INDEX IF NOT EXISTS nv ON pagerank_new (vtx)");
+  DB_OR_DIE("CREATE TABLE pagerank_new (vtx INTEGER PRIMARY KEY, delta DOUBLE NOT NULL) ");
 
   /* Give this for free - we could count this as part of datastructure init */
   DB_OR_DIE("INSERT INTO outdegree (vtx, degree) SELECT src, COUNT(src) FROM edges GROUP BY src");
@@ -264,36 +474,57 @@ int main(int argc, char *argv[]) {
   V(Performing PageRank...);
   tic();
 
-  double startPR = 1.0 / ((double)nv);
-  sprintf(sqlcmd, "INSERT INTO pagerank (vtx, pagerank) SELECT DISTINCT src, %lf FROM edges", startPR);
-  DB_OR_DIE(sqlcmd);
-
   double delta = 1.0;
   double epsilon = 1e-8;
   double dampingfactor = 0.85;
   double damping = (1.0 - dampingfactor) / ((double)nv);
 
+  /* Delta PageRank: after one full round gives every vertex the change its
+     rank would see, each round applies the deltas above threshold and
+     pushes dampingfactor * delta / degree to the neighbors.  Only vertices
+     whose delta grew last round are checked, and a delta held back keeps
+     accumulating until it crosses the threshold. */
+  double threshold = epsilon / ((double)nv);
+
+  double startPR = 1.0 / ((double)nv);
+  sprintf(sqlcmd, "INSERT INTO pagerank (vtx, pagerank, delta) "
+	    "SELECT edges.src, %le, %le * SUM(%le / outdegree.degree) + %le "
+	    "FROM edges "
+	    "JOIN outdegree ON outdegree.vtx = edges.dst "
+	    "GROUP BY edges.src", startPR, dampingfactor, startPR, damping - startPR);
+  DB_OR_DIE(sqlcmd);
+  DB_OR_DIE("INSERT INTO pagerank_new (vtx, delta) SELECT vtx, 0 FROM outdegree");
+
   uint64_t maxiter = 100;
   iter = maxiter;
 
   while (delta > epsilon && iter > 0) {
-    DB_OR_DIE("INSERT INTO pagerank_new (vtx, pagerank) "
-	      "SELECT edges.src, SUM(pagerank/degree) AS newPR "
-	      "FROM edges "
-	      "LEFT JOIN pagerank ON edges.dst = pagerank.vtx "
-	      "LEFT JOIN outdegree ON edges.dst = outdegree.vtx "
-	      "GROUP BY edges.src");
-
-    sprintf(sqlcmd, "UPDATE pagerank_new SET pagerank = %lf * pagerank + %lf", dampingfactor, damping);
+    DB_OR_DIE("DELETE FROM pagerank_frontier");
+    sprintf(sqlcmd, "INSERT INTO pagerank_frontier (vtx, delta, push) "
+	      "SELECT pagerank.vtx, pagerank.delta, pagerank.delta / outdegree.degree "
+	      "FROM pagerank_new "
+	      "JOIN pagerank ON pagerank.vtx = pagerank_new.vtx "
+	      "JOIN outdegree ON outdegree.vtx = pagerank_new.vtx "
+	      "WHERE ABS(pagerank.delta) > %le", threshold);
     DB_OR_DIE(sqlcmd);
 
-    sqlite3_exec(db,"SELECT SUM(ABS(pagerank.pagerank-pagerank_new.pagerank)) AS delta "
-	      "FROM pagerank "
-	      "LEFT JOIN pagerank_new ON pagerank.vtx = pagerank_new.vtx;", get_double, &delta, &zErrMsg);
+    delta = 0;
+    sqlite3_exec(db, "SELECT TOTAL(ABS(delta)) FROM pagerank_frontier", get_double, &delta, &zErrMsg);
+
+    DB_OR_DIE("UPDATE pagerank SET pagerank = pagerank + delta, delta = 0 "
+	      "WHERE vtx IN (SELECT vtx FROM pagerank_frontier)");
 
-    DB_OR_DIE("DELETE FROM pagerank");
-    DB_OR_DIE("INSERT INTO pagerank SELECT * FROM pagerank_new");
     DB_OR_DIE("DELETE FROM pagerank_new");
+    sprintf(sqlcmd, "INSERT INTO pagerank_new (vtx, delta) "
+	      "SELECT edges.dst, %lf * SUM(pagerank_frontier.push) "
+	      "FROM pagerank_frontier "
+	      "JOIN edges ON edges.src = pagerank_frontier.vtx "
+	      "GROUP BY edges.dst", dampingfactor);
+    DB_OR_DIE(sqlcmd);
+
+    DB_OR_DIE("UPDATE pagerank SET delta = delta + ( "
+	      "SELECT delta FROM pagerank_new WHERE pagerank_new.vtx = pagerank.vtx "
+	      ") WHERE vtx IN (SELECT vtx FROM pagerank_new)");
 
     printf("\tdelta: %lf\n", delta);
     printf("\titer: %ld\n", maxiter - iter + 1);
@@ -336,31 +567,28 @@ int main(int argc, char *argv[]) {
   printf("\tDone %lf\n", toc());
 
   V(Insert remove test...)
-  tic();
-
-  for(uint64_t a = 0; a < na; a++) {
-    int64_t i = actions[2*a];
-    int64_t j = actions[2*a+1];
-
-    /* is insertion? */
-    if(i >= 0) {
-      sprintf(sqlcmd, "INSERT OR IGNORE INTO edges (src, dst, wgt) VALUES (%ld, %ld, 1) ", i, j);
-      DB_OR_DIE(sqlcmd);
-      sprintf(sqlcmd, "INSERT OR IGNORE INTO edges (src, dst, wgt) VALUES (%ld, %ld, 1) ", j, i);
-      DB_OR_DIE(sqlcmd);
-    } else {
-      i = ~i;
-      j = ~j;
-
-      sprintf(sqlcmd, "DELETE FROM edges WHERE src = %ld AND dst = %ld", i, j);
-      DB_OR_DIE(sqlcmd);
-      sprintf(sqlcmd, "DELETE FROM edges WHERE src = %ld AND dst = %ld", j, i);
-      DB_OR_DIE(sqlcmd);
-    }
+  replay_config_t replay;
+  double eps;
+
+  if(is_mixed) {
+    struct mixed_db mdb = { db_file, nv };
+    mixed_result_t mr;
+    mixed_run(&mixed, nv, actions, na, &mixed_ops, &mdb, &mr);
+    mixed_report("sqlite-std", &mr);
+    na = mr.actions;
+    eps = mr.write_rate;
+  } else if(replay_config_from_env(&replay)) {
+    replay_result_t rr;
+    replay_measure(&replay, actions, na, replay_apply, db, &rr);
+    replay_report("sqlite-std", &rr);
+    na = rr.actions;
+    eps = rr.achieved;
+  } else {
+    tic();
+    apply_actions(db, actions, na);
+    eps = na / toc();
   }
 
-  double eps = na / toc();
-
   R("\"update\": {\n")
   R("\"name\":\"sqlite-std\",\n")
   R_A("\"time\":%le\n", eps)
@@ -0,0 +1,21 @@
+#ifndef  STATIC_MINIMUM_SPANNING_FOREST_H
+#define  STATIC_MINIMUM_SPANNING_FOREST_H
+
+#include <stdint.h>
+
+#include "stinger.h"
+
+typedef struct msf_edge {
+  int64_t source;
+  int64_t dest;
+  int64_t weight;
+} msf_edge_t;
+
+/* Minimum spanning forest of the type 0 edges, taken as undirected.  forest
+   needs room for nv - 1 edges.  Returns the number of forest edges and
+   stores their total weight in total_weight. */
+int64_t
+parallel_boruvka_msf (stinger_t * S, int64_t nv, msf_edge_t * forest,
+                      int64_t * total_weight);
+
+#endif  /*STATIC_MINIMUM_SPANNING_FOREST_H*/
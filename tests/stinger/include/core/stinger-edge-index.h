@@ -0,0 +1,71 @@
+#ifndef  STINGER_EDGE_INDEX_H
+#define  STINGER_EDGE_INDEX_H
+
+#include <stdint.h>
+
+#include "stinger-config.h"
+#include "stinger-defs.h"
+
+/**
+* @brief Per-vertex lookup table from (neighbor, edge type) to edge slot.
+*
+* Open addressing with linear probing and backward-shift deletion, so there
+* are no tombstones.  Slots are encoded as
+* (edge block index * STINGER_EDGEBLOCKSIZE + offset in block).  The table
+* also keeps a stack of free slots for each edge type so an insertion does
+* not need to scan the block chain for a hole.
+*
+* The table does no locking of its own.  STINGER holds the per-vertex lock
+* (see stinger_edge_index_lock() in stinger.c) around every change, and the
+* lock makes seq odd while it is held.  Lookups take no lock: a reader brackets
+* one with stinger_edge_index_read_begin() and stinger_edge_index_read_valid()
+* and discards the answer if a writer got in between.  Arrays outgrown by the
+* table are kept until the index is freed, so such a lookup never reads freed
+* memory.
+*/
+typedef struct stinger_edge_index {
+  int64_t seq;
+  int64_t size;
+  int64_t mask;
+  int64_t elements;
+  int64_t *keys;
+  int64_t *slots;
+  int64_t *retired;
+  int64_t nfree[STINGER_NUMETYPES];
+  int64_t free_size[STINGER_NUMETYPES];
+  int64_t *free_slots[STINGER_NUMETYPES];
+} stinger_edge_index_t;
+
+#define STINGER_EDGE_INDEX_EMPTY -1
+
+stinger_edge_index_t *
+stinger_edge_index_new(int64_t size);
+
+stinger_edge_index_t *
+stinger_edge_index_clear(stinger_edge_index_t * idx, int64_t size);
+
+stinger_edge_index_t *
+stinger_edge_index_free(stinger_edge_index_t * idx);
+
+int64_t
+stinger_edge_index_lookup(const stinger_edge_index_t * idx, int64_t neighbor, int64_t etype);
+
+int64_t
+stinger_edge_index_read_begin(const stinger_edge_index_t * idx);
+
+int
+stinger_edge_index_read_valid(const stinger_edge_index_t * idx, int64_t seq);
+
+void
+stinger_edge_index_insert(stinger_edge_index_t * idx, int64_t neighbor, int64_t etype, int64_t slot);
+
+int64_t
+stinger_edge_index_remove(stinger_edge_index_t * idx, int64_t neighbor, int64_t etype);
+
+void
+stinger_edge_index_push_free(stinger_edge_index_t * idx, int64_t etype, int64_t slot);
+
+int64_t
+stinger_edge_index_pop_free(stinger_edge_index_t * idx, int64_t etype);
+
+#endif  /*STINGER_EDGE_INDEX_H*/
@@ -0,0 +1,35 @@
+#ifndef  STINGER_EGONET_H
+#define  STINGER_EGONET_H
+
+#include "stinger.h"
+#include "stinger-iterator.h"
+
+/**
+* @brief A k-hop neighborhood of a STINGER vertex as a standalone CSR graph.
+*
+* Vertices are relabeled 0 to nv-1 in the order they were reached, so the
+* seed is always local vertex 0 and hop[] is non-decreasing.  The out-edges
+* of local vertex u are ind[off[u]] through ind[off[u+1]-1], in no particular
+* order, with their metadata at the same offsets.
+*/
+typedef struct stinger_egonet {
+  int64_t nv;
+  int64_t ne;
+  int64_t * off;
+  int64_t * ind;
+  int64_t * weight;
+  int64_t * timefirst;
+  int64_t * timerecent;
+  int64_t * type;
+  int64_t * local_to_global;
+  int64_t * hop;
+} stinger_egonet_t;
+
+stinger_egonet_t *
+stinger_egonet_extract(stinger_t * S, int64_t seed, int64_t nhops, const int64_t * caps,
+		       stinger_iterator_t * filter);
+
+stinger_egonet_t *
+stinger_egonet_free(stinger_egonet_t * eg);
+
+#endif  /*STINGER-EGONET_H*/
@@ -87,6 +87,8 @@ struct stinger_ebpool {
   struct stinger_eb ebpool[EBPOOL_SIZE];
   uint64_t ebpool_tail;
   uint8_t is_shared;
+  int64_t nfree;                        /**< Number of blocks in free_blocks */
+  eb_index_t free_blocks[EBPOOL_SIZE];  /**< Blocks returned to the pool, reused before the tail grows */
 };
 
 /**
@@ -100,6 +102,12 @@ struct stinger
 #endif
   struct stinger_etype_array *ETA;  /**< One edge type array for each edge type, specified at compile time */
   struct stinger_ebpool * ebpool;
+#if defined(STINGER_USE_EDGE_INDEX)
+  struct stinger_edge_index ** eindex; /**< Per-vertex edge index and update lock, NULL below the degree threshold */
+#endif
+#if defined(STINGER_USE_STATS)
+  struct stinger_stats * stats; /**< Incrementally maintained graph statistics */
+#endif
 };
 
 struct stinger_fragmentation_t {
@@ -172,6 +180,19 @@ int64_t stinger_eb_weight (const struct stinger_eb *, int);
 int64_t stinger_eb_ts (const struct stinger_eb *, int);
 int64_t stinger_eb_first_ts (const struct stinger_eb *, int);
 
+/* Every live edge in a block has both timestamps within [smallStamp,
+   largeStamp], so a block that fails this test holds no edge with
+   timeRecent in (modified_after, modified_before) and timeFirst in
+   (created_after, created_before) and can be skipped whole. */
+static inline int
+stinger_eb_in_time_window (const struct stinger_eb * eb_,
+                           int64_t modified_after, int64_t modified_before,
+                           int64_t created_after, int64_t created_before)
+{
+  return eb_->largeStamp > modified_after && eb_->smallStamp < modified_before &&
+         eb_->largeStamp > created_after && eb_->smallStamp < created_before;
+}
+
 int64_t stinger_count_outdeg (struct stinger *G, int64_t v);
 
 struct curs etype_begin (stinger_t * S, stinger_vertices_t *vertices, int64_t v, int etype);
@@ -181,6 +202,16 @@ void update_edge_data (struct stinger * S, struct stinger_eb *eb,
 
 void remove_edge (struct stinger * S, struct stinger_eb *eb, uint64_t index);
 
+#if defined(STINGER_USE_EDGE_INDEX)
+struct stinger_edge_index * stinger_edge_index_lock (const struct stinger * G, int64_t v);
+
+void stinger_edge_index_unlock (const struct stinger * G, int64_t v,
+                                struct stinger_edge_index * idx);
+
+struct stinger_edge_index * stinger_edge_index_rebuild (const struct stinger * G, int64_t v,
+                                                        struct stinger_edge_index * old);
+#endif
+
 void new_ebs (struct stinger * S, eb_index_t *out, size_t neb, int64_t etype, int64_t from);
 
 void push_ebs (struct stinger *G, size_t neb,
@@ -70,6 +70,11 @@ stinger_iterator_custom_filter(int (*predicate)(stinger_iterator_t *), stinger_i
 int
 stinger_iterator_next(stinger_iterator_t * iter);
 
+struct stinger_eb;
+
+int
+stinger_iterator_edge_filter(stinger_iterator_t * iter, const struct stinger_eb * eb, int64_t k);
+
 /*
  * IDEA These functions will enable some level of parallelism via this iterator
  * using for loops like:
@@ -0,0 +1,135 @@
+#ifndef  STINGER_PROPERTIES_H
+#define  STINGER_PROPERTIES_H
+
+#include "stinger.h"
+#include "stinger-return.h"
+
+/**
+* @file stinger-properties.h
+* @brief Named, typed property columns for STINGER vertices and edges.
+*
+* A property store holds any number of columns.  A vertex column has one
+* element per vertex ID.  An edge column has one element per edge block slot,
+* so an edge's properties are found from the same block and offset that hold
+* the edge itself (see STINGER_EDGE_SLOT and stinger_props_edge_slot()).
+* Slots are reused when edges are removed, so whoever inserts an edge owns
+* setting its properties.
+*
+* Columns are flat arrays, or flat pages for edges, so scans run at memory
+* bandwidth and numeric elements can be updated atomically.  String columns
+* are dictionary encoded: each element is an int64 code and the column owns
+* the dictionary.
+*
+* Vertex columns are allocated for the largest possible vertex ID.  Edge
+* columns are paged and allocate a page the first time one of its slots is
+* written; unwritten slots read as zero.
+*/
+
+typedef enum stinger_prop_type {
+  SP_I64,
+  SP_DBL,
+  SP_BYTES,
+  SP_STR
+} stinger_prop_type_t;
+
+typedef enum stinger_prop_target {
+  SP_VERTEX,
+  SP_EDGE
+} stinger_prop_target_t;
+
+#define SP_STR_NONE 0
+
+struct stinger_prop_dict;
+
+typedef struct stinger_prop_column {
+  char			      name[1024];
+  stinger_prop_target_t	      target;
+  stinger_prop_type_t	      type;
+  int64_t		      width;	  /**< Bytes per element */
+  int64_t		      elements;
+  uint8_t		    * data;	  /**< SP_VERTEX only */
+  uint8_t		   ** pages;	  /**< SP_EDGE only, NULL until written */
+  int64_t		      npages;
+  struct stinger_prop_dict  * dict;	  /**< SP_STR only */
+} stinger_prop_column_t;
+
+typedef struct stinger_props {
+  stinger_t		    * S;
+  stinger_prop_column_t    ** columns;
+  int64_t		      column_count;
+  int64_t		      column_size;
+} stinger_props_t;
+
+stinger_props_t *
+stinger_props_new(stinger_t * S);
+
+stinger_props_t *
+stinger_props_free(stinger_props_t ** props);
+
+stinger_prop_column_t *
+stinger_props_add_column(stinger_props_t * props, const char * name, stinger_prop_target_t target,
+			 stinger_prop_type_t type, int64_t width);
+
+stinger_prop_column_t *
+stinger_props_get_column(stinger_props_t * props, const char * name);
+
+stinger_return_t
+stinger_props_delete_column(stinger_props_t * props, const char * name);
+
+int64_t
+stinger_props_edge_slot(stinger_t * S, int64_t type, int64_t from, int64_t to);
+
+int
+stinger_props_save(stinger_props_t * props, uint64_t maxVtx, const char * propsfile);
+
+int
+stinger_props_load(stinger_props_t * props, const char * propsfile);
+
+/* element access */
+int64_t
+stinger_prop_i64_get(const stinger_prop_column_t * col, int64_t i);
+
+void
+stinger_prop_i64_set(stinger_prop_column_t * col, int64_t i, int64_t val);
+
+int64_t
+stinger_prop_i64_fetch_add(stinger_prop_column_t * col, int64_t i, int64_t val);
+
+double
+stinger_prop_dbl_get(const stinger_prop_column_t * col, int64_t i);
+
+void
+stinger_prop_dbl_set(stinger_prop_column_t * col, int64_t i, double val);
+
+double
+stinger_prop_dbl_fetch_add(stinger_prop_column_t * col, int64_t i, double val);
+
+uint8_t *
+stinger_prop_bytes_get(stinger_prop_column_t * col, int64_t i);
+
+int64_t
+stinger_prop_str_encode(stinger_prop_column_t * col, const char * str);
+
+int64_t
+stinger_prop_str_lookup(const stinger_prop_column_t * col, const char * str);
+
+const char *
+stinger_prop_str_decode(const stinger_prop_column_t * col, int64_t code);
+
+void
+stinger_prop_str_set(stinger_prop_column_t * col, int64_t i, const char * str);
+
+const char *
+stinger_prop_str_get(const stinger_prop_column_t * col, int64_t i);
+
+/* parallel scans */
+double
+stinger_prop_vertex_sum(const stinger_prop_column_t * col, int64_t nv);
+
+int64_t
+stinger_prop_vertex_select(const stinger_prop_column_t * col, int64_t nv, double lo, double hi, int64_t * out);
+
+double
+stinger_prop_edge_sum(stinger_t * S, const stinger_prop_column_t * col, int64_t type);
+
+#endif  /*STINGER_PROPERTIES_H*/
@@ -0,0 +1,66 @@
+#ifndef  STINGER_SHARED_H
+#define  STINGER_SHARED_H
+
+#include "stinger.h"
+
+/**
+* @file stinger-shared.h
+* @brief A STINGER in a named POSIX shared memory region.
+*
+* One writer process creates the region with stinger_shared_new() and applies
+* updates to shared->S as usual.  Any number of analytics processes can attach
+* with stinger_shared_map() and detach with stinger_shared_free() while the
+* writer runs.  Readers map the region read-only and never take a lock, so
+* they cannot slow down or stall the writer.
+*
+* The writer brackets each batch with stinger_shared_batch_begin() and
+* stinger_shared_batch_end(), which bump a sequence number that is odd while a
+* batch is being applied.  A reader calls stinger_shared_read_begin() before
+* an analytic and stinger_shared_read_end() after it; if read_end returns 1
+* the analytic saw exactly the graph after batch stinger_shared_epoch(seq),
+* otherwise it overlapped an update and saw a mix of two epochs (which
+* streaming STINGER analytics are written to tolerate).
+*
+* Everything inside STINGER is addressed by index rather than pointer, so each
+* process keeps its own struct stinger pointing into its own mapping.  The
+* per-vertex edge index, if enabled, belongs to the writer and is not shared.
+* Readers must not call anything that writes to the graph.  With
+* STINGER_USE_STATS that includes the stinger_stats_max_* queries, which may
+* refresh a cached value; the other statistics are safe to read.
+*/
+
+typedef struct stinger_shared_header stinger_shared_header_t;
+
+typedef struct stinger_shared {
+  char			    name[1024];
+  int			    is_writer;
+  int64_t		    size;
+  stinger_shared_header_t * header;
+  stinger_t		  * S;
+} stinger_shared_t;
+
+int
+stinger_shared_new(const char * name, stinger_shared_t ** shared);
+
+int
+stinger_shared_map(const char * name, stinger_shared_t ** shared);
+
+stinger_shared_t *
+stinger_shared_free(stinger_shared_t ** shared);
+
+int64_t
+stinger_shared_batch_begin(stinger_shared_t * shared);
+
+int64_t
+stinger_shared_batch_end(stinger_shared_t * shared);
+
+int64_t
+stinger_shared_read_begin(const stinger_shared_t * shared);
+
+int
+stinger_shared_read_end(const stinger_shared_t * shared, int64_t seq);
+
+int64_t
+stinger_shared_epoch(int64_t seq);
+
+#endif  /*STINGER_SHARED_H*/
@@ -0,0 +1,85 @@
+#ifndef  STINGER_STATS_H
+#define  STINGER_STATS_H
+
+#include <stdint.h>
+#include "stinger-config.h"
+#include "stinger-defs.h"
+
+/**
+* @file stinger-stats.h
+* @brief Graph statistics maintained inside the STINGER update paths.
+*
+* Only available when STINGER_USE_STATS is defined in stinger-config.h.  Every
+* edge insertion and removal updates per-type edge totals, the out-degree
+* histogram, and the active vertex count in a counter block owned by the
+* calling thread, so updates from different threads never share a cache
+* line.  Reading a figure sums the thread blocks, which costs
+* STINGER_STATS_SLOTS additions rather than a pass over every vertex.
+*
+* The largest out-degree and largest active vertex ID are kept as running
+* maximums.  When the vertex that holds one of them shrinks, the figure is
+* marked stale and the next read recomputes it with a full scan.
+*/
+
+struct stinger;
+
+/* Out-degree histogram bucket b counts vertices with out-degree in
+   [2^b, 2^(b+1)).  Vertices with out-degree zero are not counted. */
+#define STINGER_STATS_DEGREE_BUCKETS 64
+
+/* Number of per-thread counter blocks, must be a power of two */
+#if !defined(STINGER_STATS_SLOTS)
+#define STINGER_STATS_SLOTS 64
+#endif
+
+struct stinger_stats_slot {
+  int64_t edges[STINGER_NUMETYPES];
+  int64_t active_vertices;
+  int64_t outdegree_hist[STINGER_STATS_DEGREE_BUCKETS];
+  int64_t pad[8];	/**< Keeps neighboring slots off of each other's cache lines */
+};
+
+struct stinger_stats {
+  struct stinger_stats_slot slot[STINGER_STATS_SLOTS];
+  int64_t max_outdegree;
+  int64_t max_outdegree_stale;
+  int64_t max_active_vertex;
+  int64_t max_active_vertex_stale;
+};
+
+/* Hooks called from the update paths */
+#if defined(STINGER_USE_STATS)
+#define STINGER_STATS_EDGES_UPDATE(S_,TYPE_,DELTA_) stinger_stats_edges_update((S_)->stats,(TYPE_),(DELTA_))
+#else
+#define STINGER_STATS_EDGES_UPDATE(S_,TYPE_,DELTA_)
+#endif
+
+void
+stinger_stats_edges_update(struct stinger_stats * stats, int64_t type, int64_t delta);
+
+void
+stinger_stats_outdegree_update(struct stinger_stats * stats, int64_t v, int64_t old_deg, int64_t new_deg);
+
+void
+stinger_stats_activity_update(struct stinger_stats * stats, int64_t v, int64_t old_total, int64_t new_total);
+
+/* Queries */
+int64_t
+stinger_stats_edges(const struct stinger * S, int64_t type);
+
+int64_t
+stinger_stats_total_edges(const struct stinger * S);
+
+int64_t
+stinger_stats_active_vertices(const struct stinger * S);
+
+int64_t
+stinger_stats_max_active_vertex(const struct stinger * S);
+
+int64_t
+stinger_stats_max_outdegree(const struct stinger * S);
+
+void
+stinger_stats_outdegree_histogram(const struct stinger * S, int64_t * hist);
+
+#endif  /*STINGER_STATS_H*/
@@ -39,6 +39,30 @@
 #undef STINGER_READ_ONLY_PARALLEL_FORALL_EDGES_BEGIN
 #undef STINGER_READ_ONLY_PARALLEL_FORALL_EDGES_END
 
+#undef STINGER_FORALL_EDGES_OF_VTX_MODIFIED_BETWEEN_BEGIN
+#undef STINGER_FORALL_EDGES_OF_VTX_MODIFIED_BETWEEN_END
+
+#undef STINGER_FORALL_EDGES_MODIFIED_BETWEEN_BEGIN
+#undef STINGER_FORALL_EDGES_MODIFIED_BETWEEN_END
+
+#undef STINGER_PARALLEL_FORALL_EDGES_MODIFIED_BETWEEN_BEGIN
+#undef STINGER_PARALLEL_FORALL_EDGES_MODIFIED_BETWEEN_END
+
+#undef STINGER_FORALL_IN_EDGES_OF_VTX_BEGIN
+#undef STINGER_FORALL_IN_EDGES_OF_VTX_END
+
+#undef STINGER_FORALL_IN_EDGES_OF_TYPE_OF_VTX_BEGIN
+#undef STINGER_FORALL_IN_EDGES_OF_TYPE_OF_VTX_END
+
+#undef STINGER_PARALLEL_FORALL_IN_EDGES_OF_VTX_BEGIN
+#undef STINGER_PARALLEL_FORALL_IN_EDGES_OF_VTX_END
+
+#undef STINGER_PARALLEL_FORALL_IN_EDGES_OF_TYPE_OF_VTX_BEGIN
+#undef STINGER_PARALLEL_FORALL_IN_EDGES_OF_TYPE_OF_VTX_END
+
+#undef STINGER_IN_EDGE_SOURCE
+#undef STINGER_IN_EDGE_DEST
+
 #undef OF_VERTICES
 #undef OF_EDGE_TYPES
 #undef OF_VERTEX_TYPES
@@ -55,6 +79,7 @@
 #undef STINGER_EDGE_WEIGHT
 #undef STINGER_EDGE_TIME_FIRST
 #undef STINGER_EDGE_TIME_RECENT
+#undef STINGER_EDGE_SLOT
 
 /* edges are writeable */
 /* source vertex based */
@@ -176,6 +201,169 @@
     }									\
    } while (0)
 
+/* temporal range scans, skipping blocks outside the window */
+#define STINGER_FORALL_EDGES_OF_VTX_MODIFIED_BETWEEN_BEGIN(STINGER_,VTX_,AFTER_,BEFORE_) \
+  do {									\
+    struct stinger_eb * ebpool_priv = STINGER_->ebpool->ebpool; \
+    const int64_t after__ = (AFTER_);					\
+    const int64_t before__ = (BEFORE_);					\
+    struct stinger_eb *  current_eb__ = ebpool_priv + stinger_vertex_edges_get(STINGER_->vertices, VTX_);	\
+    for(; current_eb__ != ebpool_priv; current_eb__ = ebpool_priv + (current_eb__->next)) { \
+      if(!stinger_eb_in_time_window(current_eb__, after__, before__, INT64_MIN, INT64_MAX)) \
+	continue;							\
+      int64_t source__ = current_eb__->vertexID;			\
+      int64_t type__ = current_eb__->etype;				\
+      for(uint64_t i__ = 0; i__ < stinger_eb_high(current_eb__); i__++) { \
+        if(!stinger_eb_is_blank(current_eb__, i__) &&			\
+	   current_eb__->edges[i__].timeRecent > after__ &&		\
+	   current_eb__->edges[i__].timeRecent < before__) {		\
+	  struct stinger_edge * current_edge__ = current_eb__->edges + i__;
+
+#define STINGER_FORALL_EDGES_OF_VTX_MODIFIED_BETWEEN_END()		\
+        }								\
+      }									\
+    }									\
+  } while (0)
+
+#define STINGER_FORALL_EDGES_MODIFIED_BETWEEN_BEGIN(STINGER_,TYPE_,AFTER_,BEFORE_) \
+  do {									\
+    struct stinger_eb * ebpool_priv = STINGER_->ebpool->ebpool; \
+    const int64_t after__ = (AFTER_);					\
+    const int64_t before__ = (BEFORE_);					\
+    for(uint64_t p__ = 0; p__ < (STINGER_)->ETA[(TYPE_)].high; p__++) {	\
+      struct stinger_eb *  current_eb__ = ebpool_priv+ (STINGER_)->ETA[(TYPE_)].blocks[p__]; \
+      if(!stinger_eb_in_time_window(current_eb__, after__, before__, INT64_MIN, INT64_MAX)) \
+	continue;							\
+      int64_t source__ = current_eb__->vertexID;			\
+      int64_t type__ = current_eb__->etype;				\
+      for(uint64_t i__ = 0; i__ < stinger_eb_high(current_eb__); i__++) { \
+	if(!stinger_eb_is_blank(current_eb__, i__) &&			\
+	   current_eb__->edges[i__].timeRecent > after__ &&		\
+	   current_eb__->edges[i__].timeRecent < before__) {		\
+	  struct stinger_edge * current_edge__ = current_eb__->edges + i__;
+
+#define STINGER_FORALL_EDGES_MODIFIED_BETWEEN_END()			\
+	}								\
+      }									\
+    }									\
+  } while (0)
+
+#define STINGER_PARALLEL_FORALL_EDGES_MODIFIED_BETWEEN_BEGIN(STINGER_,TYPE_,AFTER_,BEFORE_) \
+  do {									\
+    struct stinger_eb * ebpool_priv = STINGER_->ebpool->ebpool; \
+    const int64_t after__ = (AFTER_);					\
+    const int64_t before__ = (BEFORE_);					\
+    OMP("omp parallel for")						\
+    MTA("mta assert parallel")						\
+    for(uint64_t p__ = 0; p__ < (STINGER_)->ETA[(TYPE_)].high; p__++) {	\
+      struct stinger_eb *  current_eb__ = ebpool_priv+ (STINGER_)->ETA[(TYPE_)].blocks[p__]; \
+      if(!stinger_eb_in_time_window(current_eb__, after__, before__, INT64_MIN, INT64_MAX)) \
+	continue;							\
+      int64_t source__ = current_eb__->vertexID;			\
+      int64_t type__ = current_eb__->etype;				\
+      for(uint64_t i__ = 0; i__ < stinger_eb_high(current_eb__); i__++) { \
+	if(!stinger_eb_is_blank(current_eb__, i__) &&			\
+	   current_eb__->edges[i__].timeRecent > after__ &&		\
+	   current_eb__->edges[i__].timeRecent < before__) {		\
+	  struct stinger_edge * current_edge__ = current_eb__->edges + i__;
+
+#define STINGER_PARALLEL_FORALL_EDGES_MODIFIED_BETWEEN_END()		\
+	}								\
+      }									\
+    }									\
+  } while (0)
+
+
+#if defined(STINGER_USE_REVERSE_EDGES)
+/* in-edges of a vertex, walking the reverse adjacency */
+#define STINGER_FORALL_IN_EDGES_OF_VTX_BEGIN(STINGER_,VTX_)		\
+  do {									\
+    struct stinger_eb * ebpool_priv = STINGER_->ebpool->ebpool; \
+    struct stinger_eb *  current_eb__ = ebpool_priv + stinger_vertex_in_edges_get(STINGER_->vertices, VTX_);	\
+    while(current_eb__ != ebpool_priv) {						\
+      int64_t source__ = current_eb__->vertexID;			\
+      int64_t type__ = current_eb__->etype;				\
+      for(uint64_t i__ = 0; i__ < stinger_eb_high(current_eb__); i__++) { \
+        if(!stinger_eb_is_blank(current_eb__, i__)) {			\
+	  struct stinger_edge * current_edge__ = current_eb__->edges + i__; \
+	  (void) source__; (void) type__; (void) current_edge__;
+
+#define STINGER_FORALL_IN_EDGES_OF_VTX_END()				\
+        }								\
+      }									\
+      current_eb__ = ebpool_priv + (current_eb__->next);				\
+    }									\
+  } while (0)
+
+#define STINGER_FORALL_IN_EDGES_OF_TYPE_OF_VTX_BEGIN(STINGER_,TYPE_,VTX_) \
+  do {									\
+    struct stinger_eb * ebpool_priv = STINGER_->ebpool->ebpool; \
+    struct stinger_eb *  current_eb__ = ebpool_priv + stinger_vertex_in_edges_get(STINGER_->vertices, VTX_);	\
+    while(current_eb__ != ebpool_priv) {						\
+      int64_t source__ = current_eb__->vertexID;			\
+      int64_t type__ = current_eb__->etype;				\
+      if(current_eb__->etype == TYPE_) {				\
+	  for(uint64_t i__ = 0; i__ < stinger_eb_high(current_eb__); i__++) { \
+	    if(!stinger_eb_is_blank(current_eb__, i__)) {               \
+	      struct stinger_edge * current_edge__ = current_eb__->edges + i__; \
+	      (void) source__; (void) type__; (void) current_edge__;
+
+#define STINGER_FORALL_IN_EDGES_OF_TYPE_OF_VTX_END() \
+	      }								\
+	  }								\
+      }									\
+      current_eb__ = ebpool_priv+ (current_eb__->next);				\
+    }									\
+  } while (0)
+
+#define STINGER_PARALLEL_FORALL_IN_EDGES_OF_VTX_BEGIN(STINGER_,VTX_)	\
+  do {									\
+    struct stinger_eb * ebpool_priv = STINGER_->ebpool->ebpool; \
+    struct stinger_eb *  current_eb__ = ebpool_priv+ stinger_vertex_in_edges_get(STINGER_->vertices, VTX_);	\
+    while(current_eb__ != ebpool_priv) {						\
+      int64_t source__ = current_eb__->vertexID;			\
+      int64_t type__ = current_eb__->etype;				\
+      OMP("omp parallel for")						\
+      MTA("mta assert parallel")					\
+      for(uint64_t i__ = 0; i__ < stinger_eb_high(current_eb__); i__++) { \
+        if(!stinger_eb_is_blank(current_eb__, i__)) {                   \
+	  struct stinger_edge * current_edge__ = current_eb__->edges + i__; \
+	  (void) source__; (void) type__; (void) current_edge__;
+
+#define STINGER_PARALLEL_FORALL_IN_EDGES_OF_VTX_END()			\
+        }								\
+      }									\
+      current_eb__ = ebpool_priv+ (current_eb__->next);				\
+    }									\
+  } while (0)
+
+#define STINGER_PARALLEL_FORALL_IN_EDGES_OF_TYPE_OF_VTX_BEGIN(STINGER_,TYPE_,VTX_) \
+  do {									\
+    struct stinger_eb * ebpool_priv = STINGER_->ebpool->ebpool; \
+    struct stinger_eb *  current_eb__ = ebpool_priv+ stinger_vertex_in_edges_get(STINGER_->vertices, VTX_);	\
+    while(current_eb__ != ebpool_priv) {						\
+      int64_t source__ = current_eb__->vertexID;			\
+      int64_t type__ = current_eb__->etype;				\
+      if(current_eb__->etype == TYPE_) {				\
+        OMP("omp parallel for")						\
+	  MTA("mta assert parallel")					\
+	  for(uint64_t i__ = 0; i__ < stinger_eb_high(current_eb__); i__++) { \
+	    if(!stinger_eb_is_blank(current_eb__, i__)) {               \
+	      struct stinger_edge * current_edge__ = current_eb__->edges + i__; \
+	      (void) source__; (void) type__; (void) current_edge__;
+
+#define STINGER_PARALLEL_FORALL_IN_EDGES_OF_TYPE_OF_VTX_END() \
+	      }								\
+	  }								\
+      }									\
+      current_eb__ = ebpool_priv+ (current_eb__->next);				\
+    }									\
+  } while (0)
+
+#define STINGER_IN_EDGE_SOURCE current_edge__->neighbor
+#define STINGER_IN_EDGE_DEST source__
+#endif /* STINGER_USE_REVERSE_EDGES */
+
 
 /* read only */
 /* source vertex based */
@@ -342,6 +530,7 @@
 #define STINGER_EDGE_WEIGHT current_edge__->weight
 #define STINGER_EDGE_TIME_FIRST current_edge__->timeFirst
 #define STINGER_EDGE_TIME_RECENT current_edge__->timeRecent
+#define STINGER_EDGE_SLOT (((int64_t)(current_eb__ - ebpool_priv)) * STINGER_EDGEBLOCKSIZE + i__)
 
 #define STINGER_RO_EDGE_SOURCE source__
 #define STINGER_RO_EDGE_TYPE ebp__[ebp_k__].type
@@ -59,7 +59,13 @@ struct stinger_vertex
   vweight_t   weight;     /**< Vertex weight */
   vdegree_t   inDegree;   /**< In-degree of the vertex */
   vdegree_t   outDegree;  /**< Out-degree of the vertex */
+#if defined(STINGER_USE_STATS)
+  vdegree_t   totalDegree; /**< In-degree plus out-degree, changes atomically so activity is tracked exactly */
+#endif
   adjacency_t edges;	  /**< Reference to the adjacency structure for this vertex */
+#if defined(STINGER_USE_REVERSE_EDGES)
+  adjacency_t inEdges;	  /**< Reference to the reverse (incoming) adjacency structure */
+#endif
   physID_t    physID;     /**< Physical ID that maps to this vertex */
 #if defined(STINGER_VERTEX_KEY_VALUE_STORE)
   key_value_store_t attributes;
@@ -126,6 +132,11 @@ stinger_vertex_outdegree_increment(const stinger_vertices_t * vertices, vindex_t
 vdegree_t
 stinger_vertex_outdegree_increment_atomic(const stinger_vertices_t * vertices, vindex_t v, vdegree_t degree);
 
+#if defined(STINGER_USE_STATS)
+vdegree_t
+stinger_vertex_totaldegree_increment_atomic(const stinger_vertices_t * vertices, vindex_t v, vdegree_t degree);
+#endif
+
 adjacency_t
 stinger_vertex_edges_get(const stinger_vertices_t * vertices, vindex_t v);
 
@@ -138,6 +149,17 @@ stinger_vertex_edges_get_and_lock(const stinger_vertices_t * vertices, vindex_t
 adjacency_t
 stinger_vertex_edges_set(const stinger_vertices_t * vertices, vindex_t v, adjacency_t edges);
 
+#if defined(STINGER_USE_REVERSE_EDGES)
+adjacency_t
+stinger_vertex_in_edges_get(const stinger_vertices_t * vertices, vindex_t v);
+
+adjacency_t *
+stinger_vertex_in_edges_pointer_get(const stinger_vertices_t * vertices, vindex_t v);
+
+adjacency_t
+stinger_vertex_in_edges_set(const stinger_vertices_t * vertices, vindex_t v, adjacency_t edges);
+#endif
+
 physID_t *
 stinger_vertex_physmap_pointer_get(const stinger_vertices_t * vertices, vindex_t v);
 
@@ -72,6 +72,8 @@ int stinger_remove_edge_pair (struct stinger *, int64_t /* type */ ,
 
 void stinger_remove_all_edges_of_type (struct stinger *G, int64_t type);
 
+int64_t stinger_expire_edges_before (struct stinger *G, int64_t /* threshold */ );
+
 /* Edge metadata (directed)*/
 int64_t stinger_edgeweight (const struct stinger *, int64_t /* vtx 1 */ ,
 			    int64_t /* vtx 2 */ ,
@@ -286,6 +288,43 @@ size_t stinger_graph_size (const struct stinger *);
 #define STINGER_READ_ONLY_PARALLEL_FORALL_EDGES_BEGIN(STINGER_,TYPE_) do {
 #define STINGER_READ_ONLY_PARALLEL_FORALL_EDGES_END() while (0)
 
+/* temporal range traversal macros *
+ * Visit only edges whose recent timestamp lies strictly between AFTER_ and
+ * BEFORE_.  Whole edge blocks outside the window are skipped using the block
+ * timestamps, so a narrow window costs far less than a full scan.  Same
+ * safety rules as the modify traversal macros above.
+ */
+#define STINGER_FORALL_EDGES_OF_VTX_MODIFIED_BETWEEN_BEGIN(STINGER_,VTX_,AFTER_,BEFORE_) do {
+#define STINGER_FORALL_EDGES_OF_VTX_MODIFIED_BETWEEN_END() } while (0)
+
+#define STINGER_FORALL_EDGES_MODIFIED_BETWEEN_BEGIN(STINGER_,TYPE_,AFTER_,BEFORE_) do {
+#define STINGER_FORALL_EDGES_MODIFIED_BETWEEN_END() } while (0)
+
+#define STINGER_PARALLEL_FORALL_EDGES_MODIFIED_BETWEEN_BEGIN(STINGER_,TYPE_,AFTER_,BEFORE_) do {
+#define STINGER_PARALLEL_FORALL_EDGES_MODIFIED_BETWEEN_END() } while (0)
+
+/* in-edge traversal macros *
+ * Only available when STINGER_USE_REVERSE_EDGES is defined in stinger-config.h.
+ * These walk the reverse adjacency of a vertex, visiting every edge u -> VTX_.
+ * Use STINGER_IN_EDGE_SOURCE for the predecessor u and STINGER_IN_EDGE_DEST for
+ * VTX_.  STINGER_EDGE_TYPE, STINGER_EDGE_WEIGHT, and the timestamps refer to the
+ * reverse copy of the edge and should be treated as read-only.
+ */
+#define STINGER_FORALL_IN_EDGES_OF_VTX_BEGIN(STINGER_,VTX_) do {
+#define STINGER_FORALL_IN_EDGES_OF_VTX_END() } while (0)
+
+#define STINGER_FORALL_IN_EDGES_OF_TYPE_OF_VTX_BEGIN(STINGER_,TYPE_,VTX_) do {
+#define STINGER_FORALL_IN_EDGES_OF_TYPE_OF_VTX_END() while (0)
+
+#define STINGER_PARALLEL_FORALL_IN_EDGES_OF_VTX_BEGIN(STINGER_,VTX_) do {
+#define STINGER_PARALLEL_FORALL_IN_EDGES_OF_VTX_END() while (0)
+
+#define STINGER_PARALLEL_FORALL_IN_EDGES_OF_TYPE_OF_VTX_BEGIN(STINGER_,TYPE_,VTX_) do {
+#define STINGER_PARALLEL_FORALL_IN_EDGES_OF_TYPE_OF_VTX_END() while (0)
+
+#define STINGER_IN_EDGE_SOURCE /* always read-only */
+#define STINGER_IN_EDGE_DEST /* always read-only */
+
 /* Use these to access the current edge inside the above macros */
 #define STINGER_EDGE_SOURCE /* always read-only */
 #define STINGER_EDGE_TYPE /* always read-only */
@@ -293,6 +332,7 @@ size_t stinger_graph_size (const struct stinger *);
 #define STINGER_EDGE_WEIGHT
 #define STINGER_EDGE_TIME_FIRST
 #define STINGER_EDGE_TIME_RECENT
+#define STINGER_EDGE_SLOT /* always read-only, out-edge macros only */
 
 /* Filtering traversal macros *
  * This macro will traverse all edges according to the specified filter.
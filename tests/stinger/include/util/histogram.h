@@ -17,4 +17,7 @@ histogram_float(struct stinger * S, float * scores, int64_t count, char * path,
 void
 histogram_double(struct stinger * S, double * scores, int64_t count, char * path, char * name, int64_t iteration);
 
+void
+histogram_outdegree(struct stinger * S, int64_t count, char * path, char * name, int64_t iteration);
+
 #endif  /*HISTOGRAM_H*/
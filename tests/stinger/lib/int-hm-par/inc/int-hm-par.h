@@ -0,0 +1,105 @@
+#ifndef  INT_HM_PAR_H
+#define  INT_HM_PAR_H
+
+#include <stdint.h>
+
+/*
+ * Concurrent int64 -> int64 hash map.
+ *
+ * Open addressing with linear probing.  Keys are claimed with a
+ * compare-and-swap and never move within a table, so lookups and inserts
+ * take no locks.  Removing a key clears its value but keeps the key in its
+ * slot; a later insert of the same key reuses the slot, and removed keys are
+ * dropped when the table is next migrated, so there are no tombstone keys
+ * for probes to step over.
+ *
+ * When a table passes 70% full a larger (or, after many removals, same
+ * sized) table is hung off of it and every operation that touches the old
+ * table first helps copy one chunk of it.  Copied slots are frozen and
+ * operations that meet a frozen slot continue in the new table, so the map
+ * stays usable while it grows.  Old tables are kept until int_hm_par_empty()
+ * or int_hm_par_free(), since another thread may still be reading them.
+ *
+ * INT64_MIN and INT64_MAX are reserved and may not be used as keys or
+ * values.
+ */
+
+typedef struct int_hm_par_table {
+  int64_t size;
+  int64_t mask;
+  int64_t claimed;
+  int64_t copy_next;
+  int64_t copy_done;
+  struct int_hm_par_table * volatile next;
+  struct int_hm_par_table * prev;
+  volatile int64_t *keys;
+  volatile int64_t *vals;
+} int_hm_par_table_t;
+
+typedef struct int_hm_par {
+  int_hm_par_table_t * volatile cur;
+  int64_t elements;
+} int_hm_par_t;
+
+#define INT_HM_PAR_EMPTY INT64_MIN
+#define INT_HM_PAR_MOVED INT64_MAX
+
+int_hm_par_t *
+int_hm_par_new(int64_t size);
+
+int_hm_par_t *
+int_hm_par_free(int_hm_par_t * hm);
+
+int_hm_par_t *
+int_hm_par_empty(int_hm_par_t * hm);
+
+int
+int_hm_par_insert(int_hm_par_t * hm, int64_t k, int64_t v);
+
+int64_t
+int_hm_par_fetch_add(int_hm_par_t * hm, int64_t k, int64_t v);
+
+int
+int_hm_par_remove(int_hm_par_t * hm, int64_t k);
+
+int64_t
+int_hm_par_get(int_hm_par_t * hm, int64_t k);
+
+int64_t
+int_hm_par_elements(int_hm_par_t * hm);
+
+/* Concurrent int64 set on top of the map. */
+typedef int_hm_par_t int_ht_par_t;
+
+static inline int_ht_par_t *
+int_ht_par_new(int64_t size) {
+  return int_hm_par_new(size);
+}
+
+static inline int_ht_par_t *
+int_ht_par_free(int_ht_par_t * ht) {
+  return int_hm_par_free(ht);
+}
+
+static inline int_ht_par_t *
+int_ht_par_empty(int_ht_par_t * ht) {
+  return int_hm_par_empty(ht);
+}
+
+/* Returns 1 if k was not already in the set. */
+static inline int
+int_ht_par_insert(int_ht_par_t * ht, int64_t k) {
+  return int_hm_par_insert(ht, k, 1);
+}
+
+static inline int
+int_ht_par_exists(int_ht_par_t * ht, int64_t k) {
+  return int_hm_par_get(ht, k) != INT_HM_PAR_EMPTY;
+}
+
+static inline int
+int_ht_par_remove(int_ht_par_t * ht, int64_t k) {
+  return int_hm_par_remove(ht, k);
+}
+
+#endif  /*INT-HM-PAR_H*/
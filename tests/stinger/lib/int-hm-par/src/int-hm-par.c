@@ -0,0 +1,516 @@
+#include "int-hm-par.h"
+#include "timer.h"
+
+#include <stdlib.h>
+
+#define INT_HM_PAR_CHUNK 1024
+
+enum {
+  INT_HM_PAR_PUT,
+  INT_HM_PAR_ADD,
+  INT_HM_PAR_DEL
+};
+
+static int64_t
+mix(int64_t n) {
+  n = (~n) + (n << 21); // n = (n << 21) - n - 1;
+  n = n ^ (n >> 24);
+  n = (n + (n << 3)) + (n << 8); // n * 265
+  n = n ^ (n >> 14);
+  n = (n + (n << 2)) + (n << 4); // n * 21
+  n = n ^ (n >> 28);
+  n = n + (n << 31);
+  return n;
+}
+
+static int_hm_par_table_t *
+table_new(int64_t size) {
+  int64_t pow = 16;
+
+  while(pow < size) {
+    pow <<= 1;
+  }
+
+  int_hm_par_table_t * rtn = malloc(sizeof(int_hm_par_table_t));
+  rtn->size = pow;
+  rtn->mask = pow-1;
+  rtn->claimed = 0;
+  rtn->copy_next = 0;
+  rtn->copy_done = 0;
+  rtn->next = NULL;
+  rtn->prev = NULL;
+  rtn->keys = malloc((sizeof(int64_t) + sizeof(int64_t)) * pow);
+  rtn->vals = rtn->keys + pow;
+
+  for(uint64_t i = 0; i < rtn->size; i++) {
+    rtn->keys[i] = INT_HM_PAR_EMPTY;
+    rtn->vals[i] = INT_HM_PAR_EMPTY;
+  }
+
+  return rtn;
+}
+
+static void
+table_free(int_hm_par_table_t * t) {
+  free((void *)t->keys);
+  free(t);
+}
+
+/* Hang a new table off of t.  It is sized from the number of live elements,
+   so a table full of removed keys is compacted rather than doubled. */
+static void
+start_resize(int_hm_par_t * hm, int_hm_par_table_t * t) {
+  if(t->next) {
+    return;
+  }
+
+  int64_t live = hm->elements;
+  int64_t size = 2 * (live + 1);
+  if(size < t->size / 2) {
+    size = t->size / 2;
+  }
+
+  int_hm_par_table_t * n = table_new(size);
+  n->prev = t;
+  if(!__sync_bool_compare_and_swap(&t->next, NULL, n)) {
+    table_free(n);
+  }
+}
+
+/* Make t->next the current table once t has been copied, and keep going if
+   t->next finished copying before it was promoted. */
+static void
+promote(int_hm_par_t * hm, int_hm_par_table_t * t) {
+  while(__sync_bool_compare_and_swap(&hm->cur, t, t->next)) {
+    t = t->next;
+    if(!t->next || t->copy_done != t->size) {
+      break;
+    }
+  }
+}
+
+static int64_t
+table_update(int_hm_par_t * hm, int_hm_par_table_t * t, int64_t k, int64_t v, int op, int count);
+
+/* Freeze slot i of t after copying it into t->next.  A value that changes
+   under us is copied again before the freeze succeeds, so t->next always
+   holds the last value written to t. */
+static void
+copy_slot(int_hm_par_t * hm, int_hm_par_table_t * t, int64_t i) {
+  int64_t key;
+  while(1) {
+    key = t->keys[i];
+    if(key == INT_HM_PAR_MOVED) {
+      return;
+    }
+    if(key != INT_HM_PAR_EMPTY) {
+      break;
+    }
+    if(__sync_bool_compare_and_swap(&t->keys[i], INT_HM_PAR_EMPTY, INT_HM_PAR_MOVED)) {
+      return;
+    }
+  }
+
+  while(1) {
+    int64_t v = t->vals[i];
+    if(v == INT_HM_PAR_MOVED) {
+      return;
+    }
+    table_update(hm, t->next, key, v, v == INT_HM_PAR_EMPTY ? INT_HM_PAR_DEL : INT_HM_PAR_PUT, 0);
+    if(__sync_bool_compare_and_swap(&t->vals[i], v, INT_HM_PAR_MOVED)) {
+      return;
+    }
+  }
+}
+
+/* Copy one chunk of t into t->next. */
+static void
+help_copy(int_hm_par_t * hm, int_hm_par_table_t * t) {
+  int64_t start = __sync_fetch_and_add(&t->copy_next, INT_HM_PAR_CHUNK);
+  if(start >= t->size) {
+    return;
+  }
+
+  int64_t end = start + INT_HM_PAR_CHUNK;
+  if(end > t->size) {
+    end = t->size;
+  }
+
+  for(int64_t i = start; i < end; i++) {
+    copy_slot(hm, t, i);
+  }
+
+  if(__sync_add_and_fetch(&t->copy_done, end - start) == t->size) {
+    promote(hm, t);
+  }
+}
+
+/* Apply op to key k starting at table t.  Returns the previous value, or
+   INT_HM_PAR_EMPTY if k was absent.  count is zero for copies made while
+   migrating, which do not change the number of live elements. */
+static int64_t
+table_update(int_hm_par_t * hm, int_hm_par_table_t * t, int64_t k, int64_t v, int op, int count) {
+  while(1) {
+    if(t->next) {
+      help_copy(hm, t);
+    }
+
+    int64_t i = mix(k) & t->mask;
+    int64_t probes = 0;
+    int found = 0;
+
+    while(probes < t->size) {
+      int64_t key = t->keys[i];
+      if(key == k) {
+	found = 1;
+	break;
+      }
+      if(key == INT_HM_PAR_MOVED) {
+	break;
+      }
+      if(key == INT_HM_PAR_EMPTY) {
+	if(op == INT_HM_PAR_DEL) {
+	  if(!t->next) {
+	    return INT_HM_PAR_EMPTY;
+	  }
+	  break;
+	}
+	if(!t->next && 10 * (t->claimed + 1) > 7 * t->size) {
+	  start_resize(hm, t);
+	}
+	if(t->next) {
+	  /* close the slot so that no one adds k here after we move on */
+	  if(__sync_bool_compare_and_swap(&t->keys[i], INT_HM_PAR_EMPTY, INT_HM_PAR_MOVED)) {
+	    break;
+	  }
+	  continue;
+	}
+	if(__sync_bool_compare_and_swap(&t->keys[i], INT_HM_PAR_EMPTY, k)) {
+	  __sync_fetch_and_add(&t->claimed, 1);
+	  found = 1;
+	  break;
+	}
+	continue;
+      }
+      i = (i+1) & t->mask;
+      probes++;
+    }
+
+    if(found) {
+      while(1) {
+	int64_t old = t->vals[i];
+	int64_t nv;
+	if(old == INT_HM_PAR_MOVED) {
+	  break;
+	}
+	switch(op) {
+	  case INT_HM_PAR_PUT:
+	    nv = v;
+	    break;
+	  case INT_HM_PAR_ADD:
+	    nv = (old == INT_HM_PAR_EMPTY ? 0 : old) + v;
+	    break;
+	  default:
+	    if(old == INT_HM_PAR_EMPTY) {
+	      return INT_HM_PAR_EMPTY;
+	    }
+	    nv = INT_HM_PAR_EMPTY;
+	    break;
+	}
+	if(__sync_bool_compare_and_swap(&t->vals[i], old, nv)) {
+	  if(count && old == INT_HM_PAR_EMPTY && nv != INT_HM_PAR_EMPTY) {
+	    __sync_fetch_and_add(&hm->elements, 1);
+	  } else if(count && old != INT_HM_PAR_EMPTY && nv == INT_HM_PAR_EMPTY) {
+	    __sync_fetch_and_add(&hm->elements, -1);
+	  }
+	  return old;
+	}
+      }
+    }
+
+    /* k lives in (or belongs in) the next table */
+    if(!t->next) {
+      start_resize(hm, t);
+    }
+    t = t->next;
+  }
+}
+
+/** @brief Allocate a map with room for size elements before its first resize. */
+int_hm_par_t *
+int_hm_par_new(int64_t size) {
+  int_hm_par_t * rtn = malloc(sizeof(int_hm_par_t));
+  rtn->cur = table_new(size << 1);
+  rtn->elements = 0;
+  return rtn;
+}
+
+/** @brief Free the map and every table it has used.  Not thread safe. */
+int_hm_par_t *
+int_hm_par_free(int_hm_par_t * hm) {
+  if(hm) {
+    int_hm_par_table_t * t = hm->cur;
+    while(t->next) {
+      t = t->next;
+    }
+    while(t) {
+      int_hm_par_table_t * prev = t->prev;
+      table_free(t);
+      t = prev;
+    }
+    free(hm);
+  }
+  return NULL;
+}
+
+/** @brief Remove every element, keeping only the newest table.  Not thread
+ *  safe. */
+int_hm_par_t *
+int_hm_par_empty(int_hm_par_t * hm) {
+  int_hm_par_table_t * t = hm->cur;
+  while(t->next) {
+    t = t->next;
+  }
+  int_hm_par_table_t * old = t->prev;
+  while(old) {
+    int_hm_par_table_t * prev = old->prev;
+    table_free(old);
+    old = prev;
+  }
+
+  for(uint64_t i = 0; i < t->size; i++) {
+    t->keys[i] = INT_HM_PAR_EMPTY;
+    t->vals[i] = INT_HM_PAR_EMPTY;
+  }
+  t->claimed = 0;
+  t->copy_next = 0;
+  t->copy_done = 0;
+  t->prev = NULL;
+
+  hm->cur = t;
+  hm->elements = 0;
+  return hm;
+}
+
+/** @brief Set the value of k.
+ *
+ *  @return 1 if k was not in the map, 0 if an existing value was replaced.
+ */
+int
+int_hm_par_insert(int_hm_par_t * hm, int64_t k, int64_t v) {
+  return table_update(hm, hm->cur, k, v, INT_HM_PAR_PUT, 1) == INT_HM_PAR_EMPTY;
+}
+
+/** @brief Atomically add v to the value of k, treating a missing k as 0.
+ *
+ *  @return The value before the addition.
+ */
+int64_t
+int_hm_par_fetch_add(int_hm_par_t * hm, int64_t k, int64_t v) {
+  int64_t old = table_update(hm, hm->cur, k, v, INT_HM_PAR_ADD, 1);
+  return old == INT_HM_PAR_EMPTY ? 0 : old;
+}
+
+/** @brief Remove k.
+ *
+ *  @return 1 if k was in the map.
+ */
+int
+int_hm_par_remove(int_hm_par_t * hm, int64_t k) {
+  return table_update(hm, hm->cur, k, 0, INT_HM_PAR_DEL, 1) != INT_HM_PAR_EMPTY;
+}
+
+/** @brief Look up k.
+ *
+ *  @return The value of k, or INT_HM_PAR_EMPTY if it is not in the map.
+ */
+int64_t
+int_hm_par_get(int_hm_par_t * hm, int64_t k) {
+  int_hm_par_table_t * t = hm->cur;
+
+  while(1) {
+    if(t->next) {
+      help_copy(hm, t);
+    }
+
+    int64_t i = mix(k) & t->mask;
+    int64_t probes = 0;
+
+    while(probes < t->size) {
+      int64_t key = t->keys[i];
+      if(key == k) {
+	int64_t v = t->vals[i];
+	if(v != INT_HM_PAR_MOVED) {
+	  return v;
+	}
+	break;
+      }
+      if(key == INT_HM_PAR_MOVED) {
+	break;
+      }
+      if(key == INT_HM_PAR_EMPTY) {
+	if(!t->next) {
+	  return INT_HM_PAR_EMPTY;
+	}
+	break;
+      }
+      i = (i+1) & t->mask;
+      probes++;
+    }
+
+    if(!t->next) {
+      return INT_HM_PAR_EMPTY;
+    }
+    t = t->next;
+  }
+}
+
+/** @brief Number of elements in the map. */
+int64_t
+int_hm_par_elements(int_hm_par_t * hm) {
+  return hm->elements;
+}
+
+#if defined(INT_HM_PAR_TEST)
+#include <stdio.h>
+#include <omp.h>
+#include "int-hm-seq.h"
+
+int main(int argc, char *argv[]) {
+
+  int_hm_par_t * hm = int_hm_par_new(10);
+
+  for(int64_t i = 1; i < 5000; i += 2) {
+    int_hm_par_insert(hm, i, i);
+    if(i != int_hm_par_get(hm, i)) {
+      printf("Insertion of %ld failed.\n", i);
+      return -1;
+    }
+  }
+
+  for(int64_t i = 0; i < 5000; i++) {
+    if(i % 2 == 1) {
+      if(i != int_hm_par_get(hm, i)) {
+	printf("%ld does not exist, but was inserted.\n", i);
+	return -1;
+      }
+    } else {
+      if(INT_HM_PAR_EMPTY != int_hm_par_get(hm, i)) {
+	printf("%ld does exist, but was not inserted.\n", i);
+	return -1;
+      }
+    }
+  }
+  printf("insert test pass\n");
+
+  for(int64_t i = 1; i < 5000; i += 4) {
+    if(!int_hm_par_remove(hm, i)) {
+      printf("Removal of %ld failed.\n", i);
+      return -1;
+    }
+  }
+  for(int64_t i = 1; i < 5000; i += 2) {
+    if((i % 4 == 1) != (INT_HM_PAR_EMPTY == int_hm_par_get(hm, i))) {
+      printf("Removal test failed at %ld.\n", i);
+      return -1;
+    }
+  }
+  if(int_hm_par_elements(hm) != 1250) {
+    printf("Element count %ld after removal.\n", int_hm_par_elements(hm));
+    return -1;
+  }
+  printf("remove test pass\n");
+
+  int_hm_par_free(hm);
+
+  /* every thread bumps every key, resizing from a tiny table */
+  int64_t nkeys = 100000;
+  hm = int_hm_par_new(1);
+  #pragma omp parallel
+  {
+    for(int64_t i = 0; i < nkeys; i++) {
+      int_hm_par_fetch_add(hm, (i * 7919) % nkeys, 1);
+    }
+  }
+  int64_t nthreads = omp_get_max_threads();
+  for(int64_t i = 0; i < nkeys; i++) {
+    if(int_hm_par_get(hm, i) != nthreads) {
+      printf("Concurrent count of %ld is %ld, expected %ld.\n", i, int_hm_par_get(hm, i), nthreads);
+      return -1;
+    }
+  }
+  printf("concurrent test pass\n");
+
+  int_hm_par_free(hm);
+
+  /* throughput on the same keys: the sequential map, this map on one
+     thread, and this map on every thread */
+  int64_t count = 10000000;
+  int64_t expect = count * (count - 1) / 2;
+  int64_t sum = 0;
+
+  int_hm_seq_t * seq = int_hm_seq_new(count);
+  tic();
+  for(int64_t i = 0; i < count; i++) {
+    int_hm_seq_insert(seq, i, i);
+  }
+  double seq_insert = toc();
+  tic();
+  for(int64_t i = 0; i < count; i++) {
+    sum += int_hm_seq_get(seq, i);
+  }
+  double seq_get = toc();
+  int_hm_seq_free(seq);
+  if(sum != expect) {
+    printf("int-hm-seq lookups summed to %ld, expected %ld.\n", sum, expect);
+    return -1;
+  }
+
+  hm = int_hm_par_new(count);
+  tic();
+  for(int64_t i = 0; i < count; i++) {
+    int_hm_par_insert(hm, i, i);
+  }
+  double par1_insert = toc();
+  sum = 0;
+  tic();
+  for(int64_t i = 0; i < count; i++) {
+    sum += int_hm_par_get(hm, i);
+  }
+  double par1_get = toc();
+  int_hm_par_free(hm);
+  if(sum != expect) {
+    printf("Serial lookups summed to %ld, expected %ld.\n", sum, expect);
+    return -1;
+  }
+
+  hm = int_hm_par_new(count);
+  tic();
+  #pragma omp parallel for
+  for(int64_t i = 0; i < count; i++) {
+    int_hm_par_insert(hm, i, i);
+  }
+  double par_insert = toc();
+  sum = 0;
+  tic();
+  #pragma omp parallel for reduction(+:sum)
+  for(int64_t i = 0; i < count; i++) {
+    sum += int_hm_par_get(hm, i);
+  }
+  double par_get = toc();
+  if(sum != expect) {
+    printf("Parallel lookups summed to %ld, expected %ld.\n", sum, expect);
+    return -1;
+  }
+
+  printf("%ld keys, millions of operations per sec\n", count);
+  printf("  %-24s insert %8.2lf get %8.2lf\n", "int-hm-seq",
+    count / seq_insert / 1e6, count / seq_get / 1e6);
+  printf("  %-24s insert %8.2lf get %8.2lf\n", "int-hm-par 1 thread",
+    count / par1_insert / 1e6, count / par1_get / 1e6);
+  printf("  int-hm-par %2ld threads%*s insert %8.2lf get %8.2lf\n", nthreads, 3, "",
+    count / par_insert / 1e6, count / par_get / 1e6);
+
+  int_hm_par_free(hm);
+}
+#endif
@@ -5,6 +5,8 @@
 
 #include <sys/time.h>
 #include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #define R_A(X,...) fprintf(stdout, "RSLT: " X, __VA_ARGS__);
 #define R(X) R_A(X,NULL)
@@ -20,6 +22,18 @@
 #include "xmalloc.h"
 #include "static_pagerank.h"
 #include "static_components.h"
+#include "static_minimum_spanning_forest.h"
+#include "stinger-egonet.h"
+#include "stinger-shared.h"
+#include "stinger-properties.h"
+#include "replay.h"
+#include "graph500.h"
+
+#if defined(STINGER_USE_REVERSE_EDGES)
+#define RESULT_NAME "stinger-rev"
+#else
+#define RESULT_NAME "stinger-std"
+#endif
 
 #define ACTI(k) (action[2*(k)])
 #define ACTJ(k) (action[2*(k)+1])
@@ -45,23 +59,29 @@ static struct stinger * S;
 
 static double * update_time_trace;
 
+/* Level-synchronous BFS from source.  parent[v] becomes v's BFS parent,
+   source for the source itself, and -1 for unreached vertices. */
 void
-bfs(stinger_t * S, int64_t nv, int64_t source, int64_t * distances) {
-  int64_t * queue = malloc(sizeof(int64_t) * nv);
-  int64_t * found = malloc(sizeof(int64_t) * nv);
+bfs(stinger_t * S, int64_t nv, int64_t source, int64_t * parent) {
+  int64_t * queue = xmalloc(sizeof(int64_t) * nv);
   int64_t ftr_start = 0;
   int64_t ftr_stop = 1;
   int64_t queue_top= 1;
+
+  OMP("omp parallel for")
+  for(int64_t v = 0; v < nv; v++)
+    parent[v] = -1;
   queue[0] = source;
-  found[source] = 1;
+  parent[source] = source;
 
   while(ftr_start != ftr_stop) {
     /* for each vertex in the frontier in parallel */
     OMP("omp parallel for")
     for(int64_t q = ftr_start; q < ftr_stop; q++) {
-      STINGER_FORALL_EDGES_OF_VTX_BEGIN(S, queue[q]) {
-	if(!found[STINGER_EDGE_DEST]) {
-	  if(0 == stinger_int64_fetch_add(found + STINGER_EDGE_DEST, 1)) {
+      const int64_t u = queue[q];
+      STINGER_FORALL_EDGES_OF_VTX_BEGIN(S, u) {
+	if(parent[STINGER_EDGE_DEST] == -1) {
+	  if(-1 == stinger_int64_cas(parent + STINGER_EDGE_DEST, -1, u)) {
 	    int64_t where = stinger_int64_fetch_add(&queue_top, 1);
 	    queue[where] = STINGER_EDGE_DEST;
 	  }
@@ -71,8 +91,96 @@ bfs(stinger_t * S, int64_t nv, int64_t source, int64_t * distances) {
     ftr_start = ftr_stop;
     ftr_stop = queue_top;
   }
+
+  free(queue);
+}
+
+static void
+graph500_bfs(void * ctx, int64_t root, int64_t * parent) {
+  bfs((stinger_t *)ctx, nv, root, parent);
+}
+
+static void
+apply_batch(stinger_t * S, const int64_t * actions, int64_t numActions, int64_t actno) {
+  MTA("mta assert parallel")
+  MTA("mta block dynamic schedule")
+  OMP("omp parallel for")
+  for(uint64_t k = 0; k < numActions; k++) {
+    const int64_t i = actions[2 * k];
+    const int64_t j = actions[2 * k + 1];
+
+    if (i != j && i < 0) {
+      stinger_remove_edge(S, 0, ~i, ~j);
+      stinger_remove_edge(S, 0, ~j, ~i);
+    }
+
+    if (i != j && i >= 0) {
+      stinger_insert_edge (S, 0, i, j, 1, actno+2);
+      stinger_insert_edge (S, 0, j, i, 1, actno+2);
+    }
+  }
+}
+
+static void
+replay_apply(void * ctx, const int64_t * actions, int64_t n, int64_t first) {
+  apply_batch((stinger_t *)ctx, actions, n, first);
+}
+
+/* Mixed workload readers go straight to S with no locking, as STINGER
+   allows, so a reader can catch an edge pair half inserted. */
+static int64_t
+mixed_degree(void * ctx, int64_t v) {
+  return stinger_outdegree_get((stinger_t *)ctx, v);
 }
 
+static int64_t
+mixed_neighbors(void * ctx, int64_t v, int64_t * out, int64_t max) {
+  stinger_t * S = (stinger_t *)ctx;
+  int64_t deg = 0;
+  STINGER_FORALL_EDGES_OF_VTX_BEGIN(S, v) {
+    if(deg < max)
+      out[deg] = STINGER_EDGE_DEST;
+    deg++;
+  } STINGER_FORALL_EDGES_OF_VTX_END();
+  return deg;
+}
+
+static const mixed_ops_t mixed_ops = {
+  NULL, NULL, NULL, NULL,
+  mixed_degree, mixed_neighbors, graph500_bfs, replay_apply
+};
+
+/* Attach to the shared STINGER and re-read it until the writer has finished
+   all of its batches.  Runs in a forked child, so it stays serial. */
+static void
+shared_reader(const char * name, int64_t nv, int64_t last_epoch, int fd) {
+  stinger_shared_t * rd;
+  double out[4] = {0, 0, 0, 0};
+
+  tic();
+  if (stinger_shared_map(name, &rd) == 0) {
+    out[0] = toc();
+
+    int64_t seq;
+    do {
+      seq = stinger_shared_read_begin(rd);
+      int64_t deg = 0;
+      for (int64_t v = 0; v < nv; v++)
+	deg += stinger_outdegree_get(rd->S, v);
+      out[1] += 1;
+      if (stinger_shared_read_end(rd, seq)) {
+	out[2] += 1;
+	out[3] = deg;
+      }
+    } while (stinger_shared_epoch(seq) < last_epoch);
+
+    stinger_shared_free(&rd);
+  }
+
+  if (write(fd, out, sizeof(out)) != sizeof(out))
+    _exit(1);
+  _exit(0);
+}
 
 int
 main (const int argc, char *argv[])
@@ -110,14 +218,12 @@ main (const int argc, char *argv[])
   stinger_set_initial_edges (S, nv, 0, off, ind, weight, NULL, NULL, -2);
   double build_time = toc();
   R("\"build\": {\n")
-  R("\"name\":\"stinger-std\",\n")
+  R("\"name\":\"" RESULT_NAME "\",\n")
   R_A("\"time\":%le\n", build_time)
   R("},\n")
   PRINT_STAT_DOUBLE ("time_stinger", build_time);
   fflush(stdout);
 
-  free(graphmem);
-
   tic ();
   uint32_t errorCode = stinger_consistency_check (S, nv);
   double time_check = toc ();
@@ -131,20 +237,23 @@ main (const int argc, char *argv[])
   double sv_time = toc();
 
   R("\"sv\": {\n")
-  R("\"name\":\"stinger-std\",\n")
+  R("\"name\":\"" RESULT_NAME "\",\n")
   R_A("\"time\":%le\n", sv_time)
   R("},\n")
   free(components);
 
-  int64_t * distances = calloc(sizeof(int64_t), nv);
-  tic();
-  bfs(S, nv, 0, distances);
-  double sssv_time = toc();
+  /* Graph500-style BFS from a fixed sample of roots */
+  graph500_result_t bfs_result;
+  graph500_run(off, ind, nv, graph500_bfs, S, &bfs_result);
+  double sssv_time = bfs_result.time_mean;
+  PRINT_STAT_DOUBLE ("bfs_harmonic_mean_teps", bfs_result.teps_harmonic_mean);
+  PRINT_STAT_INT64 ("bfs_invalid", bfs_result.invalid);
 
   R("\"sssp\": {\n")
-  R("\"name\":\"stinger-std\",\n")
+  R("\"name\":\"" RESULT_NAME "\",\n")
   R_A("\"time\":%le\n", sssv_time)
   R("},\n")
+  graph500_report(RESULT_NAME, &bfs_result);
 
   double * pr = calloc(sizeof(double), nv);
   tic();
@@ -154,57 +263,195 @@ main (const int argc, char *argv[])
   free(pr);
 
   R("\"pr\": {\n")
-  R("\"name\":\"stinger-std\",\n")
+  R("\"name\":\"" RESULT_NAME "\",\n")
   R_A("\"time\":%le\n", pr_time)
   R("},\n")
 
-
-  /* Updates */
-  int64_t ntrace = 0;
-
-  for (int64_t actno = 0; actno < nbatch * batch_size; actno += batch_size)
-  {
+  /* MSF turns on the parallel Boruvka minimum spanning forest */
+  if (getenv ("MSF")) {
+    msf_edge_t * forest = xmalloc (nv * sizeof(msf_edge_t));
+    int64_t msf_weight;
     tic();
+    int64_t msf_edges = parallel_boruvka_msf(S, nv, forest, &msf_weight);
+
+    double msf_time = toc();
+    free(forest);
+    PRINT_STAT_INT64 ("msf_edges", msf_edges);
+    PRINT_STAT_INT64 ("msf_weight", msf_weight);
+
+    R("\"msf\": {\n")
+    R("\"name\":\"" RESULT_NAME "\",\n")
+    R_A("\"time\":%le,\n", msf_time)
+    R_A("\"weight\":%ld,\n", msf_weight)
+    R_A("\"edges\":%ld\n", msf_edges)
+    R("},\n")
+  }
 
-    const int64_t endact = (actno + batch_size > naction ? naction : actno + batch_size);
-    int64_t *actions = &action[2*actno];
-    int64_t numActions = endact - actno;
 
-    MTA("mta assert parallel")
-    MTA("mta block dynamic schedule")
-    OMP("omp parallel for")
-    for(uint64_t k = 0; k < endact - actno; k++) {
-      const int64_t i = actions[2 * k];
-      const int64_t j = actions[2 * k + 1];
+  /* EGONET_HOPS turns on egonet extraction around the largest vertex and a
+     vertex of typical degree, out to that many hops (2 if not a number) */
+  if (getenv ("EGONET_HOPS")) {
+    int64_t hops = atol (getenv ("EGONET_HOPS"));
+    if (hops <= 0)
+      hops = 2;
+
+    int64_t hub = 0, typical = 0;
+    int64_t avgdeg = (nv ? ne / nv : 0);
+    for (int64_t v = 0; v < nv; v++) {
+      int64_t deg = stinger_outdegree_get(S, v);
+      if (deg > stinger_outdegree_get(S, hub))
+	hub = v;
+      if (llabs(deg - avgdeg) < llabs(stinger_outdegree_get(S, typical) - avgdeg))
+	typical = v;
+    }
 
-      if (i != j && i < 0) {
-	stinger_remove_edge(S, 0, ~i, ~j);
-	stinger_remove_edge(S, 0, ~j, ~i);
-      }
+    tic();
+    stinger_egonet_t * eg = stinger_egonet_extract(S, hub, hops, NULL, NULL);
+    double ego_hub_time = toc();
+    PRINT_STAT_INT64 ("egonet_hub_nv", eg->nv);
+    PRINT_STAT_INT64 ("egonet_hub_ne", eg->ne);
+    stinger_egonet_free(eg);
 
-      if (i != j && i >= 0) {
-	stinger_insert_edge (S, 0, i, j, 1, actno+2);
-	stinger_insert_edge (S, 0, j, i, 1, actno+2);
-      }
+    tic();
+    eg = stinger_egonet_extract(S, typical, hops, NULL, NULL);
+    double ego_time = toc();
+    PRINT_STAT_INT64 ("egonet_nv", eg->nv);
+    PRINT_STAT_INT64 ("egonet_ne", eg->ne);
+    stinger_egonet_free(eg);
+
+    R("\"egonet_hub\": {\n")
+    R("\"name\":\"" RESULT_NAME "\",\n")
+    R_A("\"time\":%le\n", ego_hub_time)
+    R("},\n")
+
+    R("\"egonet\": {\n")
+    R("\"name\":\"" RESULT_NAME "\",\n")
+    R_A("\"time\":%le\n", ego_time)
+    R("},\n")
+  }
+
+  /* SHARED_READER turns on a shared-memory STINGER: the same graph and
+     updates with a reader process attached.  It builds a second STINGER
+     and replays the batches into it, so it is off by default. */
+  char shm_name[64];
+  sprintf(shm_name, "/stinger-%ld", (long)getpid());
+  stinger_shared_t * shared;
+
+  if (getenv ("SHARED_READER") && stinger_shared_new(shm_name, &shared) == 0) {
+    stinger_set_initial_edges (shared->S, nv, 0, off, ind, weight, NULL, NULL, -2);
+
+    int fds[2];
+    pid_t reader = -1;
+    fflush(stdout);
+    if (pipe(fds) == 0) {
+      reader = fork();
+      if (reader == 0)
+	shared_reader(shm_name, nv, nbatch, fds[1]);
     }
 
-    update_time_trace[ntrace] = toc();
-    ntrace++;
+    tic();
+    for (int64_t actno = 0; actno < nbatch * batch_size; actno += batch_size) {
+      const int64_t endact = (actno + batch_size > naction ? naction : actno + batch_size);
+      stinger_shared_batch_begin(shared);
+      apply_batch(shared->S, &action[2*actno], endact - actno, actno);
+      stinger_shared_batch_end(shared);
+    }
+    double shared_update_time = toc();
+
+    double rd[4] = {0, 0, 0, 0};
+    if (reader > 0) {
+      if (read(fds[0], rd, sizeof(rd)) != sizeof(rd))
+	rd[0] = rd[1] = rd[2] = rd[3] = 0;
+      waitpid(reader, NULL, 0);
+      close(fds[0]);
+      close(fds[1]);
+    }
+    stinger_shared_free(&shared);
+
+    PRINT_STAT_DOUBLE ("time_shared_attach", rd[0]);
+    PRINT_STAT_INT64 ("shared_reads", (int64_t)rd[1]);
+    PRINT_STAT_INT64 ("shared_reads_consistent", (int64_t)rd[2]);
+    PRINT_STAT_INT64 ("shared_last_consistent_ne", (int64_t)rd[3]);
+
+    R("\"shared_attach\": {\n")
+    R("\"name\":\"" RESULT_NAME "\",\n")
+    R_A("\"time\":%le\n", rd[0])
+    R("},\n")
+
+    R("\"shared_update\": {\n")
+    R("\"name\":\"" RESULT_NAME "\",\n")
+    R_A("\"time\":%le\n", (nbatch * batch_size) / shared_update_time)
+    R("},\n")
+  }
 
-  } /* End of batch */
+  free(graphmem);
 
-  /* Print the times */
+  /* Updates */
+  replay_config_t replay;
+  mixed_config_t mixed;
+  int64_t nupdates = nbatch * batch_size;
   double time_updates = 0;
-  for (int64_t k = 0; k < nbatch; k++) {
-    time_updates += update_time_trace[k];
+
+  if (mixed_config_from_env (&mixed)) {
+    /* Readers query S while the writers apply the stream */
+    mixed_result_t mr;
+    mixed_run (&mixed, nv, action, naction, &mixed_ops, S, &mr);
+    mixed_report (RESULT_NAME, &mr);
+
+    nupdates = mr.actions;
+    time_updates = mr.elapsed;
+    PRINT_STAT_INT64 ("mixed_queries", mr.queries);
+    PRINT_STAT_DOUBLE ("mixed_query_p99", mr.query_p99);
+    PRINT_STAT_INT64 ("mixed_violations", mr.violations);
+  } else if (replay_config_from_env (&replay)) {
+    /* Fixed-rate replay in place of the single batch */
+    replay_result_t rr;
+    replay_measure (&replay, action, naction, replay_apply, S, &rr);
+    replay_report (RESULT_NAME, &rr);
+
+    nupdates = rr.actions;
+    time_updates = rr.actions / rr.achieved;
+    PRINT_STAT_DOUBLE ("replay_rate", rr.rate);
+    PRINT_STAT_DOUBLE ("replay_p50", rr.p50);
+    PRINT_STAT_DOUBLE ("replay_p99", rr.p99);
+    PRINT_STAT_DOUBLE ("replay_p999", rr.p999);
+  } else {
+    int64_t ntrace = 0;
+
+    for (int64_t actno = 0; actno < nbatch * batch_size; actno += batch_size)
+    {
+      tic();
+
+      const int64_t endact = (actno + batch_size > naction ? naction : actno + batch_size);
+      apply_batch(S, &action[2*actno], endact - actno, actno);
+
+      update_time_trace[ntrace] = toc();
+      ntrace++;
+
+    } /* End of batch */
+
+    for (int64_t k = 0; k < nbatch; k++) {
+      time_updates += update_time_trace[k];
+    }
   }
+
+  /* Print the times */
   PRINT_STAT_DOUBLE ("time_updates", time_updates);
-  PRINT_STAT_DOUBLE ("updates_per_sec", (nbatch * batch_size) / time_updates); 
+  PRINT_STAT_DOUBLE ("updates_per_sec", nupdates / time_updates); 
 
-  double eps = (nbatch * batch_size) / time_updates;
+  /* Dashboard figures, kept current by the update paths under STINGER_USE_STATS */
+  tic ();
+  int64_t total_edges = stinger_total_edges (S);
+  int64_t active_vertices = stinger_num_active_vertices (S);
+  double time_stats = toc ();
+  PRINT_STAT_INT64 ("total_edges", total_edges);
+  PRINT_STAT_INT64 ("active_vertices", active_vertices);
+  PRINT_STAT_DOUBLE ("time_stats", time_stats);
+
+  double eps = nupdates / time_updates;
 
   R("\"update\": {\n")
-  R("\"name\":\"stinger-std\",\n")
+  R("\"name\":\"" RESULT_NAME "\",\n")
   R_A("\"time\":%le\n", eps)
   R("}\n")
   R("},\n")
@@ -212,7 +459,7 @@ main (const int argc, char *argv[])
   struct rusage usage;
   getrusage(RUSAGE_SELF, &usage);
 
-  R_A("\"na\":%ld,\n", nbatch * batch_size)
+  R_A("\"na\":%ld,\n", nupdates)
   R_A("\"mem\":%ld\n", usage.ru_maxrss)
   R("}\n")
 
@@ -222,6 +469,103 @@ main (const int argc, char *argv[])
   PRINT_STAT_HEX64 ("error_code", errorCode);
   PRINT_STAT_DOUBLE ("time_check", time_check);
 
+  /* PROPS_FILE turns on the property store: an edge column of the edge
+     weights and a vertex column of out-degrees, checked with the parallel
+     sums and again after a save to that file and a load into a new store */
+  if (getenv ("PROPS_FILE")) {
+    const char * props_file = getenv ("PROPS_FILE");
+    stinger_props_t * props = stinger_props_new (S);
+    stinger_prop_column_t * ew = stinger_props_add_column (props, "weight", SP_EDGE, SP_I64, 0);
+    stinger_prop_column_t * deg = stinger_props_add_column (props, "degree", SP_VERTEX, SP_I64, 0);
+
+    int64_t wsum = 0, nedges = 0;
+    tic ();
+    STINGER_FORALL_EDGES_BEGIN(S, 0) {
+      stinger_prop_i64_set (ew, STINGER_EDGE_SLOT, STINGER_EDGE_WEIGHT);
+      wsum += STINGER_EDGE_WEIGHT;
+      nedges++;
+    } STINGER_FORALL_EDGES_END();
+    for (int64_t v = 0; v < nv; v++)
+      stinger_prop_i64_set (deg, v, stinger_outdegree_get (S, v));
+    double time_props_fill = toc ();
+
+    tic ();
+    double edge_sum = stinger_prop_edge_sum (S, ew, 0);
+    double deg_sum = stinger_prop_vertex_sum (deg, nv);
+    double time_props_sum = toc ();
+
+    tic ();
+    int rtn = stinger_props_save (props, nv, props_file);
+    double time_props_save = toc ();
+    stinger_props_free (&props);
+
+    stinger_props_t * loaded = stinger_props_new (S);
+    tic ();
+    rtn |= stinger_props_load (loaded, props_file);
+    double time_props_load = toc ();
+    unlink (props_file);
+
+    double loaded_edge_sum = 0, loaded_deg_sum = 0;
+    if (rtn == 0) {
+      loaded_edge_sum = stinger_prop_edge_sum (S, stinger_props_get_column (loaded, "weight"), 0);
+      loaded_deg_sum = stinger_prop_vertex_sum (stinger_props_get_column (loaded, "degree"), nv);
+    }
+    stinger_props_free (&loaded);
+
+    PRINT_STAT_INT64 ("props_edge_sum", (int64_t) edge_sum);
+    PRINT_STAT_INT64 ("props_degree_sum", (int64_t) deg_sum);
+    PRINT_STAT_DOUBLE ("time_props_fill", time_props_fill);
+    PRINT_STAT_DOUBLE ("time_props_sum", time_props_sum);
+    PRINT_STAT_DOUBLE ("time_props_save", time_props_save);
+    PRINT_STAT_DOUBLE ("time_props_load", time_props_load);
+
+    if (edge_sum != wsum || deg_sum != nedges)
+      fprintf (stderr, "ERROR: expected edge sum %ld and degree sum %ld\n",
+	       (long) wsum, (long) nedges);
+    if (rtn != 0 || loaded_edge_sum != edge_sum || loaded_deg_sum != deg_sum)
+      fprintf (stderr, "ERROR: property columns differ after a save and load\n");
+  }
+
+  /* EXPIRE_BEFORE turns on expiry of every edge last touched before that
+     timestamp.  If not a number it is 0, which expires the initial graph
+     (stamped -2) and keeps the edges the actions touched.  It clears edges
+     out of S, so it runs last. */
+  if (getenv ("EXPIRE_BEFORE")) {
+    char * end;
+    int64_t threshold = strtol (getenv ("EXPIRE_BEFORE"), &end, 10);
+    if (end == getenv ("EXPIRE_BEFORE"))
+      threshold = 0;
+
+    int64_t nold = 0, nkept = 0, nleft = 0, nstale = 0;
+    STINGER_FORALL_EDGES_MODIFIED_BETWEEN_BEGIN(S, 0, INT64_MIN, threshold) {
+      nold++;
+    } STINGER_FORALL_EDGES_MODIFIED_BETWEEN_END();
+    STINGER_FORALL_EDGES_MODIFIED_BETWEEN_BEGIN(S, 0, threshold - 1, INT64_MAX) {
+      nkept++;
+    } STINGER_FORALL_EDGES_MODIFIED_BETWEEN_END();
+
+    tic ();
+    int64_t nexpired = stinger_expire_edges_before (S, threshold);
+    double time_expire = toc ();
+
+    STINGER_FORALL_EDGES_BEGIN(S, 0) {
+      nleft++;
+    } STINGER_FORALL_EDGES_END();
+    STINGER_FORALL_EDGES_MODIFIED_BETWEEN_BEGIN(S, 0, INT64_MIN, threshold) {
+      nstale++;
+    } STINGER_FORALL_EDGES_MODIFIED_BETWEEN_END();
+
+    PRINT_STAT_INT64 ("expire_threshold", threshold);
+    PRINT_STAT_INT64 ("expired_edges", nexpired);
+    PRINT_STAT_INT64 ("remaining_edges", nleft);
+    PRINT_STAT_DOUBLE ("time_expire", time_expire);
+
+    if (nexpired != nold || nleft != nkept || nstale != 0) {
+      fprintf (stderr, "ERROR: expected %ld expired and %ld remaining edges\n",
+	       (long) nold, (long) nkept);
+    }
+  }
+
   free(update_time_trace);
   stinger_free_all (S);
   free (actionmem);
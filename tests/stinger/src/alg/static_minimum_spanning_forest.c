@@ -0,0 +1,132 @@
+#include "static_minimum_spanning_forest.h"
+#include "stinger-atomics.h"
+#include "xmalloc.h"
+
+/* Lowers *x to v with a compare-and-swap loop */
+static inline void
+msf_int64_min (int64_t * x, int64_t v)
+{
+  int64_t cur = *x;
+  while (v < cur) {
+    int64_t prev = stinger_int64_cas (x, cur, v);
+    if (prev == cur)
+      break;
+    cur = prev;
+  }
+}
+
+/* Names the endpoint pair {u, v}, so that ties in weight are broken the
+   same way from either side */
+static inline int64_t
+msf_edge_key (int64_t u, int64_t v, int64_t nv)
+{
+  return (u < v) ? u * nv + v : v * nv + u;
+}
+
+int64_t
+parallel_boruvka_msf (stinger_t * S, int64_t nv, msf_edge_t * forest,
+                      int64_t * total_weight)
+{
+  int64_t * comp = xmalloc (nv * sizeof(int64_t));
+  int64_t * hook = xmalloc (nv * sizeof(int64_t));
+  int64_t * best_weight = xmalloc (nv * sizeof(int64_t));
+  int64_t * best_key = xmalloc (nv * sizeof(int64_t));
+  int64_t nforest = 0;
+  int64_t weight = 0;
+
+  OMP ("omp parallel for")
+    for (uint64_t i = 0; i < nv; i++) {
+      comp[i] = i;
+    }
+
+  while (1) {
+    OMP ("omp parallel for")
+      for (uint64_t i = 0; i < nv; i++) {
+        best_weight[i] = INT64_MAX;
+        best_key[i] = INT64_MAX;
+      }
+
+    /* Lightest weight between each component and another.  An edge is
+       offered to both of its components, so the stored direction does not
+       matter. */
+    STINGER_PARALLEL_FORALL_EDGES_BEGIN (S, 0) {
+      int64_t cu = comp[STINGER_EDGE_SOURCE];
+      int64_t cv = comp[STINGER_EDGE_DEST];
+      if (cu != cv) {
+        msf_int64_min (&best_weight[cu], STINGER_EDGE_WEIGHT);
+        msf_int64_min (&best_weight[cv], STINGER_EDGE_WEIGHT);
+      }
+    }
+    STINGER_PARALLEL_FORALL_EDGES_END ();
+
+    /* Lowest endpoint pair among the edges of that weight */
+    STINGER_PARALLEL_FORALL_EDGES_BEGIN (S, 0) {
+      int64_t cu = comp[STINGER_EDGE_SOURCE];
+      int64_t cv = comp[STINGER_EDGE_DEST];
+      if (cu != cv) {
+        int64_t key = msf_edge_key (STINGER_EDGE_SOURCE, STINGER_EDGE_DEST, nv);
+        if (STINGER_EDGE_WEIGHT == best_weight[cu])
+          msf_int64_min (&best_key[cu], key);
+        if (STINGER_EDGE_WEIGHT == best_weight[cv])
+          msf_int64_min (&best_key[cv], key);
+      }
+    }
+    STINGER_PARALLEL_FORALL_EDGES_END ();
+
+    /* Hook each component root to the component across its edge.  Two
+       components that chose the same edge keep the lower one as root. */
+    int64_t hooked = 0;
+    OMP ("omp parallel for reduction(+:hooked)")
+      MTA ("mta assert parallel")
+      for (uint64_t i = 0; i < nv; i++) {
+        hook[i] = i;
+        if (comp[i] != i || best_key[i] == INT64_MAX)
+          continue;
+
+        int64_t u = best_key[i] / nv;
+        int64_t v = best_key[i] % nv;
+        int64_t d = (comp[u] == i) ? comp[v] : comp[u];
+
+        if (best_key[d] == best_key[i] && i < d)
+          continue;
+
+        hook[i] = d;
+        int64_t k = stinger_int64_fetch_add (&nforest, 1);
+        forest[k].source = u;
+        forest[k].dest = v;
+        forest[k].weight = best_weight[i];
+        hooked++;
+      }
+
+    if (!hooked)
+      break;
+
+    OMP ("omp parallel for")
+      MTA ("mta assert nodep")
+      for (uint64_t i = 0; i < nv; i++) {
+        if (comp[i] == i)
+          comp[i] = hook[i];
+      }
+
+    /* Tree climbing, as in the connected components kernel */
+    OMP ("omp parallel for")
+      MTA ("mta assert nodep")
+      for (uint64_t i = 0; i < nv; i++) {
+        while (comp[i] != comp[comp[i]])
+          comp[i] = comp[comp[i]];
+      }
+  }
+
+  OMP ("omp parallel for reduction(+:weight)")
+    for (uint64_t k = 0; k < nforest; k++) {
+      weight += forest[k].weight;
+    }
+
+  free (comp);
+  free (hook);
+  free (best_weight);
+  free (best_key);
+
+  *total_weight = weight;
+  return nforest;
+}
@@ -3,6 +3,7 @@
 #include "histogram.h"
 #include "stinger-return.h"
 #include "stinger-atomics.h"
+#include "stinger-stats.h"
 #include "stinger-utils.h"
 #include "xmalloc.h"
 #include "timer.h"
@@ -190,6 +191,7 @@ multi_contract_root(
 	      currentBlock->numEdges--;
 	      stinger_indegree_increment_atomic(S, v, -1);
 	      stinger_outdegree_increment_atomic(S, u, -1);
+	      STINGER_STATS_EDGES_UPDATE(S, currentBlock->etype, -1);
 	    /* otherwise remove, remap, reinsert */
 	    } else if(match_v != v) {
 	      work_remaining = 1;
@@ -197,6 +199,7 @@ multi_contract_root(
 	      currentBlock->numEdges--;
 	      stinger_indegree_increment_atomic(S, v, -1);
 	      stinger_outdegree_increment_atomic(S, u, -1);
+	      STINGER_STATS_EDGES_UPDATE(S, currentBlock->etype, -1);
 	      stinger_incr_edge(S, currentBlock->etype, u, match_v, edge->weight, timestamp);
 	    }
 	  }
@@ -244,6 +247,7 @@ multi_contract_tree(
 	    currentBlock->numEdges--;
 	    stinger_indegree_increment_atomic(S, v, -1);
 	    stinger_outdegree_increment_atomic(S, u, -1);
+	    STINGER_STATS_EDGES_UPDATE(S, currentBlock->etype, -1);
 	  }
 	}
 	currentBlock = currentBlock->next + ebpool_priv;
@@ -19,10 +19,18 @@ pagerank(stinger_t * S, int64_t NV, double * pr, double epsilon, double dampingf
     for(uint64_t v = 0; v < NV; v++) {
       tmp_pr[v] = 0;
 
+#if defined(STINGER_USE_REVERSE_EDGES)
+      /* pull rank over the in-edges of v */
+      STINGER_FORALL_IN_EDGES_OF_VTX_BEGIN(S, v) {
+	tmp_pr[v] += (((double)pr[STINGER_IN_EDGE_SOURCE]) / 
+	  ((double) stinger_outdegree(S, STINGER_IN_EDGE_SOURCE)));
+      } STINGER_FORALL_IN_EDGES_OF_VTX_END();
+#else
       STINGER_FORALL_EDGES_OF_VTX_BEGIN(S, v) {
 	tmp_pr[v] += (((double)pr[STINGER_EDGE_DEST]) / 
 	  ((double) stinger_outdegree(S, STINGER_EDGE_DEST)));
       } STINGER_FORALL_EDGES_OF_VTX_END();
+#endif
     }
 
     OMP("omp parallel for")
@@ -1,4 +1,5 @@
 #include "int-ht-seq.h"
+#include "int-hm-par.h"
 #include "streaming_clustering_coefficients.h"
 #include "xmalloc.h"
 #include "stinger-atomics.h"
@@ -49,6 +50,38 @@ count_triangles(int_ht_seq_t * ht, stinger_t * S, int64_t v) {
   return count * 2;
 }
 
+/* Vertices at least this large are counted one at a time with every thread
+   working on the same neighbor set, rather than one per thread. */
+#define CC_PAR_DEGREE 4096
+
+static uint64_t
+count_triangles_par(int_ht_par_t * ht, stinger_t * S, int64_t v) {
+  uint64_t count = 0;
+  int64_t deg = stinger_outdegree_get(S, v);
+  int64_t * neighbors = xmalloc(deg * sizeof(int64_t));
+  size_t degree;
+  stinger_gather_successors(S, v, &degree, neighbors, NULL, NULL, NULL, NULL, deg);
+
+  OMP("omp parallel for")
+  for(uint64_t k = 0; k < degree; k++) {
+    int_ht_par_insert(ht, neighbors[k]);
+  }
+
+  /* with the whole neighborhood in the set each triangle is seen twice */
+  OMP("omp parallel for reduction(+:count) schedule(dynamic)")
+  for(uint64_t k = 0; k < degree; k++) {
+    STINGER_FORALL_EDGES_OF_VTX_BEGIN(S, neighbors[k]) {
+      if(STINGER_EDGE_DEST != v) {
+	count += int_ht_par_exists(ht, STINGER_EDGE_DEST);
+      }
+    } STINGER_FORALL_EDGES_OF_VTX_END();
+  }
+
+  free(neighbors);
+  int_ht_par_empty(ht);
+  return count;
+}
+
 static void
 count_all_triangles(stinger_t * S, int64_t nv, uint64_t * triangles) {
   OMP("omp parallel") 
@@ -58,7 +91,8 @@ count_all_triangles(stinger_t * S, int64_t nv, uint64_t * triangles) {
 
     OMP("omp for nowait") 
     for(uint64_t v = 0; v < nv; v++) {
-      if(stinger_outdegree_get(S,v)) {
+      int64_t deg = stinger_outdegree_get(S,v);
+      if(deg && deg < CC_PAR_DEGREE) {
 	triangles[v] = count_triangles(&ht, S, v);
       } else {
 	triangles[v] = 0;
@@ -67,8 +101,16 @@ count_all_triangles(stinger_t * S, int64_t nv, uint64_t * triangles) {
 
     int_ht_seq_free_internal(&ht);
   }
-}
 
+  int_ht_par_t * ht = NULL;
+  for(uint64_t v = 0; v < nv; v++) {
+    if(stinger_outdegree_get(S,v) >= CC_PAR_DEGREE) {
+      if(!ht) ht = int_ht_par_new(CC_PAR_DEGREE);
+      triangles[v] = count_triangles_par(ht, S, v);
+    }
+  }
+  int_ht_par_free(ht);
+}
 
 streaming_clustering_coefficients_workpace_t *
 streaming_clustering_coefficients_workspace_from_void(stinger_t * S, stinger_workflow_t * wkflow, void ** workspace) {
@@ -106,6 +106,12 @@ stinger_remove_and_insert_edges (struct stinger *G,
     return nrem;
   }
 
+#if defined(STINGER_USE_EDGE_INDEX)
+  /* slots move around below without the index knowing; drop it and rebuild
+     once done */
+  struct stinger_edge_index * idx = stinger_edge_index_lock (G, from);
+#endif
+
   curs = etype_begin (G, G->vertices,from,type);
   prev_loc = curs.loc;
 
@@ -235,6 +241,9 @@ stinger_remove_and_insert_edges (struct stinger *G,
 
   free (kslot);
   free (has_slot);
+#if defined(STINGER_USE_EDGE_INDEX)
+  stinger_edge_index_unlock (G, from, stinger_edge_index_rebuild (G, from, idx));
+#endif
   return (nrem + ninsert_remaining) > 0;
 }
 MTA("mta parallel default")
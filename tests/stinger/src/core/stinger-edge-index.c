@@ -0,0 +1,263 @@
+#include "stinger-edge-index.h"
+#include "xmalloc.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ *
+ * STINGER EDGE INDEX
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+static inline int64_t
+mix(int64_t n) {
+  n = (~n) + (n << 21); // n = (n << 21) - n - 1;
+  n = n ^ (n >> 24);
+  n = (n + (n << 3)) + (n << 8); // n * 265
+  n = n ^ (n >> 14);
+  n = (n + (n << 2)) + (n << 4); // n * 21
+  n = n ^ (n >> 28);
+  n = n + (n << 31);
+  return n;
+}
+
+static inline int64_t
+edge_key(int64_t neighbor, int64_t etype) {
+  return neighbor * STINGER_NUMETYPES + etype;
+}
+
+/* Keys and slots share one allocation, so a table is a single pointer; the
+   two words after the slots link the block into the retired list once it is
+   outgrown.  The arrays are filled in before the mask is published, so a
+   lookup that reads the mask first never indexes past the arrays it then
+   reads. */
+static void
+stinger_edge_index_init(stinger_edge_index_t * idx, int64_t size) {
+  size <<= 1;
+  int64_t pow = 16;
+
+  while(pow < size) {
+    pow <<= 1;
+  }
+
+  int64_t * keys = xmalloc(sizeof(int64_t) * (2 * pow + 2));
+  for(uint64_t i = 0; i < pow; i++) {
+    keys[i] = STINGER_EDGE_INDEX_EMPTY;
+  }
+
+  volatile stinger_edge_index_t * vidx = idx;
+  vidx->elements = 0;
+  vidx->keys = keys;
+  vidx->slots = keys + pow;
+  vidx->size = pow;
+  vidx->mask = pow-1;
+}
+
+/* A lookup may still be probing the old arrays, so keep them until free. */
+static void
+stinger_edge_index_retire(stinger_edge_index_t * idx, int64_t * keys, int64_t size) {
+  int64_t * link = keys + 2 * size;
+  link[0] = (int64_t)idx->retired;
+  link[1] = (int64_t)keys;
+  idx->retired = link;
+}
+
+static void
+stinger_edge_index_place(stinger_edge_index_t * idx, int64_t key, int64_t slot) {
+  int64_t i = mix(key) & idx->mask;
+  while(idx->keys[i] != STINGER_EDGE_INDEX_EMPTY && idx->keys[i] != key) {
+    i = (i+1) & idx->mask;
+  }
+
+  if(idx->keys[i] == STINGER_EDGE_INDEX_EMPTY) {
+    idx->keys[i] = key;
+    idx->elements++;
+  }
+  idx->slots[i] = slot;
+}
+
+static void
+stinger_edge_index_expand(stinger_edge_index_t * idx) {
+  int64_t old_size = idx->size;
+  int64_t * old_keys = idx->keys;
+  int64_t * old_slots = idx->slots;
+
+  stinger_edge_index_init(idx, old_size);
+  stinger_edge_index_retire(idx, old_keys, old_size);
+
+  for(uint64_t i = 0; i < old_size; i++) {
+    if(old_keys[i] != STINGER_EDGE_INDEX_EMPTY) {
+      stinger_edge_index_place(idx, old_keys[i], old_slots[i]);
+    }
+  }
+}
+
+/** @brief Allocate an empty edge index sized for the given number of edges.
+ *
+ *  @param size Expected number of edges
+ *  @return Pointer to the new index
+ */
+stinger_edge_index_t *
+stinger_edge_index_new(int64_t size) {
+  stinger_edge_index_t * rtn = xcalloc(1, sizeof(stinger_edge_index_t));
+  stinger_edge_index_init(rtn, size);
+  return rtn;
+}
+
+/** @brief Empty an edge index in place, sized for the given number of edges.
+ *
+ *  Unlike freeing it and making a new one, this leaves the index valid for
+ *  lookups that are still running.
+ *
+ *  @return idx
+ */
+stinger_edge_index_t *
+stinger_edge_index_clear(stinger_edge_index_t * idx, int64_t size) {
+  int64_t * old_keys = idx->keys;
+  int64_t old_size = idx->size;
+  stinger_edge_index_init(idx, size);
+  stinger_edge_index_retire(idx, old_keys, old_size);
+  for(int64_t t = 0; t < STINGER_NUMETYPES; t++) {
+    idx->nfree[t] = 0;
+  }
+  return idx;
+}
+
+/** @brief Free an edge index and its free-slot stacks.
+ *
+ *  @param idx The edge index (may be NULL)
+ *  @return NULL
+ */
+stinger_edge_index_t *
+stinger_edge_index_free(stinger_edge_index_t * idx) {
+  if(idx) {
+    free(idx->keys);
+    while(idx->retired) {
+      int64_t * link = idx->retired;
+      idx->retired = (int64_t *)link[0];
+      free((int64_t *)link[1]);
+    }
+    for(int64_t t = 0; t < STINGER_NUMETYPES; t++) {
+      free(idx->free_slots[t]);
+    }
+    free(idx);
+  }
+  return NULL;
+}
+
+/** @brief Find the slot holding the edge to neighbor of type etype.
+ *
+ *  Safe to call while a writer changes the index, but then the answer may be
+ *  wrong; check it with stinger_edge_index_read_valid().
+ *
+ *  @return The encoded slot, or -1 if the edge is not in the index.
+ */
+int64_t
+stinger_edge_index_lookup(const stinger_edge_index_t * idx, int64_t neighbor, int64_t etype) {
+  const volatile stinger_edge_index_t * vidx = idx;
+  const int64_t key = edge_key(neighbor, etype);
+  const int64_t mask = vidx->mask;
+  const int64_t * keys = vidx->keys;
+  const int64_t * slots = vidx->slots;
+  int64_t i = mix(key) & mask;
+
+  for(int64_t probes = 0; probes <= mask && keys[i] != STINGER_EDGE_INDEX_EMPTY; probes++) {
+    if(keys[i] == key) {
+      return slots[i];
+    }
+    i = (i+1) & mask;
+  }
+  return -1;
+}
+
+/** @brief Start a lock-free read of the index.
+ *
+ *  @return A sequence number for stinger_edge_index_read_valid(), or -1 if a
+ *  writer is changing the index now.
+ */
+int64_t
+stinger_edge_index_read_begin(const stinger_edge_index_t * idx) {
+  const int64_t seq = ((const volatile stinger_edge_index_t *)idx)->seq;
+  return (seq & 1) ? -1 : seq;
+}
+
+/** @brief Check that no writer changed the index since
+ *  stinger_edge_index_read_begin() returned seq.
+ */
+int
+stinger_edge_index_read_valid(const stinger_edge_index_t * idx, int64_t seq) {
+  return ((const volatile stinger_edge_index_t *)idx)->seq == seq;
+}
+
+/** @brief Record that the edge to neighbor of type etype lives in slot.
+ *
+ *  Overwrites the slot if the edge is already present.  Grows the table
+ *  when it passes half full.
+ */
+void
+stinger_edge_index_insert(stinger_edge_index_t * idx, int64_t neighbor, int64_t etype, int64_t slot) {
+  if(2 * (idx->elements + 1) > idx->size) {
+    stinger_edge_index_expand(idx);
+  }
+  stinger_edge_index_place(idx, edge_key(neighbor, etype), slot);
+}
+
+/** @brief Remove the edge to neighbor of type etype from the index.
+ *
+ *  Uses backward-shift deletion to keep probe sequences intact.
+ *
+ *  @return The encoded slot the edge occupied, or -1 if it was not present.
+ */
+int64_t
+stinger_edge_index_remove(stinger_edge_index_t * idx, int64_t neighbor, int64_t etype) {
+  const int64_t key = edge_key(neighbor, etype);
+  int64_t i = mix(key) & idx->mask;
+
+  while(idx->keys[i] != key) {
+    if(idx->keys[i] == STINGER_EDGE_INDEX_EMPTY) {
+      return -1;
+    }
+    i = (i+1) & idx->mask;
+  }
+
+  const int64_t rtn = idx->slots[i];
+  int64_t j = i;
+  while(1) {
+    j = (j+1) & idx->mask;
+    if(idx->keys[j] == STINGER_EDGE_INDEX_EMPTY) {
+      break;
+    }
+    /* move j back into the hole at i unless its home lies in (i, j] */
+    int64_t home = mix(idx->keys[j]) & idx->mask;
+    if(((j - home) & idx->mask) >= ((j - i) & idx->mask)) {
+      idx->keys[i] = idx->keys[j];
+      idx->slots[i] = idx->slots[j];
+      i = j;
+    }
+  }
+  idx->keys[i] = STINGER_EDGE_INDEX_EMPTY;
+  idx->elements--;
+
+  return rtn;
+}
+
+/** @brief Make an empty slot of type etype available to later insertions. */
+void
+stinger_edge_index_push_free(stinger_edge_index_t * idx, int64_t etype, int64_t slot) {
+  if(idx->nfree[etype] == idx->free_size[etype]) {
+    idx->free_size[etype] = idx->free_size[etype] ? 2 * idx->free_size[etype] : STINGER_EDGEBLOCKSIZE;
+    idx->free_slots[etype] = xrealloc(idx->free_slots[etype], idx->free_size[etype] * sizeof(int64_t));
+  }
+  idx->free_slots[etype][idx->nfree[etype]++] = slot;
+}
+
+/** @brief Take an empty slot of type etype.
+ *
+ *  @return The encoded slot, or -1 if a new edge block is needed.
+ */
+int64_t
+stinger_edge_index_pop_free(stinger_edge_index_t * idx, int64_t etype) {
+  if(idx->nfree[etype] == 0) {
+    return -1;
+  }
+  return idx->free_slots[etype][--idx->nfree[etype]];
+}
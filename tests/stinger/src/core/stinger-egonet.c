@@ -0,0 +1,279 @@
+#include "stinger-egonet.h"
+#include "stinger-internal.h"
+#include "stinger-atomics.h"
+#include "int-hm-par.h"
+#include "xmalloc.h"
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ *
+ * K-HOP NEIGHBORHOOD EXTRACTION
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+/* List every non-empty edge block of verts[0..n) along with the position of
+   its owner in verts.  Work is then split by block rather than by vertex so
+   that a hub does not end up on one thread. */
+static int64_t
+gather_blocks(stinger_t * S, const int64_t * verts, int64_t n,
+	      eb_index_t ** blocks_out, int64_t ** owner_out) {
+  struct stinger_eb * ebpool_priv = S->ebpool->ebpool;
+  int64_t * start = xcalloc(n + 1, sizeof(int64_t));
+
+  OMP("omp parallel for")
+  MTA("mta assert nodep")
+  for(int64_t u = 0; u < n; u++) {
+    int64_t count = 0;
+    for(eb_index_t cur = stinger_vertex_edges_get(S->vertices, verts[u]); cur; cur = ebpool_priv[cur].next) {
+      if(ebpool_priv[cur].numEdges)
+	count++;
+    }
+    start[u+1] = count;
+  }
+
+  for(int64_t u = 0; u < n; u++) {
+    start[u+1] += start[u];
+  }
+
+  eb_index_t * blocks = xmalloc((start[n] + 1) * sizeof(eb_index_t));
+  int64_t * owner = xmalloc((start[n] + 1) * sizeof(int64_t));
+
+  OMP("omp parallel for")
+  MTA("mta assert nodep")
+  for(int64_t u = 0; u < n; u++) {
+    int64_t place = start[u];
+    for(eb_index_t cur = stinger_vertex_edges_get(S->vertices, verts[u]); cur; cur = ebpool_priv[cur].next) {
+      if(ebpool_priv[cur].numEdges) {
+	blocks[place] = cur;
+	owner[place] = u;
+	place++;
+      }
+    }
+  }
+
+  int64_t nblocks = start[n];
+  free(start);
+  *blocks_out = blocks;
+  *owner_out = owner;
+  return nblocks;
+}
+
+static inline int
+block_in_window(const stinger_iterator_t * filter, const struct stinger_eb * eb) {
+  return !filter || !(filter->i.flags & 0x8) ||
+    stinger_eb_in_time_window(eb, filter->i.modified_after, filter->i.modified_before,
+			      filter->i.created_after, filter->i.created_before);
+}
+
+static inline int
+edge_passes(stinger_iterator_t * local, const struct stinger_eb * eb, int64_t k) {
+  if(eb->edges[k].neighbor < 0)
+    return 0;
+  return !local || stinger_iterator_edge_filter(local, eb, k);
+}
+
+/** @brief Extract the k-hop neighborhood of a vertex as a relabeled CSR graph.
+ *
+ *  Expands out-edges breadth first from seed for nhops hops, then returns the
+ *  subgraph induced on every vertex reached.  Both the expansion and the
+ *  induced edges honor the edge type, time, vertex type and predicate filters
+ *  of filter; its vertex filter is ignored.  Each hop is processed in parallel
+ *  over edge blocks, so a hub seed is expanded by all threads.
+ *
+ *  If caps is not NULL, a vertex at hop h follows at most caps[h] of its
+ *  edges when expanding (caps[h] <= 0 means no limit).  Which edges are
+ *  followed is not deterministic.
+ *
+ *  @param S The STINGER data structure
+ *  @param seed The vertex to start from
+ *  @param nhops The number of hops to expand
+ *  @param caps OPTIONAL Per-hop limit on edges followed per vertex, length nhops
+ *  @param filter OPTIONAL Iterator whose filters select the edges used
+ *  @return A new egonet, to be released with stinger_egonet_free()
+ */
+stinger_egonet_t *
+stinger_egonet_extract(stinger_t * S, int64_t seed, int64_t nhops, const int64_t * caps,
+		       stinger_iterator_t * filter) {
+  struct stinger_eb * ebpool_priv = S->ebpool->ebpool;
+  int_hm_par_t * seen = int_hm_par_new(1024);
+
+  int64_t size = 16;
+  int64_t nv = 1;
+  int64_t * l2g = xmalloc(size * sizeof(int64_t));
+  int64_t * hop = xmalloc(size * sizeof(int64_t));
+  l2g[0] = seed;
+  hop[0] = 0;
+  int_hm_par_fetch_add(seen, seed, 1);
+
+  int64_t fstart = 0;
+  for(int64_t h = 0; h < nhops && fstart < nv; h++) {
+    const int64_t fend = nv;
+    const int64_t cap = (caps && caps[h] > 0) ? caps[h] : 0;
+
+    /* no vertex can add more neighbors than it will follow */
+    int64_t bound = 0;
+    OMP("omp parallel for reduction(+:bound)")
+    for(int64_t u = fstart; u < fend; u++) {
+      int64_t deg = stinger_outdegree_get(S, l2g[u]);
+      bound += (cap && deg > cap) ? cap : deg;
+    }
+    if(fend + bound > size) {
+      size = fend + bound;
+      l2g = xrealloc(l2g, size * sizeof(int64_t));
+      hop = xrealloc(hop, size * sizeof(int64_t));
+    }
+
+    eb_index_t * blocks;
+    int64_t * owner;
+    int64_t nblocks = gather_blocks(S, l2g + fstart, fend - fstart, &blocks, &owner);
+    int64_t * taken = cap ? xcalloc(fend - fstart, sizeof(int64_t)) : NULL;
+
+    OMP("omp parallel")
+    {
+      stinger_iterator_t local_filter;
+      stinger_iterator_t * local = NULL;
+      if(filter && filter->i.flags) {
+	local_filter = *filter;
+	local = &local_filter;
+      }
+
+      OMP("omp for schedule(dynamic)")
+      for(int64_t b = 0; b < nblocks; b++) {
+	const struct stinger_eb * eb = ebpool_priv + blocks[b];
+	if(!block_in_window(filter, eb))
+	  continue;
+	for(int64_t k = 0; k < eb->high; k++) {
+	  if(!edge_passes(local, eb, k))
+	    continue;
+	  if(cap && stinger_int64_fetch_add(&taken[owner[b]], 1) >= cap)
+	    break;
+	  const int64_t dest = eb->edges[k].neighbor;
+	  if(0 == int_hm_par_fetch_add(seen, dest, 1)) {
+	    int64_t where = stinger_int64_fetch_add(&nv, 1);
+	    l2g[where] = dest;
+	    hop[where] = h + 1;
+	  }
+	}
+      }
+    }
+
+    free(taken);
+    free(owner);
+    free(blocks);
+    fstart = fend;
+  }
+
+  /* relabel: from here on the map holds local vertex IDs */
+  OMP("omp parallel for")
+  for(int64_t u = 0; u < nv; u++) {
+    int_hm_par_insert(seen, l2g[u], u);
+  }
+
+  /* count induced edges, then place them */
+  eb_index_t * blocks;
+  int64_t * owner;
+  int64_t nblocks = gather_blocks(S, l2g, nv, &blocks, &owner);
+  int64_t * off = xcalloc(nv + 2, sizeof(int64_t));
+
+  OMP("omp parallel")
+  {
+    stinger_iterator_t local_filter;
+    stinger_iterator_t * local = NULL;
+    if(filter && filter->i.flags) {
+      local_filter = *filter;
+      local = &local_filter;
+    }
+
+    OMP("omp for schedule(dynamic)")
+    for(int64_t b = 0; b < nblocks; b++) {
+      const struct stinger_eb * eb = ebpool_priv + blocks[b];
+      if(!block_in_window(filter, eb))
+	continue;
+      int64_t count = 0;
+      for(int64_t k = 0; k < eb->high; k++) {
+	if(edge_passes(local, eb, k) && int_hm_par_get(seen, eb->edges[k].neighbor) != INT_HM_PAR_EMPTY)
+	  count++;
+      }
+      if(count)
+	stinger_int64_fetch_add(&off[owner[b] + 2], count);
+    }
+  }
+
+  for(int64_t u = 2; u < nv + 2; u++) {
+    off[u] += off[u-1];
+  }
+
+  const int64_t ne = off[nv+1];
+  int64_t * ind = xmalloc((ne + 1) * sizeof(int64_t));
+  int64_t * weight = xmalloc((ne + 1) * sizeof(int64_t));
+  int64_t * timefirst = xmalloc((ne + 1) * sizeof(int64_t));
+  int64_t * timerecent = xmalloc((ne + 1) * sizeof(int64_t));
+  int64_t * type = xmalloc((ne + 1) * sizeof(int64_t));
+
+  /* off[u+1] is the insertion point for u; once every edge is placed it has
+     advanced to the start of u+1, leaving off[0..nv] as CSR offsets */
+  OMP("omp parallel")
+  {
+    stinger_iterator_t local_filter;
+    stinger_iterator_t * local = NULL;
+    if(filter && filter->i.flags) {
+      local_filter = *filter;
+      local = &local_filter;
+    }
+
+    OMP("omp for schedule(dynamic)")
+    for(int64_t b = 0; b < nblocks; b++) {
+      const struct stinger_eb * eb = ebpool_priv + blocks[b];
+      if(!block_in_window(filter, eb))
+	continue;
+      for(int64_t k = 0; k < eb->high; k++) {
+	if(!edge_passes(local, eb, k))
+	  continue;
+	int64_t local_dest = int_hm_par_get(seen, eb->edges[k].neighbor);
+	if(local_dest == INT_HM_PAR_EMPTY)
+	  continue;
+	int64_t where = stinger_int64_fetch_add(&off[owner[b] + 1], 1);
+	ind[where] = local_dest;
+	weight[where] = eb->edges[k].weight;
+	timefirst[where] = eb->edges[k].timeFirst;
+	timerecent[where] = eb->edges[k].timeRecent;
+	type[where] = eb->etype;
+      }
+    }
+  }
+
+  free(owner);
+  free(blocks);
+  int_hm_par_free(seen);
+
+  stinger_egonet_t * eg = xmalloc(sizeof(stinger_egonet_t));
+  eg->nv = nv;
+  eg->ne = ne;
+  eg->off = off;
+  eg->ind = ind;
+  eg->weight = weight;
+  eg->timefirst = timefirst;
+  eg->timerecent = timerecent;
+  eg->type = type;
+  eg->local_to_global = l2g;
+  eg->hop = hop;
+  return eg;
+}
+
+/** @brief Free an egonet and all of its arrays.
+ *
+ *  @param eg The egonet (may be NULL)
+ *  @return NULL
+ */
+stinger_egonet_t *
+stinger_egonet_free(stinger_egonet_t * eg) {
+  if(eg) {
+    free(eg->off);
+    free(eg->ind);
+    free(eg->weight);
+    free(eg->timefirst);
+    free(eg->timerecent);
+    free(eg->type);
+    free(eg->local_to_global);
+    free(eg->hop);
+    free(eg);
+  }
+  return NULL;
+}
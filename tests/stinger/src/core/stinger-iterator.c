@@ -396,6 +396,13 @@ stinger_iterator_check_predicate(stinger_iterator_t * iter);
 
 int
 stinger_iterator_check_time(stinger_iterator_t * iter) {
+  /* nothing in this block can match, so jump to its last edge */
+  if(!stinger_eb_in_time_window(iter->i.cur_eb,
+				iter->i.modified_after, iter->i.modified_before,
+				iter->i.created_after, iter->i.created_before)) {
+    iter->i.cur_edge = iter->i.cur_eb->high - 1;
+    return 0;
+  }
   return (iter->i.cur_eb->edges[iter->i.cur_edge].timeFirst > iter->i.created_after &&
 	  iter->i.cur_eb->edges[iter->i.cur_edge].timeFirst < iter->i.created_before &&
 	  iter->i.cur_eb->edges[iter->i.cur_edge].timeRecent > iter->i.modified_after &&
@@ -526,6 +533,38 @@ stinger_iterator_check_predicate(stinger_iterator_t * iter) {
   return iter->i.predicate(iter);
 }
 
+/** @brief Test a single edge against an iterator's edge filters.
+ *
+ * Applies the edge type, time, vertex type and custom predicate filters, but
+ * not the vertex filter, to edge k of block eb.  The iterator's position is
+ * overwritten, so parallel callers should each pass their own copy.
+ *
+ * @param iter The iterator holding the filters
+ * @param eb The edge block
+ * @param k The offset of the edge in the block
+ * @return A boolean int indicating the edge passes
+ */
+int
+stinger_iterator_edge_filter(stinger_iterator_t * iter, const struct stinger_eb * eb, int64_t k) {
+  iter->i.cur_eb = (struct stinger_eb *)eb;
+  iter->i.cur_edge = k;
+  stinger_iterator_get_metadata(iter);
+
+  if((iter->i.flags & 0x2) && !stinger_iterator_check_etype(iter))
+    return 0;
+  if((iter->i.flags & 0x8) &&
+     !(eb->edges[k].timeFirst > iter->i.created_after &&
+       eb->edges[k].timeFirst < iter->i.created_before &&
+       eb->edges[k].timeRecent > iter->i.modified_after &&
+       eb->edges[k].timeRecent < iter->i.modified_before))
+    return 0;
+  if((iter->i.flags & 0x4) && !stinger_iterator_check_vtype(iter))
+    return 0;
+  if((iter->i.flags & 0x10) && !stinger_iterator_check_predicate(iter))
+    return 0;
+  return 1;
+}
+
 /** @brief Advance an iterator to the next edge that matches the internal filter.
  *
  * This function will advance the iterator through the STINGER data in the most
@@ -0,0 +1,826 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "stinger-properties.h"
+#include "stinger-internal.h"
+#include "stinger-atomics.h"
+#include "stinger-utils.h"
+#include "int-hm-par.h"
+#include "x86-full-empty.h"
+#include "xmalloc.h"
+
+/**
+* @file stinger-properties.c
+* @brief Implementation of columnar vertex and edge properties.
+*/
+
+/* Codes start at 1 so that a zero-filled column reads as SP_STR_NONE.  The
+   first dictionary page holds SP_DICT_PAGE0 strings and every page after it
+   is twice the size of the one before, so a page is never moved once it has
+   been handed out and readers never race a realloc. */
+#define SP_DICT_PAGE0 1024
+#define SP_DICT_PAGES 48
+
+/* Edge columns are split into pages of SP_EDGE_PAGE slots (4096 edge blocks)
+   and a page is only allocated when one of its slots is first written, so an
+   edge column grows with the edge block pool rather than its capacity. */
+#define SP_EDGE_PAGE (4096 * STINGER_EDGEBLOCKSIZE)
+
+struct stinger_prop_dict {
+  int64_t	  count;  /**< Number of codes handed out, also the insertion lock */
+  char	       ** pages[SP_DICT_PAGES];
+  int_hm_par_t  * codes;  /**< String hash to code */
+};
+
+static const int64_t props_endian_check = 0x1234ABCD;
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ *
+ * STRING DICTIONARY
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+/* FNV-1a, shifted down so that the result is never one of the keys that
+   int_hm_par reserves. */
+static inline int64_t
+dict_hash(const char * str) {
+  uint64_t h = 14695981039346656037ULL;
+  while(*str) {
+    h ^= (uint8_t)*str++;
+    h *= 1099511628211ULL;
+  }
+  return (int64_t)(h >> 2);
+}
+
+static inline char **
+dict_slot(const struct stinger_prop_dict * dict, int64_t code) {
+  int64_t c = code - 1 + SP_DICT_PAGE0;
+  int64_t page = 63 - __builtin_clzll(c) - 10;
+  return dict->pages[page] + (c - (SP_DICT_PAGE0 << page));
+}
+
+static struct stinger_prop_dict *
+dict_new(void) {
+  struct stinger_prop_dict * dict = xcalloc(1, sizeof(struct stinger_prop_dict));
+  dict->codes = int_hm_par_new(SP_DICT_PAGE0);
+  return dict;
+}
+
+static void
+dict_free(struct stinger_prop_dict * dict) {
+  if(dict) {
+    for(int64_t p = 0; p < SP_DICT_PAGES; p++) {
+      if(dict->pages[p]) {
+	int64_t len = SP_DICT_PAGE0 << p;
+	for(int64_t i = 0; i < len; i++)
+	  free(dict->pages[p][i]);
+	free(dict->pages[p]);
+      }
+    }
+    int_hm_par_free(dict->codes);
+    free(dict);
+  }
+}
+
+/* Walk the probe chain for str starting at its hash.  Returns the code, or
+   SP_STR_NONE with *key_out set to the first unused key in the chain. */
+static int64_t
+dict_find(const struct stinger_prop_dict * dict, const char * str, int64_t * key_out) {
+  int64_t key = dict_hash(str);
+  while(1) {
+    int64_t code = int_hm_par_get(dict->codes, key);
+    if(code == INT_HM_PAR_EMPTY) {
+      if(key_out)
+	*key_out = key;
+      return SP_STR_NONE;
+    }
+    if(0 == strcmp(*dict_slot(dict, code), str)) {
+      return code;
+    }
+    key++;
+  }
+}
+
+static int64_t
+dict_add(struct stinger_prop_dict * dict, const char * str) {
+  int64_t key;
+  int64_t code = dict_find(dict, str, NULL);
+  if(code != SP_STR_NONE)
+    return code;
+
+  int64_t count = readfe((uint64_t *)&dict->count);
+
+  /* another thread may have added it while we waited */
+  code = dict_find(dict, str, &key);
+  if(code == SP_STR_NONE) {
+    code = count + 1;
+    int64_t page = 63 - __builtin_clzll(count + SP_DICT_PAGE0) - 10;
+    if(!dict->pages[page])
+      dict->pages[page] = xcalloc(SP_DICT_PAGE0 << page, sizeof(char *));
+    *dict_slot(dict, code) = strdup(str);
+    int_hm_par_insert(dict->codes, key, code);
+    count++;
+  }
+
+  writeef((uint64_t *)&dict->count, count);
+  return code;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ *
+ * STORE AND COLUMNS
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+/**
+* @brief Create an empty property store for a STINGER.
+*
+* @param S The STINGER whose vertices and edges the columns describe.
+*
+* @return A pointer to the new store.
+*/
+stinger_props_t *
+stinger_props_new(stinger_t * S) {
+  stinger_props_t * props = xmalloc(sizeof(stinger_props_t));
+
+  props->S		= S;
+  props->column_count	= 0;
+  props->column_size	= 10;
+  props->columns	= xmalloc(props->column_size * sizeof(stinger_prop_column_t *));
+
+  return props;
+}
+
+static void
+column_free(stinger_prop_column_t * col) {
+  if(col->pages) {
+    for(int64_t p = 0; p < col->npages; p++)
+      free(col->pages[p]);
+    free(col->pages);
+  }
+  free(col->data);
+  dict_free(col->dict);
+  free(col);
+}
+
+/**
+* @brief Free a property store and all of its columns. Sets the pointer to NULL.
+*
+* @param props The store.
+*
+* @return Returns a NULL pointer.
+*/
+stinger_props_t *
+stinger_props_free(stinger_props_t ** props) {
+  if(*props) {
+    for(int64_t c = 0; c < (*props)->column_count; c++) {
+      column_free((*props)->columns[c]);
+    }
+    free((*props)->columns);
+    free(*props);
+  }
+  *props = NULL;
+  return NULL;
+}
+
+/**
+* @brief Add a zero-filled column to the store.
+*
+* Vertex columns have one element per possible vertex ID and edge columns have
+* one element per edge block slot.  Edge columns start empty and allocate
+* their pages as slots are written.  Numeric and string columns always use
+* eight bytes per element; width is only used for SP_BYTES.
+*
+* @param props The store.
+* @param name The name of the column (must be unique in the store).
+* @param target SP_VERTEX or SP_EDGE.
+* @param type The element type.
+* @param width The size of an element in bytes for SP_BYTES.
+*
+* @return A pointer to the new column or NULL if the name is taken.
+*/
+stinger_prop_column_t *
+stinger_props_add_column(stinger_props_t * props, const char * name, stinger_prop_target_t target,
+			 stinger_prop_type_t type, int64_t width) {
+  if(stinger_props_get_column(props, name))
+    return NULL;
+
+  stinger_prop_column_t * col = xcalloc(1, sizeof(stinger_prop_column_t));
+
+  strncpy(col->name, name, sizeof(col->name) - 1);
+  col->target	= target;
+  col->type	= type;
+  col->width	= (type == SP_BYTES) ? width : sizeof(int64_t);
+  if(target == SP_VERTEX) {
+    col->elements = STINGER_MAX_LVERTICES;
+    col->data	  = xcalloc(col->elements, col->width);
+  } else {
+    col->elements = EBPOOL_SIZE * STINGER_EDGEBLOCKSIZE;
+    col->npages	  = (col->elements + SP_EDGE_PAGE - 1) / SP_EDGE_PAGE;
+    col->pages	  = xcalloc(col->npages, sizeof(uint8_t *));
+  }
+
+  if(type == SP_STR)
+    col->dict = dict_new();
+
+  if(props->column_count == props->column_size) {
+    props->column_size *= 2;
+    props->columns = xrealloc(props->columns, props->column_size * sizeof(stinger_prop_column_t *));
+  }
+  props->columns[props->column_count++] = col;
+
+  return col;
+}
+
+/**
+* @brief Find a column by name.
+*
+* @param props The store.
+* @param name The name of the column.
+*
+* @return A pointer to the column or NULL if there is no such column.
+*/
+stinger_prop_column_t *
+stinger_props_get_column(stinger_props_t * props, const char * name) {
+  for(int64_t c = 0; c < props->column_count; c++) {
+    if(0 == strcmp(props->columns[c]->name, name))
+      return props->columns[c];
+  }
+  return NULL;
+}
+
+/**
+* @brief Remove a column from the store and free it.
+*
+* @param props The store.
+* @param name The name of the column.
+*
+* @return STINGER_SUCCESS or STINGER_NOT_FOUND.
+*/
+stinger_return_t
+stinger_props_delete_column(stinger_props_t * props, const char * name) {
+  for(int64_t c = 0; c < props->column_count; c++) {
+    if(0 == strcmp(props->columns[c]->name, name)) {
+      column_free(props->columns[c]);
+      props->column_count--;
+      memmove(props->columns + c, props->columns + c + 1, (props->column_count - c) * sizeof(stinger_prop_column_t *));
+      return STINGER_SUCCESS;
+    }
+  }
+  return STINGER_NOT_FOUND;
+}
+
+/**
+* @brief Find the edge column element for an edge.
+*
+* Inside the out-edge traversal macros use STINGER_EDGE_SLOT instead.
+*
+* @param S The STINGER.
+* @param type The edge type.
+* @param from The source vertex.
+* @param to The destination vertex.
+*
+* @return The slot, or -1 if the edge does not exist.
+*/
+int64_t
+stinger_props_edge_slot(stinger_t * S, int64_t type, int64_t from, int64_t to) {
+  struct stinger_eb * ebpool_priv = S->ebpool->ebpool;
+  for(eb_index_t cur = stinger_vertex_edges_get(S->vertices, from); cur; cur = ebpool_priv[cur].next) {
+    struct stinger_eb * eb = ebpool_priv + cur;
+    if(eb->etype != type)
+      continue;
+    for(int64_t i = 0; i < eb->high; i++) {
+      if(eb->edges[i].neighbor == to)
+	return cur * STINGER_EDGEBLOCKSIZE + i;
+    }
+  }
+  return -1;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ *
+ * ELEMENT ACCESS
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+/* The address of element i, or NULL if it lives on an edge page that has not
+   been written yet. */
+static inline uint8_t *
+elem_peek(const stinger_prop_column_t * col, int64_t i) {
+  if(col->target == SP_VERTEX)
+    return col->data + i * col->width;
+  uint8_t * page = col->pages[i / SP_EDGE_PAGE];
+  return page ? page + (i % SP_EDGE_PAGE) * col->width : NULL;
+}
+
+/* The address of element i, allocating its edge page if needed.  Threads that
+   race on a new page agree on it with a compare-and-swap. */
+static inline uint8_t *
+elem_ptr(stinger_prop_column_t * col, int64_t i) {
+  uint8_t * elem = elem_peek(col, i);
+  if(!elem) {
+    int64_t * loc = (int64_t *)(col->pages + i / SP_EDGE_PAGE);
+    uint8_t * page = xcalloc(SP_EDGE_PAGE, col->width);
+    int64_t seen = stinger_int64_cas(loc, 0, (int64_t)page);
+    if(seen) {
+      free(page);
+      page = (uint8_t *)seen;
+    }
+    elem = page + (i % SP_EDGE_PAGE) * col->width;
+  }
+  return elem;
+}
+
+static inline int64_t
+elem_i64(const stinger_prop_column_t * col, int64_t i) {
+  const uint8_t * elem = elem_peek(col, i);
+  return elem ? *(const int64_t *)elem : 0;
+}
+
+int64_t
+stinger_prop_i64_get(const stinger_prop_column_t * col, int64_t i) {
+  return elem_i64(col, i);
+}
+
+void
+stinger_prop_i64_set(stinger_prop_column_t * col, int64_t i, int64_t val) {
+  *(int64_t *)elem_ptr(col, i) = val;
+}
+
+/**
+* @brief Atomically add to an SP_I64 element.
+*
+* @return The value before the addition.
+*/
+int64_t
+stinger_prop_i64_fetch_add(stinger_prop_column_t * col, int64_t i, int64_t val) {
+  return stinger_int64_fetch_add((int64_t *)elem_ptr(col, i), val);
+}
+
+double
+stinger_prop_dbl_get(const stinger_prop_column_t * col, int64_t i) {
+  const uint8_t * elem = elem_peek(col, i);
+  return elem ? *(const double *)elem : 0;
+}
+
+void
+stinger_prop_dbl_set(stinger_prop_column_t * col, int64_t i, double val) {
+  *(double *)elem_ptr(col, i) = val;
+}
+
+/**
+* @brief Atomically add to an SP_DBL element.
+*
+* Implemented as a compare-and-swap loop on the bits of the double.
+*
+* @return The value before the addition.
+*/
+double
+stinger_prop_dbl_fetch_add(stinger_prop_column_t * col, int64_t i, double val) {
+  int64_t * loc = (int64_t *)elem_ptr(col, i);
+  union { int64_t i; double d; } oldv, newv;
+
+  oldv.i = *loc;
+  while(1) {
+    newv.d = oldv.d + val;
+    int64_t seen = stinger_int64_cas(loc, oldv.i, newv.i);
+    if(seen == oldv.i)
+      break;
+    oldv.i = seen;
+  }
+  return oldv.d;
+}
+
+/**
+* @brief Get a pointer to an SP_BYTES element (col->width bytes long).
+*/
+uint8_t *
+stinger_prop_bytes_get(stinger_prop_column_t * col, int64_t i) {
+  return elem_ptr(col, i);
+}
+
+/**
+* @brief Get the code for a string in an SP_STR column, adding it to the
+* dictionary if needed.  Safe to call from many threads at once.
+*/
+int64_t
+stinger_prop_str_encode(stinger_prop_column_t * col, const char * str) {
+  return dict_add(col->dict, str);
+}
+
+/**
+* @brief Get the code for a string in an SP_STR column without adding it.
+*
+* @return The code or SP_STR_NONE if the string is not in the dictionary.
+*/
+int64_t
+stinger_prop_str_lookup(const stinger_prop_column_t * col, const char * str) {
+  return dict_find(col->dict, str, NULL);
+}
+
+/**
+* @brief Get the string for a code in an SP_STR column.
+*
+* @return The string (owned by the column) or NULL for SP_STR_NONE.
+*/
+const char *
+stinger_prop_str_decode(const stinger_prop_column_t * col, int64_t code) {
+  if(code <= 0)
+    return NULL;
+  return *dict_slot(col->dict, code);
+}
+
+void
+stinger_prop_str_set(stinger_prop_column_t * col, int64_t i, const char * str) {
+  *(int64_t *)elem_ptr(col, i) = str ? dict_add(col->dict, str) : SP_STR_NONE;
+}
+
+const char *
+stinger_prop_str_get(const stinger_prop_column_t * col, int64_t i) {
+  return stinger_prop_str_decode(col, elem_i64(col, i));
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ *
+ * PARALLEL SCANS
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+static inline double
+numeric_get(const stinger_prop_column_t * col, int64_t i) {
+  if(col->type == SP_DBL)
+    return stinger_prop_dbl_get(col, i);
+  return (double)elem_i64(col, i);
+}
+
+/**
+* @brief Sum an SP_I64 or SP_DBL vertex column over vertices [0, nv).
+*/
+double
+stinger_prop_vertex_sum(const stinger_prop_column_t * col, int64_t nv) {
+  double sum = 0;
+
+  OMP("omp parallel for reduction(+:sum)")
+  MTA("mta assert parallel")
+  for(int64_t v = 0; v < nv; v++) {
+    sum += numeric_get(col, v);
+  }
+
+  return sum;
+}
+
+/**
+* @brief Find the vertices in [0, nv) whose value in an SP_I64 or SP_DBL
+* column lies in [lo, hi].
+*
+* @param out Space for up to nv vertex IDs, filled in no particular order.
+*
+* @return The number of vertices written to out.
+*/
+int64_t
+stinger_prop_vertex_select(const stinger_prop_column_t * col, int64_t nv, double lo, double hi, int64_t * out) {
+  int64_t count = 0;
+
+  OMP("omp parallel for")
+  MTA("mta assert parallel")
+  for(int64_t v = 0; v < nv; v++) {
+    double val = numeric_get(col, v);
+    if(val >= lo && val <= hi) {
+      out[stinger_int64_fetch_add(&count, 1)] = v;
+    }
+  }
+
+  return count;
+}
+
+/**
+* @brief Sum an SP_I64 or SP_DBL edge column over the live edges of one type.
+*
+* Scans the edge type array directly, so the work is split by edge block.
+*/
+double
+stinger_prop_edge_sum(stinger_t * S, const stinger_prop_column_t * col, int64_t type) {
+  struct stinger_eb * ebpool_priv = S->ebpool->ebpool;
+  double sum = 0;
+
+  OMP("omp parallel for reduction(+:sum)")
+  MTA("mta assert parallel")
+  for(uint64_t p = 0; p < S->ETA[type].high; p++) {
+    eb_index_t cur = S->ETA[type].blocks[p];
+    struct stinger_eb * eb = ebpool_priv + cur;
+    for(int64_t i = 0; i < eb->high; i++) {
+      if(!stinger_eb_is_blank(eb, i))
+	sum += numeric_get(col, cur * STINGER_EDGEBLOCKSIZE + i);
+    }
+  }
+
+  return sum;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ *
+ * PERSISTENCE
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+/**
+* @brief Write every column in the store to a file.
+*
+* Vertex columns are written for vertices [0, maxVtx).  Edge slots do not
+* survive stinger_save_to_file() / stinger_open_from_file(), so edge columns
+* are written as (type, source, destination, value) records for each live
+* edge and matched back up to their new slots by stinger_props_load().
+*
+* @param props The store.
+* @param maxVtx The number of vertices to write, as for stinger_save_to_file().
+* @param propsfile The path of the file.
+*
+* @return 0 on success, -1 on failure.
+*/
+int
+stinger_props_save(stinger_props_t * props, uint64_t maxVtx, const char * propsfile) {
+  FILE * fp = fopen(propsfile, "wb");
+
+  if(!fp) {
+    fprintf (stderr, "%s %d: Can't open file \"%s\" for writing\n", __func__, __LINE__, propsfile);
+    return -1;
+  }
+
+  stinger_t * S = props->S;
+  struct stinger_eb * ebpool_priv = S->ebpool->ebpool;
+  int64_t header[3] = {props_endian_check, maxVtx, props->column_count};
+  fwrite(header, sizeof(int64_t), 3, fp);
+
+  for(int64_t c = 0; c < props->column_count; c++) {
+    stinger_prop_column_t * col = props->columns[c];
+    int64_t colhead[3] = {col->target, col->type, col->width};
+    fwrite(col->name, sizeof(char), sizeof(col->name), fp);
+    fwrite(colhead, sizeof(int64_t), 3, fp);
+
+    if(col->target == SP_VERTEX) {
+      fwrite(col->data, col->width, maxVtx, fp);
+    } else {
+      int64_t nrec = 0;
+      for(int64_t type = 0; type < STINGER_NUMETYPES; type++) {
+	for(uint64_t p = 0; p < S->ETA[type].high; p++) {
+	  nrec += ebpool_priv[S->ETA[type].blocks[p]].numEdges;
+	}
+      }
+      fwrite(&nrec, sizeof(int64_t), 1, fp);
+
+      /* slots on pages that were never written read as zero */
+      uint8_t * zero = xcalloc(1, col->width);
+
+      for(int64_t type = 0; type < STINGER_NUMETYPES; type++) {
+	for(uint64_t p = 0; p < S->ETA[type].high; p++) {
+	  eb_index_t cur = S->ETA[type].blocks[p];
+	  struct stinger_eb * eb = ebpool_priv + cur;
+	  for(int64_t i = 0; i < eb->high; i++) {
+	    if(!stinger_eb_is_blank(eb, i)) {
+	      int64_t rec[3] = {type, eb->vertexID, eb->edges[i].neighbor};
+	      fwrite(rec, sizeof(int64_t), 3, fp);
+	      const uint8_t * elem = elem_peek(col, cur * STINGER_EDGEBLOCKSIZE + i);
+	      fwrite(elem ? elem : zero, col->width, 1, fp);
+	    }
+	  }
+	}
+      }
+      free(zero);
+    }
+
+    if(col->type == SP_STR) {
+      int64_t count = col->dict->count;
+      fwrite(&count, sizeof(int64_t), 1, fp);
+      for(int64_t code = 1; code <= count; code++) {
+	const char * str = stinger_prop_str_decode(col, code);
+	int64_t len = strlen(str);
+	fwrite(&len, sizeof(int64_t), 1, fp);
+	fwrite(str, sizeof(char), len, fp);
+      }
+    }
+  }
+
+  int rtn = ferror(fp) ? -1 : 0;
+  fclose(fp);
+  return rtn;
+}
+
+static int
+read_i64(FILE * fp, int64_t * out, int64_t n, int swap) {
+  if(fread(out, sizeof(int64_t), n, fp) != n)
+    return -1;
+  if(swap)
+    bs64_n(n, out);
+  return 0;
+}
+
+/* Spread an edge key over a table of mask+1 slots. */
+static inline int64_t
+edge_hash(int64_t key, int64_t mask) {
+  return (int64_t)(((uint64_t)key * 0x9E3779B97F4A7C15ULL) >> 24) & mask;
+}
+
+/* Copy the values of nrec edge records, rows of {type, from, to} in recs,
+   into the edge column col.  The records are bucketed by source vertex and
+   each source's block chain is walked once into a scratch table of edge to
+   slot, so a hub costs one walk rather than one per record.  A repeated
+   record keeps the value that comes last in the file. */
+static void
+props_load_edges(stinger_props_t * props, stinger_prop_column_t * col, int64_t nrec,
+		 const int64_t * recs, const uint8_t * vals) {
+  stinger_t * S = props->S;
+  struct stinger_eb * ebpool_priv = S->ebpool->ebpool;
+
+#define REC_VALID(rec) ((rec)[0] >= 0 && (rec)[0] < STINGER_NUMETYPES && \
+			(rec)[1] >= 0 && (rec)[1] < STINGER_MAX_LVERTICES && (rec)[2] >= 0)
+
+  int64_t nv = 0;
+  for(int64_t r = 0; r < nrec; r++) {
+    const int64_t * rec = recs + 3 * r;
+    if(REC_VALID(rec) && rec[1] >= nv)
+      nv = rec[1] + 1;
+  }
+
+  /* counting sort of the record numbers by source, stable within a source */
+  int64_t * start = xcalloc(nv + 1, sizeof(int64_t));
+  int64_t * next = xmalloc((nv + 1) * sizeof(int64_t));
+  int64_t * order = xmalloc((nrec + 1) * sizeof(int64_t));
+  for(int64_t r = 0; r < nrec; r++) {
+    const int64_t * rec = recs + 3 * r;
+    if(REC_VALID(rec))
+      start[rec[1] + 1]++;
+  }
+  for(int64_t v = 0; v < nv; v++)
+    start[v + 1] += start[v];
+  memcpy(next, start, nv * sizeof(int64_t));
+  for(int64_t r = 0; r < nrec; r++) {
+    const int64_t * rec = recs + 3 * r;
+    if(REC_VALID(rec))
+      order[next[rec[1]]++] = r;
+  }
+
+#undef REC_VALID
+
+  int64_t size = 0;
+  int64_t * keys = NULL;
+  int64_t * slots = NULL;
+  for(int64_t v = 0; v < nv; v++) {
+    if(start[v] == start[v + 1])
+      continue;
+
+    int64_t bound = 0;
+    for(eb_index_t cur = stinger_vertex_edges_get(S->vertices, v); cur; cur = ebpool_priv[cur].next)
+      bound += ebpool_priv[cur].high;
+    int64_t pow = 16;
+    while(pow < 2 * bound)
+      pow <<= 1;
+    if(pow > size) {
+      size = pow;
+      keys = xrealloc(keys, size * sizeof(int64_t));
+      slots = xrealloc(slots, size * sizeof(int64_t));
+    }
+    const int64_t mask = pow - 1;
+    for(int64_t i = 0; i < pow; i++)
+      keys[i] = -1;
+
+    for(eb_index_t cur = stinger_vertex_edges_get(S->vertices, v); cur; cur = ebpool_priv[cur].next) {
+      struct stinger_eb * eb = ebpool_priv + cur;
+      for(int64_t i = 0; i < eb->high; i++) {
+	if(stinger_eb_is_blank(eb, i))
+	  continue;
+	const int64_t key = eb->edges[i].neighbor * STINGER_NUMETYPES + eb->etype;
+	int64_t h = edge_hash(key, mask);
+	while(keys[h] != -1)
+	  h = (h + 1) & mask;
+	keys[h] = key;
+	slots[h] = cur * STINGER_EDGEBLOCKSIZE + i;
+      }
+    }
+
+    for(int64_t q = start[v]; q < start[v + 1]; q++) {
+      const int64_t * rec = recs + 3 * order[q];
+      const int64_t key = rec[2] * STINGER_NUMETYPES + rec[0];
+      int64_t h = edge_hash(key, mask);
+      while(keys[h] != -1 && keys[h] != key)
+	h = (h + 1) & mask;
+      if(keys[h] == key)
+	memcpy(stinger_prop_bytes_get(col, slots[h]), vals + order[q] * col->width, col->width);
+    }
+  }
+
+  free(keys);
+  free(slots);
+  free(order);
+  free(next);
+  free(start);
+}
+
+/**
+* @brief Read columns written by stinger_props_save() into a store.
+*
+* Columns are created if the store does not have them yet; an existing column
+* with the same name must have the same target, type, and width.  Edge records
+* whose edge is not in props->S are skipped.  Each source vertex's block chain
+* is walked once, however many of its edges have records.
+*
+* @param props The store, usually for a STINGER from stinger_open_from_file().
+* @param propsfile The path of the file.
+*
+* @return 0 on success, -1 on failure.
+*/
+int
+stinger_props_load(stinger_props_t * props, const char * propsfile) {
+  FILE * fp = fopen(propsfile, "rb");
+
+  if(!fp) {
+    fprintf (stderr, "%s %d: Can't open file \"%s\" for reading\n", __func__, __LINE__, propsfile);
+    return -1;
+  }
+
+  int64_t header[3];
+  if(fread(header, sizeof(int64_t), 3, fp) != 3) {
+    fprintf (stderr, "%s %d: Fread of file \"%s\" failed.\n", __func__, __LINE__, propsfile);
+    fclose(fp);
+    return -1;
+  }
+
+  int swap = (header[0] != props_endian_check);
+  if(swap)
+    bs64_n(3, header);
+
+  int64_t maxVtx = header[1];
+  int64_t ncols = header[2];
+
+  if(maxVtx > STINGER_MAX_LVERTICES) {
+    fprintf (stderr, "%s %d: Vertices in file \"%s\" larger than STINGER_MAX_LVERTICES\n", __func__, __LINE__, propsfile);
+    fclose(fp);
+    return -1;
+  }
+
+  for(int64_t c = 0; c < ncols; c++) {
+    char name[1024];
+    int64_t colhead[3];
+    if(fread(name, sizeof(char), sizeof(name), fp) != sizeof(name) || read_i64(fp, colhead, 3, swap)) {
+      goto read_failed;
+    }
+    name[sizeof(name) - 1] = '\0';
+
+    stinger_prop_column_t * col = stinger_props_get_column(props, name);
+    if(!col) {
+      col = stinger_props_add_column(props, name, colhead[0], colhead[1], colhead[2]);
+    } else if(col->target != colhead[0] || col->type != colhead[1] || col->width != colhead[2]) {
+      fprintf (stderr, "%s %d: Column \"%s\" in file \"%s\" does not match the store\n", __func__, __LINE__, name, propsfile);
+      fclose(fp);
+      return -1;
+    }
+    int swap_data = swap && col->type != SP_BYTES;
+
+    if(col->target == SP_VERTEX) {
+      if(fread(col->data, col->width, maxVtx, fp) != maxVtx)
+	goto read_failed;
+      if(swap_data)
+	bs64_n(maxVtx, (int64_t *)col->data);
+    } else {
+      int64_t nrec;
+      if(read_i64(fp, &nrec, 1, swap))
+	goto read_failed;
+
+      int64_t * recs = xmalloc(3 * sizeof(int64_t) * (nrec + 1));
+      uint8_t * vals = xmalloc(col->width * (nrec + 1));
+      for(int64_t r = 0; r < nrec; r++) {
+	uint8_t * val = vals + r * col->width;
+	if(read_i64(fp, recs + 3 * r, 3, swap) || fread(val, col->width, 1, fp) != 1) {
+	  free(recs);
+	  free(vals);
+	  goto read_failed;
+	}
+	if(swap_data)
+	  bs64_n(1, (int64_t *)val);
+      }
+      props_load_edges(props, col, nrec, recs, vals);
+      free(recs);
+      free(vals);
+    }
+
+    if(col->type == SP_STR) {
+      /* rebuild the dictionary with the codes it had when it was saved */
+      dict_free(col->dict);
+      col->dict = dict_new();
+
+      int64_t count;
+      if(read_i64(fp, &count, 1, swap))
+	goto read_failed;
+      for(int64_t code = 0; code < count; code++) {
+	int64_t len;
+	if(read_i64(fp, &len, 1, swap))
+	  goto read_failed;
+	char * str = xmalloc(len + 1);
+	if(fread(str, sizeof(char), len, fp) != len) {
+	  free(str);
+	  goto read_failed;
+	}
+	str[len] = '\0';
+	dict_add(col->dict, str);
+	free(str);
+      }
+    }
+  }
+
+  fclose(fp);
+  return 0;
+
+read_failed:
+  fprintf (stderr, "%s %d: Fread of file \"%s\" failed.\n", __func__, __LINE__, propsfile);
+  fclose(fp);
+  return -1;
+}
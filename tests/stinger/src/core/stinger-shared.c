@@ -0,0 +1,299 @@
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "stinger-shared.h"
+#include "stinger-internal.h"
+#include "stinger-atomics.h"
+#include "stinger-edge-index.h"
+#include "stinger-stats.h"
+#include "xmalloc.h"
+
+/**
+* @file stinger-shared.c
+* @brief Implementation of the shared memory STINGER.
+*/
+
+#define STINGER_SHARED_MAGIC 0x5354494E47455253L  /* "STINGERS" */
+#define STINGER_SHARED_ALIGN 4096
+
+/* Sits at the start of the region.  The layout fields let a reader refuse a
+   region built with different compile-time limits. */
+struct stinger_shared_header {
+  int64_t	    magic;
+  int64_t	    size;
+  int64_t	    max_lvertices;
+  int64_t	    numetypes;
+  int64_t	    edgeblocksize;
+  int64_t	    vertices_off;
+  int64_t	    physmap_off;
+  int64_t	    eta_off;
+  int64_t	    ebpool_off;
+  int64_t	    stats_off;
+  int64_t	    writer_pid;
+  volatile int64_t  seq;  /**< Twice the number of finished batches, plus one during a batch */
+};
+
+static inline int64_t
+align_up(int64_t x) {
+  return (x + STINGER_SHARED_ALIGN - 1) & ~(int64_t)(STINGER_SHARED_ALIGN - 1);
+}
+
+/* Lay out the sections of the region and return its total size. */
+static int64_t
+layout(stinger_shared_header_t * h) {
+  int64_t off = align_up(sizeof(stinger_shared_header_t));
+
+  h->vertices_off = off;
+  off = align_up(off + sizeof(stinger_vertices_t) + STINGER_MAX_LVERTICES * sizeof(stinger_vertex_t));
+#if !defined(STINGER_FORCE_OLD_MAP)
+  h->physmap_off = off;
+  off = align_up(off + sizeof(stinger_physmap_t) + STINGER_MAX_LVERTICES * 128);
+#endif
+  h->eta_off = off;
+  off = align_up(off + STINGER_NUMETYPES * sizeof(struct stinger_etype_array));
+  h->ebpool_off = off;
+  off = align_up(off + sizeof(struct stinger_ebpool));
+#if defined(STINGER_USE_STATS)
+  h->stats_off = off;
+  off = align_up(off + sizeof(struct stinger_stats));
+#endif
+
+  return off;
+}
+
+/* Point a process-local struct stinger at the sections of a mapping. */
+static stinger_t *
+attach(stinger_shared_header_t * h) {
+  uint8_t * base = (uint8_t *)h;
+  stinger_t * S = xcalloc(1, sizeof(stinger_t));
+
+  S->vertices = (stinger_vertices_t *)(base + h->vertices_off);
+#if !defined(STINGER_FORCE_OLD_MAP)
+  S->physmap = (stinger_physmap_t *)(base + h->physmap_off);
+#endif
+  S->ETA = (struct stinger_etype_array *)(base + h->eta_off);
+  S->ebpool = (struct stinger_ebpool *)(base + h->ebpool_off);
+#if defined(STINGER_USE_STATS)
+  S->stats = (struct stinger_stats *)(base + h->stats_off);
+#endif
+
+  return S;
+}
+
+/**
+* @brief Create a new, empty STINGER in a named shared memory region.
+*
+* The caller becomes the only writer.  The region is sized for the
+* compile-time limits, but like stinger_new() only touched pages use memory.
+*
+* @param name The POSIX shared memory name, e.g. "/stinger".  Must not exist.
+* @param shared Output: the handle, with the graph in (*shared)->S.
+*
+* @return 0 on success, -1 on failure.
+*/
+int
+stinger_shared_new(const char * name, stinger_shared_t ** shared) {
+  stinger_shared_header_t h;
+  memset(&h, 0, sizeof(h));
+  int64_t size = layout(&h);
+
+  int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+  if(fd < 0) {
+    fprintf (stderr, "%s %d: Can't create shared memory \"%s\"\n", __func__, __LINE__, name);
+    return -1;
+  }
+
+  if(ftruncate(fd, size)) {
+    fprintf (stderr, "%s %d: Can't size shared memory \"%s\"\n", __func__, __LINE__, name);
+    close(fd);
+    shm_unlink(name);
+    return -1;
+  }
+
+  void * base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_NORESERVE, fd, 0);
+  close(fd);
+  if(base == MAP_FAILED) {
+    fprintf (stderr, "%s %d: Can't map shared memory \"%s\"\n", __func__, __LINE__, name);
+    shm_unlink(name);
+    return -1;
+  }
+
+  /* the region starts zeroed, so only the non-zero fields of stinger_new() need setting */
+  stinger_shared_header_t * header = base;
+  h.magic	    = STINGER_SHARED_MAGIC;
+  h.size	    = size;
+  h.max_lvertices   = STINGER_MAX_LVERTICES;
+  h.numetypes	    = STINGER_NUMETYPES;
+  h.edgeblocksize   = STINGER_EDGEBLOCKSIZE;
+  h.writer_pid	    = getpid();
+  h.seq		    = 0;
+  *header = h;
+
+  stinger_t * S = attach(header);
+  S->vertices->max_vertices = STINGER_MAX_LVERTICES;
+#if !defined(STINGER_FORCE_OLD_MAP)
+  S->physmap->size = STINGER_MAX_LVERTICES * 128;
+  S->physmap->top = 1;
+#endif
+  for(int64_t i = 0; i < STINGER_NUMETYPES; i++) {
+    S->ETA[i].length = EBPOOL_SIZE;
+    S->ETA[i].high = 0;
+  }
+  S->ebpool->ebpool_tail = 1;
+  S->ebpool->is_shared = 1;
+  S->ebpool->nfree = 0;
+#if defined(STINGER_USE_EDGE_INDEX)
+  S->eindex = xcalloc (STINGER_MAX_LVERTICES, sizeof (*S->eindex));
+#endif
+
+  stinger_shared_t * rtn = xcalloc(1, sizeof(stinger_shared_t));
+  strncpy(rtn->name, name, sizeof(rtn->name) - 1);
+  rtn->is_writer = 1;
+  rtn->size = size;
+  rtn->header = header;
+  rtn->S = S;
+
+  *shared = rtn;
+  return 0;
+}
+
+/**
+* @brief Attach read-only to a STINGER created by stinger_shared_new().
+*
+* Attaching maps the region and fills in a local struct stinger; nothing is
+* copied, so the cost does not depend on the size of the graph.
+*
+* @param name The POSIX shared memory name given to the writer.
+* @param shared Output: the handle, with the graph in (*shared)->S.
+*
+* @return 0 on success, -1 on failure.
+*/
+int
+stinger_shared_map(const char * name, stinger_shared_t ** shared) {
+  int fd = shm_open(name, O_RDONLY, 0);
+  if(fd < 0) {
+    fprintf (stderr, "%s %d: Can't open shared memory \"%s\"\n", __func__, __LINE__, name);
+    return -1;
+  }
+
+  struct stat st;
+  if(fstat(fd, &st) || st.st_size < sizeof(stinger_shared_header_t)) {
+    fprintf (stderr, "%s %d: Shared memory \"%s\" is not a STINGER\n", __func__, __LINE__, name);
+    close(fd);
+    return -1;
+  }
+
+  void * base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if(base == MAP_FAILED) {
+    fprintf (stderr, "%s %d: Can't map shared memory \"%s\"\n", __func__, __LINE__, name);
+    return -1;
+  }
+
+  stinger_shared_header_t mine;
+  stinger_shared_header_t * header = base;
+  if(header->magic != STINGER_SHARED_MAGIC || header->size != st.st_size || header->size != layout(&mine) ||
+     header->max_lvertices != STINGER_MAX_LVERTICES || header->numetypes != STINGER_NUMETYPES ||
+     header->edgeblocksize != STINGER_EDGEBLOCKSIZE) {
+    fprintf (stderr, "%s %d: Shared memory \"%s\" was built with a different STINGER configuration\n", __func__, __LINE__, name);
+    munmap(base, st.st_size);
+    return -1;
+  }
+
+  stinger_shared_t * rtn = xcalloc(1, sizeof(stinger_shared_t));
+  strncpy(rtn->name, name, sizeof(rtn->name) - 1);
+  rtn->is_writer = 0;
+  rtn->size = st.st_size;
+  rtn->header = header;
+  rtn->S = attach(header);
+
+  *shared = rtn;
+  return 0;
+}
+
+/**
+* @brief Detach from a shared STINGER. Sets the pointer to NULL.
+*
+* A reader only unmaps the region.  The writer also removes the name, but
+* readers that are still attached keep their mapping until they detach.
+*
+* @param shared The handle.
+*
+* @return Returns a NULL pointer.
+*/
+stinger_shared_t *
+stinger_shared_free(stinger_shared_t ** shared) {
+  if(*shared) {
+    stinger_shared_t * sh = *shared;
+#if defined(STINGER_USE_EDGE_INDEX)
+    if(sh->is_writer) {
+      for(int64_t v = 0; v < STINGER_MAX_LVERTICES; v++)
+	stinger_edge_index_free (sh->S->eindex[v]);
+      free(sh->S->eindex);
+    }
+#endif
+    free(sh->S);
+    munmap(sh->header, sh->size);
+    if(sh->is_writer)
+      shm_unlink(sh->name);
+    free(sh);
+  }
+  *shared = NULL;
+  return NULL;
+}
+
+/**
+* @brief Mark the start of a batch of updates.  Writer only.
+*
+* @return The epoch that the batch will produce.
+*/
+int64_t
+stinger_shared_batch_begin(stinger_shared_t * shared) {
+  return stinger_shared_epoch(stinger_int64_fetch_add((int64_t *)&shared->header->seq, 1)) + 1;
+}
+
+/**
+* @brief Mark the end of a batch of updates.  Writer only.
+*
+* @return The epoch that is now visible to readers.
+*/
+int64_t
+stinger_shared_batch_end(stinger_shared_t * shared) {
+  return stinger_shared_epoch(stinger_int64_fetch_add((int64_t *)&shared->header->seq, 1) + 1);
+}
+
+/**
+* @brief Take the sequence number before reading the graph.  Never waits.
+*
+* @return The sequence number to hand to stinger_shared_read_end().
+*/
+int64_t
+stinger_shared_read_begin(const stinger_shared_t * shared) {
+  int64_t seq = shared->header->seq;
+  __sync_synchronize();
+  return seq;
+}
+
+/**
+* @brief Check whether the reads since stinger_shared_read_begin() saw a
+* single epoch.
+*
+* @return 1 if no batch was in progress or finished in between, else 0.
+*/
+int
+stinger_shared_read_end(const stinger_shared_t * shared, int64_t seq) {
+  __sync_synchronize();
+  return !(seq & 1) && shared->header->seq == seq;
+}
+
+/**
+* @brief The number of batches finished as of a sequence number.
+*/
+int64_t
+stinger_shared_epoch(int64_t seq) {
+  return seq >> 1;
+}
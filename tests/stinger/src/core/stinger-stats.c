@@ -0,0 +1,187 @@
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include "stinger.h"
+#include "stinger-internal.h"
+#include "stinger-atomics.h"
+#include "stinger-stats.h"
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ *
+ * INCREMENTAL GRAPH STATISTICS
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#if defined(STINGER_USE_STATS)
+
+static inline struct stinger_stats_slot *
+my_slot(struct stinger_stats * stats) {
+#if defined(_OPENMP)
+  return stats->slot + (omp_get_thread_num() & (STINGER_STATS_SLOTS - 1));
+#else
+  return stats->slot;
+#endif
+}
+
+static inline int64_t
+degree_bucket(int64_t deg) {
+  return 63 - __builtin_clzll(deg);
+}
+
+static inline void
+atomic_max(int64_t * x, int64_t val) {
+  int64_t cur = *x;
+  while(val > cur) {
+    int64_t seen = stinger_int64_cas(x, cur, val);
+    if(seen == cur)
+      break;
+    cur = seen;
+  }
+}
+
+/** @brief Record delta edges of the given type being added or removed. */
+void
+stinger_stats_edges_update(struct stinger_stats * stats, int64_t type, int64_t delta) {
+  if(delta)
+    stinger_int64_fetch_add(&my_slot(stats)->edges[type], delta);
+}
+
+/** @brief Record vertex v's out-degree moving from old_deg to new_deg. */
+void
+stinger_stats_outdegree_update(struct stinger_stats * stats, int64_t v, int64_t old_deg, int64_t new_deg) {
+  if(old_deg == new_deg)
+    return;
+
+  struct stinger_stats_slot * slot = my_slot(stats);
+  int64_t old_bucket = old_deg > 0 ? degree_bucket(old_deg) : -1;
+  int64_t new_bucket = new_deg > 0 ? degree_bucket(new_deg) : -1;
+  if(old_bucket != new_bucket) {
+    if(old_bucket >= 0)
+      stinger_int64_fetch_add(&slot->outdegree_hist[old_bucket], -1);
+    if(new_bucket >= 0)
+      stinger_int64_fetch_add(&slot->outdegree_hist[new_bucket], 1);
+  }
+
+  if(new_deg > old_deg) {
+    atomic_max(&stats->max_outdegree, new_deg);
+  } else if(old_deg == stats->max_outdegree) {
+    stats->max_outdegree_stale = 1;
+  }
+}
+
+/** @brief Record vertex v's in-degree plus out-degree moving from old_total
+ *  to new_total.
+ */
+void
+stinger_stats_activity_update(struct stinger_stats * stats, int64_t v, int64_t old_total, int64_t new_total) {
+  if(old_total == 0 && new_total > 0) {
+    stinger_int64_fetch_add(&my_slot(stats)->active_vertices, 1);
+    atomic_max(&stats->max_active_vertex, v);
+  } else if(old_total > 0 && new_total == 0) {
+    stinger_int64_fetch_add(&my_slot(stats)->active_vertices, -1);
+    if(v == stats->max_active_vertex)
+      stats->max_active_vertex_stale = 1;
+  }
+}
+
+/**
+* @brief Number of edges of one type.
+*
+* @param S The STINGER data structure
+* @param type The edge type
+*
+* @return The number of edges of that type
+*/
+int64_t
+stinger_stats_edges(const struct stinger * S, int64_t type) {
+  int64_t rtn = 0;
+  for(int64_t t = 0; t < STINGER_STATS_SLOTS; t++)
+    rtn += S->stats->slot[t].edges[type];
+  return rtn;
+}
+
+/**
+* @brief Number of edges of all types, as stinger_total_edges().
+*/
+int64_t
+stinger_stats_total_edges(const struct stinger * S) {
+  int64_t rtn = 0;
+  for(int64_t t = 0; t < STINGER_STATS_SLOTS; t++)
+    for(int64_t type = 0; type < STINGER_NUMETYPES; type++)
+      rtn += S->stats->slot[t].edges[type];
+  return rtn;
+}
+
+/**
+* @brief Number of vertices with in-degree or out-degree greater than zero, as
+* stinger_num_active_vertices().
+*/
+int64_t
+stinger_stats_active_vertices(const struct stinger * S) {
+  int64_t rtn = 0;
+  for(int64_t t = 0; t < STINGER_STATS_SLOTS; t++)
+    rtn += S->stats->slot[t].active_vertices;
+  return rtn;
+}
+
+/**
+* @brief Largest vertex ID with in-degree or out-degree greater than zero, as
+* stinger_max_active_vertex().
+*
+* Rescans the vertices if the previous largest vertex has become inactive.
+*/
+int64_t
+stinger_stats_max_active_vertex(const struct stinger * S) {
+  struct stinger_stats * stats = S->stats;
+  if(stats->max_active_vertex_stale) {
+    stats->max_active_vertex_stale = 0;
+    int64_t out = 0;
+    OMP("omp parallel for reduction(max:out)")
+    for(int64_t v = 0; v < STINGER_MAX_LVERTICES; v++) {
+      if(stinger_indegree_get(S, v) > 0 || stinger_outdegree_get(S, v) > 0)
+	out = v;
+    }
+    stats->max_active_vertex = out;
+  }
+  return stats->max_active_vertex;
+}
+
+/**
+* @brief Largest out-degree of any vertex.
+*
+* Rescans the vertices if the vertex holding the previous maximum has lost
+* an edge.
+*/
+int64_t
+stinger_stats_max_outdegree(const struct stinger * S) {
+  struct stinger_stats * stats = S->stats;
+  if(stats->max_outdegree_stale) {
+    stats->max_outdegree_stale = 0;
+    int64_t out = 0;
+    OMP("omp parallel for reduction(max:out)")
+    for(int64_t v = 0; v < STINGER_MAX_LVERTICES; v++) {
+      int64_t deg = stinger_outdegree_get(S, v);
+      if(deg > out)
+	out = deg;
+    }
+    stats->max_outdegree = out;
+  }
+  return stats->max_outdegree;
+}
+
+/**
+* @brief Copy out the out-degree histogram.
+*
+* @param S The STINGER data structure
+* @param hist Output: STINGER_STATS_DEGREE_BUCKETS counts, bucket b holding
+* the number of vertices with out-degree in [2^b, 2^(b+1))
+*/
+void
+stinger_stats_outdegree_histogram(const struct stinger * S, int64_t * hist) {
+  for(int64_t b = 0; b < STINGER_STATS_DEGREE_BUCKETS; b++) {
+    hist[b] = 0;
+    for(int64_t t = 0; t < STINGER_STATS_SLOTS; t++)
+      hist[b] += S->stats->slot[t].outdegree_hist[b];
+  }
+}
+
+#endif /* STINGER_USE_STATS */
@@ -144,6 +144,16 @@ stinger_vertex_outdegree_increment_atomic(const stinger_vertices_t * vertices, v
   return stinger_vdegree_fetch_add_atomic(&(VTX(v)->outDegree), degree);
 }
 
+#if defined(STINGER_USE_STATS)
+/* TOTAL DEGREE */
+
+inline vdegree_t
+stinger_vertex_totaldegree_increment_atomic(const stinger_vertices_t * vertices, vindex_t v, vdegree_t degree)
+{
+  return stinger_vdegree_fetch_add_atomic(&(VTX(v)->totalDegree), degree);
+}
+#endif
+
 /* EDGES */
 
 inline adjacency_t
@@ -170,6 +180,28 @@ stinger_vertex_edges_set(const stinger_vertices_t * vertices, vindex_t v, adjace
   return (VTX(v)->edges = edges);
 }
 
+#if defined(STINGER_USE_REVERSE_EDGES)
+/* IN EDGES */
+
+inline adjacency_t
+stinger_vertex_in_edges_get(const stinger_vertices_t * vertices, vindex_t v)
+{
+  return readff(&(VTX(v)->inEdges));
+}
+
+inline adjacency_t *
+stinger_vertex_in_edges_pointer_get(const stinger_vertices_t * vertices, vindex_t v)
+{
+  return &(VTX(v)->inEdges);
+}
+
+inline adjacency_t
+stinger_vertex_in_edges_set(const stinger_vertices_t * vertices, vindex_t v, adjacency_t edges)
+{
+  return (VTX(v)->inEdges = edges);
+}
+#endif
+
 physID_t *
 stinger_vertex_physmap_pointer_get(const stinger_vertices_t * vertices, vindex_t v) {
   return &(VTX(v)->physID);
@@ -7,7 +7,9 @@
 
 #include "stinger.h"
 #include "stinger-atomics.h"
+#include "stinger-edge-index.h"
 #include "stinger-physmap.h"
+#include "stinger-stats.h"
 #include "stinger-utils.h"
 #include "xmalloc.h"
 #include "x86-full-empty.h"
@@ -37,18 +39,39 @@ stinger_indegree_get(const stinger_t * S, vindex_t v) {
   return stinger_vertex_indegree_get(stinger_vertices_get(S), v);
 }
 
+#if defined(STINGER_USE_STATS)
+/* Every in- or out-degree change also moves the vertex's total degree, which
+   is what decides whether it is active. */
+static inline void
+stats_degree_changed(const stinger_t * S, vindex_t v, vdegree_t d) {
+  if (d) {
+    vdegree_t old = stinger_vertex_totaldegree_increment_atomic(stinger_vertices_get(S), v, d);
+    stinger_stats_activity_update(S->stats, v, old, old + d);
+  }
+}
+#endif
+
 inline vdegree_t
 stinger_indegree_set(const stinger_t * S, vindex_t v, vdegree_t d) {
+#if defined(STINGER_USE_STATS)
+  stats_degree_changed(S, v, d - stinger_indegree_get(S, v));
+#endif
   return stinger_vertex_indegree_set(stinger_vertices_get(S), v, d);
 }
 
 inline vdegree_t
 stinger_indegree_increment(const stinger_t * S, vindex_t v, vdegree_t d) {
+#if defined(STINGER_USE_STATS)
+  stats_degree_changed(S, v, d);
+#endif
   return stinger_vertex_indegree_increment(stinger_vertices_get(S), v, d);
 }
 
 inline vdegree_t
 stinger_indegree_increment_atomic(const stinger_t * S, vindex_t v, vdegree_t d) {
+#if defined(STINGER_USE_STATS)
+  stats_degree_changed(S, v, d);
+#endif
   return stinger_vertex_indegree_increment_atomic(stinger_vertices_get(S), v, d);
 }
 
@@ -61,17 +84,36 @@ stinger_outdegree_get(const stinger_t * S, vindex_t v) {
 
 inline vdegree_t
 stinger_outdegree_set(const stinger_t * S, vindex_t v, vdegree_t d) {
+#if defined(STINGER_USE_STATS)
+  vdegree_t old = stinger_outdegree_get(S, v);
+  stats_degree_changed(S, v, d - old);
+  stinger_stats_outdegree_update(S->stats, v, old, d);
+#endif
   return stinger_vertex_outdegree_set(stinger_vertices_get(S), v, d);
 }
 
 inline vdegree_t
 stinger_outdegree_increment(const stinger_t * S, vindex_t v, vdegree_t d) {
+#if defined(STINGER_USE_STATS)
+  stats_degree_changed(S, v, d);
+  vdegree_t rtn = stinger_vertex_outdegree_increment(stinger_vertices_get(S), v, d);
+  stinger_stats_outdegree_update(S->stats, v, rtn - d, rtn);
+  return rtn;
+#else
   return stinger_vertex_outdegree_increment(stinger_vertices_get(S), v, d);
+#endif
 }
 
 inline vdegree_t
 stinger_outdegree_increment_atomic(const stinger_t * S, vindex_t v, vdegree_t d) {
+#if defined(STINGER_USE_STATS)
+  stats_degree_changed(S, v, d);
+  vdegree_t rtn = stinger_vertex_outdegree_increment_atomic(stinger_vertices_get(S), v, d);
+  stinger_stats_outdegree_update(S->stats, v, rtn, rtn + d);
+  return rtn;
+#else
   return stinger_vertex_outdegree_increment_atomic(stinger_vertices_get(S), v, d);
+#endif
 }
 
 /* TYPE */
@@ -147,6 +189,21 @@ static void
 get_from_ebpool (const struct stinger * S, eb_index_t *out, size_t k)
 {
   eb_index_t ebt0;
+  size_t nreuse = 0;
+
+  /* hand out blocks returned by put_to_ebpool() first */
+  if (S->ebpool->nfree > 0) {
+    int64_t nfree = readfe ((uint64_t *)&S->ebpool->nfree);
+    nreuse = (nfree < k ? nfree : k);
+    for (size_t ki = 0; ki < nreuse; ++ki)
+      out[ki] = S->ebpool->free_blocks[nfree - 1 - ki];
+    writeef ((uint64_t *)&S->ebpool->nfree, (uint64_t)(nfree - nreuse));
+    if (nreuse == k)
+      return;
+    out += nreuse;
+    k -= nreuse;
+  }
+
   {
     ebt0 = stinger_int64_fetch_add (&S->ebpool->ebpool_tail, k);
     if (ebt0 + k >= EBPOOL_SIZE) {
@@ -161,6 +218,17 @@ get_from_ebpool (const struct stinger * S, eb_index_t *out, size_t k)
   }
 }
 
+/* Return unlinked blocks to the pool.  Only called from bulk operations
+   that exclude concurrent updates. */
+MTA ("mta inline")
+static void
+put_to_ebpool (const struct stinger * S, const eb_index_t *in, size_t k)
+{
+  int64_t place = stinger_int64_fetch_add (&S->ebpool->nfree, k);
+  for (size_t ki = 0; ki < k; ++ki)
+    S->ebpool->free_blocks[place + ki] = in[ki];
+}
+
 /* }}} */
 
 /* {{{ Internal utilities */
@@ -180,6 +248,9 @@ get_from_ebpool (const struct stinger * S, eb_index_t *out, size_t k)
  */
 uint64_t
 stinger_max_active_vertex(const struct stinger * S) {
+#if defined(STINGER_USE_STATS)
+  return stinger_stats_max_active_vertex(S);
+#endif
   uint64_t out = 0;
   OMP("omp parallel") {
     uint64_t local_max = 0;
@@ -208,6 +279,9 @@ stinger_max_active_vertex(const struct stinger * S) {
  */
 uint64_t
 stinger_num_active_vertices(const struct stinger * S) {
+#if defined(STINGER_USE_STATS)
+  return stinger_stats_active_vertices(S);
+#endif
   uint64_t out = 0;
   OMP("omp parallel for reduction(+:out)")
   for(uint64_t i = 0; i < STINGER_MAX_LVERTICES; i++) {
@@ -278,6 +352,9 @@ stinger_eb_first_ts (const struct stinger_eb * eb_, int k_)
 int64_t
 stinger_total_edges (const struct stinger * S)
 {
+#if defined(STINGER_USE_STATS)
+  return stinger_stats_total_edges(S);
+#endif
   uint64_t rtn = 0;
   for (uint64_t i = 0; i < STINGER_MAX_LVERTICES; i++) {
     rtn += stinger_outdegree_get(S, i);
@@ -411,6 +488,27 @@ stinger_consistency_check (struct stinger *S, uint64_t NV)
       returnCode |= 0x00000100;
   }
 
+#if defined(STINGER_USE_REVERSE_EDGES)
+  /* the reverse adjacency must hold exactly one entry per in-edge */
+  OMP("omp parallel for reduction(|:returnCode)")
+  MTA("mta assert nodep")
+  for (uint64_t i = 0; i < NV; i++) {
+    uint64_t curInDegree = 0;
+    const struct stinger_eb *curBlock = ebpool_priv + stinger_vertex_in_edges_get(S->vertices, i);
+    while (curBlock != ebpool_priv) {
+      if (curBlock->vertexID != i)
+        returnCode |= 0x00000800;
+      for (uint64_t j = 0; j < curBlock->high && j < STINGER_EDGEBLOCKSIZE; j++) {
+        if (!stinger_eb_is_blank (curBlock, j))
+          curInDegree++;
+      }
+      curBlock = ebpool_priv + curBlock->next;
+    }
+    if (curInDegree != stinger_indegree_get(S, i))
+      returnCode |= 0x00000800;
+  }
+#endif
+
   free (inDegree);
 
 #if STINGER_NUMETYPES == 1
@@ -534,6 +632,13 @@ struct stinger *stinger_new (void)
   G->ebpool = xmalloc(sizeof(struct stinger_ebpool));
   G->ebpool->ebpool_tail = 1;
   G->ebpool->is_shared = 0;
+  G->ebpool->nfree = 0;
+#if defined(STINGER_USE_EDGE_INDEX)
+  G->eindex = xcalloc (STINGER_MAX_LVERTICES, sizeof (*G->eindex));
+#endif
+#if defined(STINGER_USE_STATS)
+  G->stats = xcalloc (1, sizeof (struct stinger_stats));
+#endif
 
 #if STINGER_NUMETYPES == 1
   G->ETA[0].length = EBPOOL_SIZE;
@@ -568,6 +673,15 @@ stinger_free (struct stinger *S)
     return S;
 
   free (S->ETA);
+#if defined(STINGER_USE_EDGE_INDEX)
+  OMP ("omp parallel for")
+  for (int64_t v = 0; v < STINGER_MAX_LVERTICES; v++)
+    stinger_edge_index_free (S->eindex[v]);
+  free (S->eindex);
+#endif
+#if defined(STINGER_USE_STATS)
+  free (S->stats);
+#endif
   stinger_vertices_free	(&(S->vertices));
   free (S->ebpool);
 #if !defined(STINGER_FORCE_OLD_MAP)
@@ -716,6 +830,335 @@ etype_begin (stinger_t * S, stinger_vertices_t *vertices, int64_t v, int etype)
   return out;
 }
 
+#if defined(STINGER_USE_REVERSE_EDGES)
+/* {{{ Reverse (in-edge) adjacency */
+
+/* Reverse edge blocks live in the same pool as forward blocks, but they hang
+ * off of stinger_vertex.inEdges rather than stinger_vertex.edges and are never
+ * pushed onto the edge type arrays, so edge-parallel traversals do not see
+ * them.  In a reverse block, vertexID is the destination vertex and each
+ * neighbor is a source vertex.  Degrees are owned by the forward copy.
+ */
+
+MTA ("mta inline")
+static struct curs
+in_etype_begin (stinger_t * S, stinger_vertices_t *vertices, int64_t v, int etype)
+{
+  struct curs out;
+  assert (vertices);
+  out.eb = stinger_vertex_in_edges_get(vertices,v);
+  out.loc = stinger_vertex_in_edges_pointer_get(vertices,v);
+  while (out.eb && S->ebpool->ebpool[out.eb].etype != etype) {
+    out.loc = &(S->ebpool->ebpool[out.eb].next);
+    out.eb = readff((uint64_t *)&(S->ebpool->ebpool[out.eb].next));
+  }
+  return out;
+}
+
+/* Same as update_edge_data(), but for a reverse edge block.  Vertex degrees
+ * are left alone. */
+MTA ("mta inline")
+static void
+update_in_edge_data (struct stinger_eb *eb, uint64_t index,
+                     int64_t neighbor, int64_t weight, int64_t ts)
+{
+  struct stinger_edge * e = eb->edges + index;
+
+  if(neighbor >= 0) {
+    e->weight = weight;
+    if(e->neighbor < 0 || index >= eb->high) {
+      e->neighbor = neighbor;
+
+      if(stinger_int64_fetch_add(&eb->numEdges, 1) == 0) {
+	eb->smallStamp = ts;
+	eb->largeStamp = ts;
+      }
+
+      if (index >= eb->high)
+	eb->high = index + 1;
+
+      writexf(&e->timeFirst, ts);
+    }
+
+    if (ts < readff(&eb->smallStamp) || ts > eb->largeStamp) {
+      int64_t smallStamp = readfe(&eb->smallStamp);
+      if (ts < smallStamp)
+	smallStamp = ts;
+      if (ts > eb->largeStamp)
+	eb->largeStamp = ts;
+      writeef(&eb->smallStamp, smallStamp);
+    }
+
+    e->timeRecent = ts;
+
+  } else if(e->neighbor >= 0) {
+    stinger_int64_fetch_add (&(eb->numEdges), -1);
+    e->neighbor = neighbor;
+  }
+}
+
+/** @brief Insert or update the reverse copy of the edge from -> to.
+ *
+ *  Mirrors the weight and timestamp of the forward edge into the in-edge
+ *  blocks of the destination.  Follows the same locking protocol as
+ *  stinger_insert_edge().
+ *
+ *  @param G The STINGER data structure
+ *  @param type Edge type
+ *  @param from Source vertex ID
+ *  @param to Destination vertex ID (owner of the reverse blocks)
+ *  @param weight Edge weight
+ *  @param timestamp Edge timestamp
+ *  @return Void
+ */
+MTA ("mta inline")
+static void
+stinger_in_edge_upsert (struct stinger *G, int64_t type, int64_t from,
+                        int64_t to, int64_t weight, int64_t timestamp)
+{
+  struct curs curs;
+  struct stinger_eb *tmp;
+  struct stinger_eb *ebpool_priv = G->ebpool->ebpool;
+
+  curs = in_etype_begin (G, G->vertices, to, type);
+
+  /* 1: Check if the reverse edge already exists. */
+  for (tmp = ebpool_priv + curs.eb; tmp != ebpool_priv; tmp = ebpool_priv + readff((uint64_t *)&tmp->next)) {
+    if(type == tmp->etype) {
+      size_t k, endk;
+      endk = tmp->high;
+
+      for (k = 0; k < endk; ++k) {
+	if (from == tmp->edges[k].neighbor) {
+	  update_in_edge_data (tmp, k, from, weight, timestamp);
+	  return;
+	}
+      }
+    }
+  }
+
+  while (1) {
+    eb_index_t * block_ptr = curs.loc;
+    curs.eb = readff((uint64_t *)curs.loc);
+    /* 2: Check for an empty slot. */
+    for (tmp = ebpool_priv + curs.eb; tmp != ebpool_priv; tmp = ebpool_priv + readff((uint64_t *)&tmp->next)) {
+      if(type == tmp->etype) {
+	size_t k, endk;
+	endk = tmp->high;
+
+	for (k = 0; k < STINGER_EDGEBLOCKSIZE; ++k) {
+	  int64_t myNeighbor = tmp->edges[k].neighbor;
+	  if (from == myNeighbor && k < endk) {
+	    update_in_edge_data (tmp, k, from, weight, timestamp);
+	    return;
+	  }
+
+	  if (myNeighbor < 0 || k >= endk) {
+	    int64_t timefirst = readfe ( &(tmp->edges[k].timeFirst) );
+	    int64_t thisEdge = tmp->edges[k].neighbor;
+	    endk = tmp->high;
+
+	    if (thisEdge < 0 || k >= endk) {
+	      update_in_edge_data (tmp, k, from, weight, timestamp);
+	      return;
+	    } else if (from == thisEdge) {
+	      update_in_edge_data (tmp, k, from, weight, timestamp);
+	      writexf ( &(tmp->edges[k].timeFirst), timefirst);
+	      return;
+	    } else {
+	      writexf ( &(tmp->edges[k].timeFirst), timefirst);
+	    }
+	  }
+	}
+      }
+      block_ptr = &(tmp->next);
+    }
+
+    /* 3: Needs a new block at the end of the list.  Not pushed onto the ETA. */
+    eb_index_t old_eb = readfe ((uint64_t *)block_ptr );
+    if (!old_eb) {
+      eb_index_t newBlock = new_eb (G, type, to);
+      update_in_edge_data (ebpool_priv + newBlock, 0, from, weight, timestamp);
+      ebpool_priv[newBlock].next = 0;
+      writeef ((uint64_t *)block_ptr, (uint64_t)newBlock);
+      return;
+    }
+    writeef ((uint64_t *)block_ptr, (uint64_t)old_eb);
+  }
+}
+
+/** @brief Remove the reverse copy of the edge from -> to.
+ *
+ *  @param G The STINGER data structure
+ *  @param type Edge type
+ *  @param from Source vertex ID
+ *  @param to Destination vertex ID (owner of the reverse blocks)
+ *  @return 1 on success, 0 if the reverse edge is not found.
+ */
+MTA ("mta inline")
+static int
+stinger_in_edge_remove (struct stinger *G, int64_t type, int64_t from, int64_t to)
+{
+  struct curs curs;
+  struct stinger_eb *tmp;
+  struct stinger_eb *ebpool_priv = G->ebpool->ebpool;
+
+  curs = in_etype_begin (G, G->vertices, to, type);
+
+  for (tmp = ebpool_priv + curs.eb; tmp != ebpool_priv; tmp = ebpool_priv + readff((uint64_t *)&tmp->next)) {
+    if(type == tmp->etype) {
+      size_t k, endk;
+      endk = tmp->high;
+
+      for (k = 0; k < endk; ++k) {
+	if (from == tmp->edges[k].neighbor) {
+	  int64_t weight = readfe (&(tmp->edges[k].weight));
+	  int rtn = 0;
+	  if(from == tmp->edges[k].neighbor) {
+	    update_in_edge_data (tmp, k, ~from, weight, 0);
+	    rtn = 1;
+	  }
+	  writeef((uint64_t *)&(tmp->edges[k].weight), (uint64_t)weight);
+	  return rtn;
+	}
+      }
+    }
+  }
+  return 0;
+}
+
+/* Locate the reverse copy of from -> to, or NULL if there is none.  The
+   block holding it is stored in *eb_out. */
+static struct stinger_edge *
+stinger_in_edge_find (const struct stinger *G, int64_t type, int64_t from, int64_t to,
+                      struct stinger_eb ** eb_out)
+{
+  struct stinger_eb *ebpool_priv = G->ebpool->ebpool;
+  struct stinger_eb *tmp = ebpool_priv + stinger_vertex_in_edges_get(G->vertices, to);
+
+  for (; tmp != ebpool_priv; tmp = ebpool_priv + readff((uint64_t *)&tmp->next)) {
+    if(type == tmp->etype) {
+      for (size_t k = 0; k < tmp->high; ++k) {
+	if (from == tmp->edges[k].neighbor) {
+	  *eb_out = tmp;
+	  return tmp->edges + k;
+	}
+      }
+    }
+  }
+  return NULL;
+}
+
+/** @brief Build the reverse adjacency for a graph given in CSR format.
+ *
+ *  Companion to stinger_set_initial_edges().  Transposes the CSR with a
+ *  counting pass and lays the result out in reverse edge blocks that are
+ *  prepended to each destination's in-edge list.
+ *
+ *  @return Void
+ */
+static void
+stinger_set_initial_in_edges (struct stinger *G,
+                              const size_t nv,
+                              const int64_t etype,
+                              const int64_t * off,
+                              const int64_t * phys_adj,
+                              const int64_t * weight,
+                              const int64_t * ts,
+                              const int64_t * first_ts,
+                              const int64_t single_ts)
+{
+  stinger_vertices_t * restrict vertices = G->vertices;
+  const int64_t ne = off[nv];
+
+  int64_t * restrict roff = xcalloc (nv + 2, sizeof (*roff));
+  int64_t * restrict rsrc = xmalloc ((ne + 1) * 4 * sizeof (*rsrc));
+  int64_t * restrict rwgt = rsrc + ne + 1;
+  int64_t * restrict rtf = rwgt + ne + 1;
+  int64_t * restrict rtr = rtf + ne + 1;
+
+  /* count in-degrees, shifted by two so that the fill pass below leaves
+     roff[v] at the start of v */
+  OMP ("omp parallel for")
+  for (int64_t v = 0; v < nv; ++v)
+    for (int64_t k = off[v]; k < off[v + 1]; ++k) {
+      assert (phys_adj[k] < nv);
+      stinger_int64_fetch_add (&roff[phys_adj[k] + 2], 1);
+    }
+
+  for (int64_t v = 3; v <= nv + 1; ++v)
+    roff[v] += roff[v - 1];
+
+  OMP ("omp parallel for")
+  for (int64_t v = 0; v < nv; ++v)
+    for (int64_t k = off[v]; k < off[v + 1]; ++k) {
+      const int64_t place = stinger_int64_fetch_add (&roff[phys_adj[k] + 1], 1);
+      rsrc[place] = v;
+      rwgt[place] = weight[k];
+      rtf[place] = first_ts ? first_ts[k] : single_ts;
+      rtr[place] = ts ? ts[k] : single_ts;
+    }
+
+  size_t * restrict blkoff = xcalloc (nv + 1, sizeof (*blkoff));
+  OMP ("omp parallel for")
+  for (int64_t v = 0; v < nv; ++v) {
+    const int64_t deg = roff[v + 1] - roff[v];
+    blkoff[v + 1] = (deg + STINGER_EDGEBLOCKSIZE - 1) / STINGER_EDGEBLOCKSIZE;
+  }
+
+  for (int64_t v = 2; v <= nv; ++v)
+    blkoff[v] += blkoff[v - 1];
+
+  eb_index_t * restrict block = xcalloc (blkoff[nv] + 1, sizeof (*block));
+  new_blk_ebs (&block[0], G, nv, blkoff, etype);
+
+  OMP ("omp parallel for")
+  for (int64_t v = 0; v < nv; ++v) {
+    int64_t kgraph = roff[v];
+    const int64_t nextoff = roff[v + 1];
+
+    for (size_t kblk = blkoff[v]; kblk < blkoff[v + 1]; ++kblk) {
+      struct stinger_eb * eb = G->ebpool->ebpool + block[kblk];
+      int64_t n_to_copy = STINGER_EDGEBLOCKSIZE;
+      int64_t tslb = INT64_MAX, tsub = INT64_MIN;
+
+      if (kgraph + n_to_copy >= nextoff)
+	n_to_copy = nextoff - kgraph;
+
+      for (int64_t i = 0; i < n_to_copy; ++i) {
+	struct stinger_edge * edge = eb->edges + i;
+	edge->neighbor = rsrc[kgraph + i];
+	edge->weight = rwgt[kgraph + i];
+	edge->timeFirst = rtf[kgraph + i];
+	edge->timeRecent = rtr[kgraph + i];
+	if (edge->timeFirst < tslb)
+	  tslb = edge->timeFirst;
+	if (edge->timeRecent > tsub)
+	  tsub = edge->timeRecent;
+      }
+      kgraph += n_to_copy;
+
+      eb->smallStamp = tslb;
+      eb->largeStamp = tsub;
+      eb->numEdges = n_to_copy;
+      eb->high = n_to_copy;
+    }
+
+    if (blkoff[v] != blkoff[v + 1]) {
+      G->ebpool->ebpool[block[blkoff[v+1]-1]].next = stinger_vertex_in_edges_get(vertices, v);
+      stinger_vertex_in_edges_set(vertices, v, block[blkoff[v]]);
+    }
+  }
+
+  free (block);
+  free (blkoff);
+  free (rsrc);
+  free (roff);
+}
+
+/* }}} */
+#endif /* STINGER_USE_REVERSE_EDGES */
+
 MTA ("mta inline")
 void
 update_edge_data (struct stinger * S, struct stinger_eb *eb,
@@ -739,6 +1182,7 @@ update_edge_data (struct stinger * S, struct stinger_eb *eb,
       /* register new edge */
       stinger_outdegree_increment_atomic(S, eb->vertexID, 1);
       stinger_indegree_increment_atomic(S, neighbor, 1);
+      STINGER_STATS_EDGES_UPDATE(S, eb->etype, 1);
 
       if (index >= eb->high)
 	eb->high = index + 1;
@@ -758,35 +1202,251 @@ update_edge_data (struct stinger * S, struct stinger_eb *eb,
 
     e->timeRecent = ts;
 
+#if defined(STINGER_USE_REVERSE_EDGES)
+    stinger_in_edge_upsert (S, eb->etype, eb->vertexID, neighbor, weight, ts);
+#endif
+
   } else if(e->neighbor >= 0) {
     /* are we deleting an edge */
     stinger_outdegree_increment_atomic(S, eb->vertexID, -1);
     stinger_indegree_increment_atomic(S, e->neighbor, -1);
+    STINGER_STATS_EDGES_UPDATE(S, eb->etype, -1);
     stinger_int64_fetch_add (&(eb->numEdges), -1);
+#if defined(STINGER_USE_REVERSE_EDGES)
+    stinger_in_edge_remove (S, eb->etype, eb->vertexID, e->neighbor);
+#endif
     e->neighbor = neighbor;
   } 
 
   /* we always do this to update weight and  unlock the edge if needed */
 }
 
-/** @brief Insert a directed edge.
+#if defined(STINGER_USE_EDGE_INDEX)
+/* {{{ Per-vertex edge index */
+
+/* Vertices whose out-degree reaches STINGER_EDGE_INDEX_THRESHOLD get a hash
+ * index from (neighbor, type) to edge slot in G->eindex.  The eindex word of
+ * each vertex doubles as a full-empty lock that every writer to that
+ * vertex's blocks holds, so the index cannot go stale, and it is where the
+ * index is created.  Holding the lock keeps the index's sequence number odd.
  *
- *  Inserts a typed, directed edge.  First timestamp is set, if the edge is
- *  new.  Recent timestamp is updated.  Weight is set to specified value regardless.
+ * Readers never take the lock.  They load the word as it is, look the edge
+ * up between two reads of the sequence number, and walk the chain lock-free,
+ * as they do for a vertex with no index, if a writer holds the lock or got
+ * in between.  While updates may run, an index is only ever emptied in
+ * place, never freed, so the pointer a reader loaded stays valid.
+ */
+
+static int stinger_insert_edge_chain (struct stinger *G, int64_t type, int64_t from,
+                                      int64_t to, int64_t weight, int64_t timestamp);
+static int stinger_incr_edge_chain (struct stinger *G, int64_t type, int64_t from,
+                                    int64_t to, int64_t weight, int64_t timestamp);
+static int stinger_remove_edge_chain (struct stinger *G, int64_t type, int64_t from,
+                                      int64_t to);
+
+#define EINDEX_SLOT(EB_,K_) ((int64_t)(EB_) * STINGER_EDGEBLOCKSIZE + (K_))
+#define EINDEX_EB(SLOT_) ((SLOT_) / STINGER_EDGEBLOCKSIZE)
+#define EINDEX_K(SLOT_) ((SLOT_) % STINGER_EDGEBLOCKSIZE)
+
+/** @brief Lock the edge index word of a vertex for writing.
  *
- *  @param G The STINGER data structure
- *  @param type Edge type
- *  @param from Source vertex ID
- *  @param to Destination vertex ID
- *  @param weight Edge weight
- *  @param timestamp Edge timestamp
- *  @return 1 if edge is inserted successfully for the first time, 0 if edge is already found and updated, -1 if error.
+ *  @return The index of v, or NULL if v is below the degree threshold.
+ */
+struct stinger_edge_index *
+stinger_edge_index_lock (const struct stinger * G, int64_t v)
+{
+  struct stinger_edge_index * idx =
+    (struct stinger_edge_index *) readfe ((uint64_t *)&G->eindex[v]);
+  if (idx)
+    stinger_int64_fetch_add (&idx->seq, 1);
+  return idx;
+}
+
+/** @brief Release the edge index word of a vertex, publishing idx. */
+void
+stinger_edge_index_unlock (const struct stinger * G, int64_t v,
+                           struct stinger_edge_index * idx)
+{
+  /* a freshly built index was never locked and is already even */
+  if (idx && (idx->seq & 1))
+    stinger_int64_fetch_add (&idx->seq, 1);
+  writeef ((uint64_t *)&G->eindex[v], (uint64_t)idx);
+}
+
+/** @brief Rebuild the edge index of a vertex from its block chain.
+ *
+ *  The caller must hold the vertex's index lock or otherwise exclude
+ *  writers.  old is emptied and refilled in place, whatever the degree, so
+ *  lookups running in it stay safe.
+ *
+ *  @return The index, or NULL if v has none and is below the degree
+ *  threshold.
  */
+struct stinger_edge_index *
+stinger_edge_index_rebuild (const struct stinger * G, int64_t v,
+                            struct stinger_edge_index * old)
+{
+  const int64_t deg = stinger_outdegree_get (G, v);
+  if (!old && deg < STINGER_EDGE_INDEX_THRESHOLD)
+    return NULL;
+
+  struct stinger_eb * ebpool_priv = G->ebpool->ebpool;
+  struct stinger_edge_index * idx =
+    old ? stinger_edge_index_clear (old, deg) : stinger_edge_index_new (deg);
+
+  for (eb_index_t cur = stinger_vertex_edges_get (G->vertices, v); cur;
+       cur = ebpool_priv[cur].next) {
+    struct stinger_eb * eb = ebpool_priv + cur;
+    /* push in reverse so that holes are refilled front to back */
+    for (int64_t k = STINGER_EDGEBLOCKSIZE - 1; k >= 0; --k) {
+      if (k < eb->high && eb->edges[k].neighbor >= 0)
+	stinger_edge_index_insert (idx, eb->edges[k].neighbor, eb->etype,
+				   EINDEX_SLOT (cur, k));
+      else
+	stinger_edge_index_push_free (idx, eb->etype, EINDEX_SLOT (cur, k));
+    }
+  }
+  return idx;
+}
+
+/* Rebuild the index of every vertex below nv, dropping those below the
+   threshold.  Not safe to call concurrently with updates or lookups. */
+static void
+edge_index_rebuild_all (struct stinger * G, int64_t nv)
+{
+  OMP ("omp parallel for")
+  for (int64_t v = 0; v < nv; ++v) {
+    if (stinger_outdegree_get (G, v) < STINGER_EDGE_INDEX_THRESHOLD)
+      G->eindex[v] = stinger_edge_index_free (G->eindex[v]);
+    else
+      G->eindex[v] = stinger_edge_index_rebuild (G, v, G->eindex[v]);
+  }
+}
+
+/* Insert or increment from -> to.  Indexed vertices find the edge or a free
+   slot in the index; other vertices walk the chain and get an index once they
+   cross the threshold. */
+static int
+edge_index_upsert (struct stinger * G, int64_t type, int64_t from, int64_t to,
+                   int64_t weight, int64_t timestamp, int incr)
+{
+  struct stinger_eb * ebpool_priv = G->ebpool->ebpool;
+  struct stinger_edge_index * idx = stinger_edge_index_lock (G, from);
+  int rtn;
+
+  if (!idx) {
+    if (incr)
+      rtn = stinger_incr_edge_chain (G, type, from, to, weight, timestamp);
+    else
+      rtn = stinger_insert_edge_chain (G, type, from, to, weight, timestamp);
+    if (rtn == 1)
+      idx = stinger_edge_index_rebuild (G, from, NULL);
+    stinger_edge_index_unlock (G, from, idx);
+    return rtn;
+  }
+
+  int64_t slot = stinger_edge_index_lookup (idx, to, type);
+  if (slot >= 0) {
+    struct stinger_eb * eb = ebpool_priv + EINDEX_EB (slot);
+    const int64_t k = EINDEX_K (slot);
+    update_edge_data (G, eb, k, to, (incr ? eb->edges[k].weight + weight : weight), timestamp);
+    rtn = 0;
+  } else {
+    slot = stinger_edge_index_pop_free (idx, type);
+    if (slot >= 0) {
+      update_edge_data (G, ebpool_priv + EINDEX_EB (slot), EINDEX_K (slot), to, weight, timestamp);
+      rtn = 1;
+    } else {
+      /* No holes left: new block at the head of the chain.  Readers walking
+	 the chain see either the old head or the fully linked new one. */
+      eb_index_t newBlock = new_eb (G, type, from);
+      if (newBlock == 0) {
+	rtn = -1;
+      } else {
+	slot = EINDEX_SLOT (newBlock, 0);
+	for (int64_t k = STINGER_EDGEBLOCKSIZE - 1; k > 0; --k)
+	  stinger_edge_index_push_free (idx, type, EINDEX_SLOT (newBlock, k));
+	update_edge_data (G, ebpool_priv + newBlock, 0, to, weight, timestamp);
+	ebpool_priv[newBlock].next = stinger_vertex_edges_get (G->vertices, from);
+	push_ebs (G, 1, &newBlock);
+	stinger_vertex_edges_set (G->vertices, from, newBlock);
+	rtn = 1;
+      }
+    }
+    if (rtn == 1)
+      stinger_edge_index_insert (idx, to, type, slot);
+  }
+
+  stinger_edge_index_unlock (G, from, idx);
+  return rtn;
+}
+
+static int
+edge_index_remove (struct stinger * G, int64_t type, int64_t from, int64_t to)
+{
+  struct stinger_edge_index * idx = stinger_edge_index_lock (G, from);
+  int rtn;
+
+  if (!idx) {
+    rtn = stinger_remove_edge_chain (G, type, from, to);
+  } else {
+    const int64_t slot = stinger_edge_index_remove (idx, to, type);
+    if (slot < 0) {
+      rtn = -1;
+    } else {
+      struct stinger_eb * eb = G->ebpool->ebpool + EINDEX_EB (slot);
+      const int64_t k = EINDEX_K (slot);
+      int64_t weight = readfe (&(eb->edges[k].weight));
+      update_edge_data (G, eb, k, ~to, weight, 0);
+      stinger_edge_index_push_free (idx, type, slot);
+      rtn = 1;
+    }
+  }
+
+  stinger_edge_index_unlock (G, from, idx);
+  return rtn;
+}
+
+/* Copy out the edge from -> to through the index of from.  Returns 1 if
+   found, 0 if from is indexed and the edge does not exist, and -1 if from has
+   no index and the caller must walk the chain. */
+static int
+edge_index_find (const struct stinger * G, int64_t type, int64_t from, int64_t to,
+                 struct stinger_edge * out)
+{
+  /* the word holds MARKER while a writer has it locked */
+  const uint64_t word = ((volatile uint64_t *)G->eindex)[from];
+  if (!word || word == MARKER)
+    return -1;
+
+  const struct stinger_edge_index * idx = (const struct stinger_edge_index *) word;
+  const int64_t seq = stinger_edge_index_read_begin (idx);
+  if (seq < 0)
+    return -1;
+
+  const int64_t slot = stinger_edge_index_lookup (idx, to, type);
+  struct stinger_edge edge;
+  if (slot >= 0)
+    edge = G->ebpool->ebpool[EINDEX_EB (slot)].edges[EINDEX_K (slot)];
+
+  if (!stinger_edge_index_read_valid (idx, seq))
+    return -1;
+  if (slot < 0)
+    return 0;
+  *out = edge;
+  return 1;
+}
+
+/* }}} */
+#endif /* STINGER_USE_EDGE_INDEX */
+
+/* Insert by walking the block chain of the source vertex.  See
+   stinger_insert_edge(). */
 MTA ("mta inline") MTA("mta serial")
-int
-stinger_insert_edge (struct stinger *G,
-                     int64_t type, int64_t from, int64_t to,
-                     int64_t weight, int64_t timestamp)
+static int
+stinger_insert_edge_chain (struct stinger *G,
+                           int64_t type, int64_t from, int64_t to,
+                           int64_t weight, int64_t timestamp)
 {
   if(from == to)
     return -1;
@@ -877,10 +1537,10 @@ stinger_insert_edge (struct stinger *G,
   }
 }
 
-/** @brief Increments a directed edge.
+/** @brief Insert a directed edge.
  *
- *  Increments the weight of a typed, directed edge.
- *  Recent timestamp is updated.
+ *  Inserts a typed, directed edge.  First timestamp is set, if the edge is
+ *  new.  Recent timestamp is updated.  Weight is set to specified value regardless.
  *
  *  @param G The STINGER data structure
  *  @param type Edge type
@@ -888,13 +1548,33 @@ stinger_insert_edge (struct stinger *G,
  *  @param to Destination vertex ID
  *  @param weight Edge weight
  *  @param timestamp Edge timestamp
- *  @return 1
+ *  @return 1 if edge is inserted successfully for the first time, 0 if edge is already found and updated, -1 if error.
  */
-MTA ("mta inline")
+MTA ("mta inline") MTA("mta serial")
 int
-stinger_incr_edge (struct stinger *G,
-                   int64_t type, int64_t from, int64_t to,
-                   int64_t weight, int64_t timestamp)
+stinger_insert_edge (struct stinger *G,
+                     int64_t type, int64_t from, int64_t to,
+                     int64_t weight, int64_t timestamp)
+{
+#if defined(STINGER_USE_EDGE_INDEX)
+  if(from == to)
+    return -1;
+
+  STINGERASSERTS ();
+
+  return edge_index_upsert (G, type, from, to, weight, timestamp, 0);
+#else
+  return stinger_insert_edge_chain (G, type, from, to, weight, timestamp);
+#endif
+}
+
+/* Increment by walking the block chain of the source vertex.  See
+   stinger_incr_edge(). */
+MTA ("mta inline")
+static int
+stinger_incr_edge_chain (struct stinger *G,
+                         int64_t type, int64_t from, int64_t to,
+                         int64_t weight, int64_t timestamp)
 {
   if(from == to)
     return -1;
@@ -985,6 +1665,37 @@ stinger_incr_edge (struct stinger *G,
   }
 }
 
+/** @brief Increments a directed edge.
+ *
+ *  Increments the weight of a typed, directed edge.
+ *  Recent timestamp is updated.
+ *
+ *  @param G The STINGER data structure
+ *  @param type Edge type
+ *  @param from Source vertex ID
+ *  @param to Destination vertex ID
+ *  @param weight Edge weight
+ *  @param timestamp Edge timestamp
+ *  @return 1
+ */
+MTA ("mta inline")
+int
+stinger_incr_edge (struct stinger *G,
+                   int64_t type, int64_t from, int64_t to,
+                   int64_t weight, int64_t timestamp)
+{
+#if defined(STINGER_USE_EDGE_INDEX)
+  if(from == to)
+    return -1;
+
+  STINGERASSERTS ();
+
+  return edge_index_upsert (G, type, from, to, weight, timestamp, 1);
+#else
+  return stinger_incr_edge_chain (G, type, from, to, weight, timestamp);
+#endif
+}
+
 /** @brief Insert an undirected edge.
  *
  *  Inserts a typed, undirected edge.  First timestamp is set, if the edge is
@@ -1047,22 +1758,12 @@ stinger_incr_edge_pair (struct stinger *G,
     return rtn | (rtn2 << 1);
 }
 
-/** @brief Removes a directed edge.
- *
- *  Remove a typed, directed edge.
- *  Note: Do not call this function concurrently with the same source vertex,
- *  even for different edge types.
- *
- *  @param G The STINGER data structure
- *  @param type Edge type
- *  @param from Source vertex ID
- *  @param to Destination vertex ID
- *  @return 1 on success, 0 if the edge is not found.
- */
+/* Remove by walking the block chain of the source vertex.  See
+   stinger_remove_edge(). */
 MTA ("mta inline") MTA ("mta serial")
-int
-stinger_remove_edge (struct stinger *G,
-                     int64_t type, int64_t from, int64_t to)
+static int
+stinger_remove_edge_chain (struct stinger *G,
+                           int64_t type, int64_t from, int64_t to)
 {
   if(from == to)
     return -1;
@@ -1098,6 +1799,35 @@ stinger_remove_edge (struct stinger *G,
   return -1;
 }
 
+/** @brief Removes a directed edge.
+ *
+ *  Remove a typed, directed edge.
+ *  Note: Do not call this function concurrently with the same source vertex,
+ *  even for different edge types.
+ *
+ *  @param G The STINGER data structure
+ *  @param type Edge type
+ *  @param from Source vertex ID
+ *  @param to Destination vertex ID
+ *  @return 1 on success, 0 if the edge is not found.
+ */
+MTA ("mta inline") MTA ("mta serial")
+int
+stinger_remove_edge (struct stinger *G,
+                     int64_t type, int64_t from, int64_t to)
+{
+#if defined(STINGER_USE_EDGE_INDEX)
+  if(from == to)
+    return -1;
+
+  STINGERASSERTS ();
+
+  return edge_index_remove (G, type, from, to);
+#else
+  return stinger_remove_edge_chain (G, type, from, to);
+#endif
+}
+
 /** @brief Removes an undirected edge.
  *
  *  Remove a typed, undirected edge.
@@ -1190,8 +1920,10 @@ stinger_set_initial_edges (struct stinger *G,
     for (int64_t v = 0; v < nv; ++v) {
       const int64_t from = v;
       const int64_t deg = off[v + 1] - off[v];
-      if (deg)
-	stinger_vertex_outdegree_increment_atomic(vertices, from, deg);
+      if (deg) {
+	stinger_outdegree_increment_atomic(G, from, deg);
+	STINGER_STATS_EDGES_UPDATE(G, etype, deg);
+      }
     }
 
   new_blk_ebs (&block[0], G, nv, blkoff, etype);
@@ -1247,7 +1979,7 @@ stinger_set_initial_edges (struct stinger *G,
 	      stinger_vertex_indegree_increment_atomic(vertices, to, 1);
 #else
               // Ugh. The MTA compiler can't cope with the inlining.
-	      stinger_vertex_indegree_increment_atomic(vertices, to, 1);
+	      stinger_indegree_increment_atomic(G, to, 1);
 #endif
               /* XXX: The next statements block parallelization
                  of the outer loop. */
@@ -1293,6 +2025,15 @@ stinger_set_initial_edges (struct stinger *G,
 
   free (block);
   free (blkoff);
+
+#if defined(STINGER_USE_REVERSE_EDGES)
+  stinger_set_initial_in_edges (G, nv, etype, off_in, phys_adj_in, weight_in,
+                                ts_in, first_ts_in, single_ts);
+#endif
+
+#if defined(STINGER_USE_EDGE_INDEX)
+  edge_index_rebuild_all (G, nv);
+#endif
 }
 
 /** @brief Copy typed incoming adjacencies of a vertex into a buffer
@@ -1300,7 +2041,8 @@ stinger_set_initial_edges (struct stinger *G,
  *  For a given edge type, adjacencies of the specified vertex are copied into
  *  the user-provided buffer up to the length of the buffer.  These are the
  *  incoming edges for which a vertex is a destination.  Note that this operation
- *  may be very expensive on most platforms.
+ *  may be very expensive on most platforms unless STINGER_USE_REVERSE_EDGES is
+ *  enabled, in which case it only walks the in-edges of v.
  *
  *  @param G The STINGER data structure
  *  @param type Edge type
@@ -1323,16 +2065,23 @@ stinger_gather_typed_predecessors (const struct stinger *G,
 
   assert (G);
 
+#if defined(STINGER_USE_REVERSE_EDGES)
+  STINGER_PARALLEL_FORALL_IN_EDGES_OF_TYPE_OF_VTX_BEGIN(G, type, v) {
+    size_t where = stinger_size_fetch_add (&kout, 1);
+    if (where < max_outlen)
+      out[where] = STINGER_IN_EDGE_SOURCE;
+  } STINGER_PARALLEL_FORALL_IN_EDGES_OF_TYPE_OF_VTX_END();
+#else
   STINGER_PARALLEL_FORALL_EDGES_BEGIN(G, type) {
     const int64_t u = STINGER_EDGE_SOURCE;
-    const int64_t v = STINGER_EDGE_DEST;
-    if (v >= 0) {
+    if (STINGER_EDGE_DEST == v) {
       size_t where = stinger_size_fetch_add (&kout, 1);
       if (where < max_outlen) {
         out[where] = u;
       }
     }
   } STINGER_PARALLEL_FORALL_EDGES_END();
+#endif
 
   *outlen = kout;               /* May be longer than max_outlen. */
 }
@@ -1447,6 +2196,13 @@ stinger_has_typed_successor (const struct stinger *G,
 
   int rtn = 0;
 
+#if defined(STINGER_USE_EDGE_INDEX)
+  struct stinger_edge edge;
+  const int found = edge_index_find (G, type, from, to, &edge);
+  if (found >= 0)
+    return found;
+#endif
+
   STINGER_PARALLEL_FORALL_EDGES_OF_TYPE_OF_VTX_BEGIN(G,type,from) {
     if (STINGER_EDGE_DEST == to) {
       stinger_int_fetch_add(&rtn, 1);
@@ -1476,6 +2232,15 @@ stinger_edgeweight (const struct stinger * G,
 
   int rtn = 0;
 
+#if defined(STINGER_USE_EDGE_INDEX)
+  struct stinger_edge edge;
+  const int found = edge_index_find (G, type, from, to, &edge);
+  if (found > 0)
+    return edge.weight;
+  else if (found == 0)
+    return rtn;
+#endif
+
   STINGER_PARALLEL_FORALL_EDGES_OF_TYPE_OF_VTX_BEGIN(G,type,from) {
     if (STINGER_EDGE_DEST == to) {
       rtn = STINGER_EDGE_WEIGHT;
@@ -1517,6 +2282,15 @@ stinger_set_edgeweight (struct stinger *G,
       rtn = 1;
     }
   } STINGER_PARALLEL_FORALL_EDGES_OF_TYPE_OF_VTX_END();
+
+#if defined(STINGER_USE_REVERSE_EDGES)
+  if (rtn) {
+    struct stinger_eb * in_eb;
+    struct stinger_edge * in_edge = stinger_in_edge_find (G, type, from, to, &in_eb);
+    if (in_edge)
+      in_edge->weight = weight;
+  }
+#endif
   return rtn;
 }
 
@@ -1541,6 +2315,15 @@ stinger_edge_timestamp_first (const struct stinger * G,
 
   int rtn = -1;
 
+#if defined(STINGER_USE_EDGE_INDEX)
+  struct stinger_edge edge;
+  const int found = edge_index_find (G, type, from, to, &edge);
+  if (found > 0)
+    return edge.timeFirst;
+  else if (found == 0)
+    return rtn;
+#endif
+
   STINGER_PARALLEL_FORALL_EDGES_OF_TYPE_OF_VTX_BEGIN(G,type,from) {
     if (STINGER_EDGE_DEST == to) {
       rtn = STINGER_EDGE_TIME_FIRST;
@@ -1570,6 +2353,15 @@ stinger_edge_timestamp_recent (const struct stinger * G,
 
   int rtn = -1;
 
+#if defined(STINGER_USE_EDGE_INDEX)
+  struct stinger_edge edge;
+  const int found = edge_index_find (G, type, from, to, &edge);
+  if (found > 0)
+    return edge.timeRecent;
+  else if (found == 0)
+    return rtn;
+#endif
+
   STINGER_PARALLEL_FORALL_EDGES_OF_TYPE_OF_VTX_BEGIN(G,type,from) {
     if (STINGER_EDGE_DEST == to) {
       rtn = STINGER_EDGE_TIME_RECENT;
@@ -1580,7 +2372,6 @@ stinger_edge_timestamp_recent (const struct stinger * G,
 
 /* TODO revisit this function
  * XXX how to handle in parallel?
- * BUG block meta not handled
  * */
 /** @brief Update the recent timestamp of an edge
  *
@@ -1607,9 +2398,28 @@ stinger_edge_touch (struct stinger *G,
   STINGER_PARALLEL_FORALL_EDGES_OF_TYPE_OF_VTX_BEGIN(G,type,from) {
     if (STINGER_EDGE_DEST == to) {
       STINGER_EDGE_TIME_RECENT = timestamp;
+      /* keep the block bounds valid for temporal scans and expiry */
+      if (timestamp > current_eb__->largeStamp)
+	current_eb__->largeStamp = timestamp;
+      if (timestamp < current_eb__->smallStamp)
+	current_eb__->smallStamp = timestamp;
       rtn = 1;
     }
   } STINGER_PARALLEL_FORALL_EDGES_OF_TYPE_OF_VTX_END();
+
+#if defined(STINGER_USE_REVERSE_EDGES)
+  if (rtn) {
+    struct stinger_eb * in_eb;
+    struct stinger_edge * in_edge = stinger_in_edge_find (G, type, from, to, &in_eb);
+    if (in_edge) {
+      in_edge->timeRecent = timestamp;
+      if (timestamp > in_eb->largeStamp)
+	in_eb->largeStamp = timestamp;
+      if (timestamp < in_eb->smallStamp)
+	in_eb->smallStamp = timestamp;
+    }
+  }
+#endif
   return rtn;
 }
 
@@ -1785,11 +2595,166 @@ stinger_remove_all_edges_of_type (struct stinger *G, int64_t type)
       }
     }
     stinger_outdegree_increment_atomic(G, thisVertex, -removed);
+    STINGER_STATS_EDGES_UPDATE(G, type, -removed);
     current_eb->high = 0;
     current_eb->numEdges = 0;
     current_eb->smallStamp = INT64_MAX;
     current_eb->largeStamp = INT64_MIN;
   }
+
+#if defined(STINGER_USE_REVERSE_EDGES)
+  /* reverse blocks are not in the ETA, so walk each in-edge list */
+  struct stinger_eb * ebpool_priv = G->ebpool->ebpool;
+  OMP("omp parallel for")
+  for (uint64_t v = 0; v < STINGER_MAX_LVERTICES; v++) {
+    struct stinger_eb * current_eb = ebpool_priv + stinger_vertex_in_edges_get(G->vertices, v);
+    while (current_eb != ebpool_priv) {
+      if (current_eb->etype == type) {
+	for (uint64_t i = 0; i < current_eb->high; i++)
+	  current_eb->edges[i].neighbor = -1;
+	current_eb->high = 0;
+	current_eb->numEdges = 0;
+	current_eb->smallStamp = INT64_MAX;
+	current_eb->largeStamp = INT64_MIN;
+      }
+      current_eb = ebpool_priv + current_eb->next;
+    }
+  }
+#endif
+
+#if defined(STINGER_USE_EDGE_INDEX)
+  /* the cleared slots are now holes */
+  edge_index_rebuild_all (G, STINGER_MAX_LVERTICES);
+#endif
+}
+
+/* Clear the edges of eb last touched before threshold and tighten the block
+   meta-data over what is left.  Degrees follow the forward copy only. */
+static int64_t
+expire_eb (struct stinger *G, struct stinger_eb *eb, int64_t threshold, int forward)
+{
+  const int all = eb->largeStamp < threshold;
+  int64_t removed = 0, high = 0, numEdges = 0;
+  int64_t smallStamp = INT64_MAX, largeStamp = INT64_MIN;
+  struct stinger_edge * edges = eb->edges;
+
+  for (int64_t k = 0; k < eb->high; k++) {
+    const int64_t neighbor = edges[k].neighbor;
+    if (neighbor < 0)
+      continue;
+    if (all || edges[k].timeRecent < threshold) {
+      edges[k].neighbor = ~neighbor;
+      if (forward)
+	stinger_indegree_increment_atomic (G, neighbor, -1);
+      removed++;
+    } else {
+      high = k + 1;
+      numEdges++;
+      if (edges[k].timeRecent < smallStamp)
+	smallStamp = edges[k].timeRecent;
+      if (edges[k].timeFirst < smallStamp)
+	smallStamp = edges[k].timeFirst;
+      if (edges[k].timeRecent > largeStamp)
+	largeStamp = edges[k].timeRecent;
+      if (edges[k].timeFirst > largeStamp)
+	largeStamp = edges[k].timeFirst;
+    }
+  }
+
+  if (forward && removed) {
+    stinger_outdegree_increment_atomic (G, eb->vertexID, -removed);
+    STINGER_STATS_EDGES_UPDATE(G, eb->etype, -removed);
+  }
+  eb->high = high;
+  eb->numEdges = numEdges;
+  eb->smallStamp = smallStamp;
+  eb->largeStamp = largeStamp;
+  return removed;
+}
+
+/* Unlink every empty block from the chain starting at loc, returning them to
+   the pool if asked. */
+static void
+unlink_empty_ebs (struct stinger *G, eb_index_t *loc, int free_them)
+{
+  struct stinger_eb * ebpool_priv = G->ebpool->ebpool;
+  while (*loc) {
+    struct stinger_eb * eb = ebpool_priv + *loc;
+    if (eb->numEdges == 0) {
+      eb_index_t dead = *loc;
+      *loc = eb->next;
+      if (free_them)
+	put_to_ebpool (G, &dead, 1);
+    } else
+      loc = &eb->next;
+  }
+}
+
+/** @brief Removes every edge whose recent timestamp is older than threshold.
+ *
+ *  Walks the edge type arrays in parallel, skipping whole blocks whose
+ *  smallest timestamp is not older than threshold, and clears stale edges
+ *  while fixing up vertex degrees.  Blocks left empty are unlinked from
+ *  their vertices and returned to the edge block pool for reuse.
+ *
+ *  Not safe to call concurrently with other updates.
+ *
+ *  @param G The STINGER data structure
+ *  @param threshold Edges with a recent timestamp below this are removed
+ *  @return The number of edges removed
+ */
+int64_t
+stinger_expire_edges_before (struct stinger *G, int64_t threshold)
+{
+  struct stinger_eb * ebpool_priv = G->ebpool->ebpool;
+  int64_t nremoved = 0;
+
+  for (int64_t type = 0; type < STINGER_NUMETYPES; type++) {
+    const eb_index_t * blocks = G->ETA[type].blocks;
+    OMP("omp parallel for reduction(+:nremoved)")
+    MTA("mta assert parallel")
+    for (int64_t p = 0; p < G->ETA[type].high; p++) {
+      struct stinger_eb * eb = ebpool_priv + blocks[p];
+      if (eb->numEdges && eb->smallStamp < threshold)
+	nremoved += expire_eb (G, eb, threshold, 1);
+    }
+  }
+
+#if defined(STINGER_USE_REVERSE_EDGES)
+  OMP("omp parallel for")
+  for (int64_t v = 0; v < STINGER_MAX_LVERTICES; v++) {
+    for (eb_index_t cur = stinger_vertex_in_edges_get (G->vertices, v); cur;
+	 cur = ebpool_priv[cur].next) {
+      if (ebpool_priv[cur].numEdges && ebpool_priv[cur].smallStamp < threshold)
+	expire_eb (G, ebpool_priv + cur, threshold, 0);
+    }
+    unlink_empty_ebs (G, (eb_index_t *)stinger_vertex_in_edges_pointer_get (G->vertices, v), 1);
+  }
+#endif
+
+  OMP("omp parallel for")
+  for (int64_t v = 0; v < STINGER_MAX_LVERTICES; v++)
+    unlink_empty_ebs (G, (eb_index_t *)stinger_vertex_edges_pointer_get (G->vertices, v), 0);
+
+  /* compact the edge type arrays and hand the empty blocks back */
+  for (int64_t type = 0; type < STINGER_NUMETYPES; type++) {
+    eb_index_t * blocks = G->ETA[type].blocks;
+    int64_t high = 0;
+    for (int64_t p = 0; p < G->ETA[type].high; p++) {
+      if (ebpool_priv[blocks[p]].numEdges)
+	blocks[high++] = blocks[p];
+      else
+	put_to_ebpool (G, blocks + p, 1);
+    }
+    G->ETA[type].high = high;
+  }
+
+#if defined(STINGER_USE_EDGE_INDEX)
+  /* chains changed shape, so every slot may have moved */
+  edge_index_rebuild_all (G, STINGER_MAX_LVERTICES);
+#endif
+
+  return nremoved;
 }
 
 const int64_t endian_check = 0x1234ABCD;
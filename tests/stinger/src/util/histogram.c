@@ -1,4 +1,5 @@
 #include "histogram.h"
+#include "stinger-stats.h"
 #include "xmalloc.h"
 
 #include <stdio.h>
@@ -143,3 +144,31 @@ histogram_double(struct stinger * S, double * scores, int64_t count, char * path
     fprintf(stderr,"%s %d ALLOC FAIL \n", __func__, __LINE__); fflush(stdout);
   }
 }
+
+/* Out-degrees in power-of-two buckets: row b counts vertices with out-degree
+   in [2^b, 2^(b+1)).  Free with STINGER_USE_STATS, one pass otherwise. */
+void
+histogram_outdegree(struct stinger * S, int64_t count, char * path, char * name, int64_t iteration) {
+  int64_t histogram[STINGER_STATS_DEGREE_BUCKETS] = {0};
+
+#if defined(STINGER_USE_STATS)
+  stinger_stats_outdegree_histogram(S, histogram);
+#else
+  for(uint64_t v = 0; v < count; v++) {
+    int64_t deg = stinger_outdegree_get(S, v);
+    if(deg > 0) {
+      histogram[63 - __builtin_clzll(deg)]++;
+    }
+  }
+#endif
+
+  char filename[1024];
+  sprintf(filename, "%s/%s.%ld.csv", path, name, iteration);
+  FILE * fp = fopen(filename, "w");
+  for(uint64_t b = 0; b < STINGER_STATS_DEGREE_BUCKETS; b++) {
+    if(histogram[b]) {
+      fprintf(fp, "%ld, %ld\n", (int64_t)1 << b, histogram[b]);
+    }
+  }
+  fclose(fp);
+}
@@ -40,6 +40,36 @@
 //TODO currently this is still in stinger-defs.h
 //#define STINGER_EDGEBLOCK_SIZE 32
 
+/* Maintain a reverse (in-edge) adjacency for every vertex alongside the
+ * normal out-edge blocks.  Reverse blocks come from the same edge block pool
+ * and are updated inside the same insert / remove calls, so every edge costs
+ * a second edge slot and updates do roughly twice the work.  In exchange,
+ * the STINGER_FORALL_IN_EDGES_* macros and predecessor queries run in 
+ * O(in-degree) rather than scanning every edge of the type.
+ */
+// #define STINGER_USE_REVERSE_EDGES
+
+/* Keep a hash index from (neighbor, edge type) to edge slot for every vertex
+ * whose out-degree reaches STINGER_EDGE_INDEX_THRESHOLD.  Insert, increment,
+ * remove, and edge weight / timestamp lookups against those vertices become
+ * expected O(1) instead of a walk of the whole block chain.  Costs one lock
+ * word per vertex plus about 16 bytes per indexed edge, and serializes
+ * updates that share a source vertex.
+ */
+// #define STINGER_USE_EDGE_INDEX
+#if !defined(STINGER_EDGE_INDEX_THRESHOLD)
+#define STINGER_EDGE_INDEX_THRESHOLD 256
+#endif
+
+/* Maintain edge totals per type, the active vertex count, the largest active
+ * vertex, and an out-degree histogram as edges are inserted and removed (see
+ * stinger-stats.h).  stinger_total_edges(), stinger_num_active_vertices(),
+ * and stinger_max_active_vertex() then read counters instead of scanning
+ * every vertex.  Costs a few uncontended atomic adds per edge update and 
+ * one more degree word per vertex.
+ */
+// #define STINGER_USE_STATS
+
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ *
  * PHYSMAP Configuration
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */